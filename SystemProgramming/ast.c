@@ -13,10 +13,36 @@ ASTNode* createASTNode(ASTNodeType type, const char* value, int line_num) {
     node->has_error = 0;
     node->error_message = NULL;
     node->data_type = NULL;
+    node->span.file = SOURCE_NO_FILE;
+    node->span.offset = 0;
+    node->span.length = 0;
+    node->literal.kind = LIT_NONE;
+    node->literal.overflow = 0;
+    node->literal.value = 0;
+    node->symbol = AST_NO_SYMBOL;
 
     return node;
 }
 
+ASTNode* createASTNodeToken(ASTNodeType type, SourceToken tok, int line_num) {
+    ASTNode* node = createASTNode(type, NULL, line_num);
+    node->span = tok.span;
+    if (tok.text) {
+        node->value = (char*)malloc((size_t)tok.span.length + 1);
+        if (node->value) {
+            memcpy(node->value, tok.text, tok.span.length);
+            node->value[tok.span.length] = '\0';
+        }
+    }
+    node->literal = tok.literal;
+    if (tok.literal.overflow) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Literal '%.64s' is out of range", node->value ? node->value : "");
+        ast_set_error(node, msg);
+    }
+    return node;
+}
+
 ASTNode* addChild(ASTNode* parent, ASTNode* child) {
     if (parent == NULL || child == NULL) return parent;
 
@@ -90,23 +116,30 @@ void ast_set_error(ASTNode* node, const char* error_message) {
     node->error_message = error_message ? strdup(error_message) : NULL;
 }
 
-void ast_set_data_type(ASTNode* node, const char* data_type) {
+void ast_set_data_type(ASTNode* node, const Type* data_type) {
     if (!node) return;
-
-    if (node->data_type) {
-        free(node->data_type);
-    }
-    node->data_type = data_type ? strdup(data_type) : NULL;
+    node->data_type = data_type;
 }
 
-/* Статическая переменная для генерации ID узлов */
-static int node_id_counter = 0;
+void ast_set_int_literal(ASTNode* node, int64_t v) {
+    if (!node) return;
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld", (long long)v);
+    free(node->value);
+    node->value = strdup(buf);
+    node->type = AST_LITERAL;
+    node->literal.kind = LIT_INT;
+    node->literal.overflow = 0;
+    node->literal.value = v;
+}
 
-/* Вспомогательная функция для рекурсивной печати AST */
-static void printASTDot_impl(ASTNode* node, FILE* file) {
+/* Вспомогательная функция для рекурсивной печати AST
+   (счётчик ID узлов передаётся явно - без глобального состояния) */
+static void printASTDot_impl(ASTNode* node, FILE* file, int* node_id_counter) {
     if (!node) return;
 
-    int current_id = node_id_counter++;
+    int current_id = (*node_id_counter)++;
     const char* type_name = getNodeTypeName(node->type);
 
     /* Формируем метку узла */
@@ -145,15 +178,15 @@ static void printASTDot_impl(ASTNode* node, FILE* file) {
     /* Добавляем информацию о типе данных, если есть */
     if (node->data_type) {
         fprintf(file, "  node%d [label=\"%s\\nType: %s\", shape=box, style=rounded];\n",
-            current_id, type_name, node->data_type);
+            current_id, type_name, node->data_type->name);
     }
 
     /* Рекурсивно обрабатываем детей */
     int parent_id = current_id;
     for (int i = 0; i < node->child_count; i++) {
-        int child_start_id = node_id_counter;
+        int child_start_id = *node_id_counter;
         fprintf(file, "  node%d -> node%d;\n", parent_id, child_start_id);
-        printASTDot_impl(node->children[i], file);
+        printASTDot_impl(node->children[i], file, node_id_counter);
     }
 }
 
@@ -165,8 +198,8 @@ void printASTDot(ASTNode* node, FILE* file) {
     fprintf(file, "  node [fontname=\"Courier\", fontsize=10];\n");
     fprintf(file, "  edge [fontname=\"Courier\", fontsize=10];\n\n");
 
-    node_id_counter = 0;
-    printASTDot_impl(node, file);
+    int node_id_counter = 0;
+    printASTDot_impl(node, file, &node_id_counter);
 
     fprintf(file, "}\n");
 }
@@ -183,8 +216,18 @@ void freeAST(ASTNode* node) {
     if (node->children) free(node->children);
     if (node->value) free(node->value);
     if (node->error_message) free(node->error_message);
-    if (node->data_type) free(node->data_type);
 
     /* Освобождаем сам узел */
     free(node);
-}
\ No newline at end of file
+}
+
+SourceSpan ast_span(const ASTNode* node) {
+    SourceSpan none = { SOURCE_NO_FILE, 0, 0 };
+    if (!node) return none;
+    if (node->span.file != SOURCE_NO_FILE) return node->span;
+    for (int i = 0; i < node->child_count; i++) {
+        SourceSpan s = ast_span(node->children[i]);
+        if (s.file != SOURCE_NO_FILE) return s;
+    }
+    return none;
+}
@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "source.h"
+#include "types.h"
 
 typedef enum {
     AST_PROGRAM,
@@ -59,18 +61,31 @@ typedef struct ASTNode {
     char* value;
     int has_error;
     char* error_message;
-    char* data_type;
+    const Type* data_type;  /* дескриптор типа (types.h), NULL - не выведен */
+    SourceSpan span;        /* текст лексемы в исходнике (только у узлов из лексем) */
+    LiteralValue literal;   /* значение литерала (разобрано лексером), иначе LIT_NONE */
+    int symbol;             /* идентификатор/вызов: индекс в SymbolTable.symbols,
+                               связывается в semantic_analyze; AST_NO_SYMBOL - нет */
 } ASTNode;
 
+#define AST_NO_SYMBOL (-1)
+
 ASTNode* createASTNode(ASTNodeType type, const char* value, int line_num);
+/* Узел из лексемы: value - копия текста лексемы, span - её место в исходнике,
+   literal - её значение (литерал вне диапазона помечается ошибкой) */
+ASTNode* createASTNodeToken(ASTNodeType type, SourceToken tok, int line_num);
 ASTNode* addChild(ASTNode* parent, ASTNode* child);
 void printASTDot(ASTNode* node, FILE* file);
 void freeAST(ASTNode* node);
 const char* getNodeTypeName(ASTNodeType type);
 
 void ast_set_error(ASTNode* node, const char* error_message);
-void ast_set_data_type(ASTNode* node, const char* data_type);
+void ast_set_data_type(ASTNode* node, const Type* data_type);
+
+/* Сделать узел целым литералом v (value - его десятичная запись) */
+void ast_set_int_literal(ASTNode* node, int64_t v);
 
-extern ASTNode* root_ast;
+/* Место узла в исходнике: его span или первый span в поддереве */
+SourceSpan ast_span(const ASTNode* node);
 
 #endif
\ No newline at end of file
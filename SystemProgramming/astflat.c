@@ -0,0 +1,272 @@
+﻿#include "astflat.h"
+
+/* ========================= * Пул строк * ========================= */
+
+/* Смещение копии s в пуле; 0 - s == NULL или нет памяти */
+static uint32_t flat_intern(FlatAST* fa, const char* s) {
+    if (!s) return 0;
+    size_t len = strlen(s) + 1;
+    if (fa->strings_size + len > fa->strings_capacity) {
+        size_t cap = fa->strings_capacity ? fa->strings_capacity : 256;
+        while (fa->strings_size + len > cap) cap *= 2;
+        char* p = (char*)realloc(fa->strings, cap);
+        if (!p) return 0;
+        fa->strings = p;
+        fa->strings_capacity = cap;
+    }
+    uint32_t off = (uint32_t)fa->strings_size;
+    memcpy(fa->strings + off, s, len);
+    fa->strings_size += len;
+    return off;
+}
+
+static const char* flat_string(const FlatAST* fa, uint32_t off) {
+    return off ? fa->strings + off : NULL;
+}
+
+/* ========================= * Боковые таблицы * ========================= */
+
+/* Первая запись с node >= n */
+static int flat_note_lower(const FlatASTNote* notes, int count, ASTRef n) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (notes[mid].node < n) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static const char* flat_note_get(const FlatAST* fa, const FlatASTNote* notes, int count, ASTRef n) {
+    int i = flat_note_lower(notes, count, n);
+    return (i < count && notes[i].node == n) ? flat_string(fa, notes[i].text) : NULL;
+}
+
+static void flat_note_set(FlatAST* fa, FlatASTNote** notes, int* count, int* capacity,
+    ASTRef n, const char* s) {
+    uint32_t text = flat_intern(fa, s);
+    int i = flat_note_lower(*notes, *count, n);
+    if (i < *count && (*notes)[i].node == n) {
+        (*notes)[i].text = text;
+        return;
+    }
+    if (*count >= *capacity) {
+        int cap = *capacity ? *capacity * 2 : 16;
+        FlatASTNote* p = (FlatASTNote*)realloc(*notes, (size_t)cap * sizeof(FlatASTNote));
+        if (!p) return;
+        *notes = p;
+        *capacity = cap;
+    }
+    memmove(*notes + i + 1, *notes + i, (size_t)(*count - i) * sizeof(FlatASTNote));
+    (*notes)[i].node = n;
+    (*notes)[i].text = text;
+    (*count)++;
+}
+
+static int flat_type_lower(const FlatAST* fa, ASTRef n) {
+    int lo = 0, hi = fa->type_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (fa->types[mid].node < n) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void flat_type_set(FlatAST* fa, ASTRef n, const Type* type) {
+    int i = flat_type_lower(fa, n);
+    if (i < fa->type_count && fa->types[i].node == n) {
+        fa->types[i].type = type;
+        return;
+    }
+    if (fa->type_count >= fa->type_capacity) {
+        int cap = fa->type_capacity ? fa->type_capacity * 2 : 16;
+        FlatASTType* p = (FlatASTType*)realloc(fa->types, (size_t)cap * sizeof(FlatASTType));
+        if (!p) return;
+        fa->types = p;
+        fa->type_capacity = cap;
+    }
+    memmove(fa->types + i + 1, fa->types + i, (size_t)(fa->type_count - i) * sizeof(FlatASTType));
+    fa->types[i].node = n;
+    fa->types[i].type = type;
+    fa->type_count++;
+}
+
+/* ========================= * Построение * ========================= */
+
+static uint32_t flat_count_nodes(const ASTNode* node) {
+    if (!node) return 0;
+    uint32_t n = 1;
+    for (int i = 0; i < node->child_count; i++) n += flat_count_nodes(node->children[i]);
+    return n;
+}
+
+static int flat_alloc_columns(FlatAST* fa, uint32_t capacity) {
+    fa->kind = (uint8_t*)calloc(capacity, sizeof(uint8_t));
+    fa->flags = (uint8_t*)calloc(capacity, sizeof(uint8_t));
+    fa->line = (int32_t*)calloc(capacity, sizeof(int32_t));
+    fa->value = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    fa->first_child = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    fa->child_count = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    fa->span = (SourceSpan*)calloc(capacity, sizeof(SourceSpan));
+    fa->origin = (ASTNode**)calloc(capacity, sizeof(ASTNode*));
+    fa->capacity = capacity;
+    return fa->kind && fa->flags && fa->line && fa->value && fa->first_child &&
+        fa->child_count && fa->span && fa->origin;
+}
+
+/* Следующий номер по порядку обхода в ширину */
+static ASTRef flat_append(FlatAST* fa, ASTNode* node) {
+    ASTRef n = fa->count++;
+    fa->kind[n] = (uint8_t)node->type;
+    fa->flags[n] = (uint8_t)((node->has_explicit_type ? FLAT_EXPLICIT_TYPE : 0) |
+        (node->has_error ? FLAT_HAS_ERROR : 0));
+    fa->line[n] = node->line_number;
+    fa->value[n] = flat_intern(fa, node->value);
+    fa->span[n] = node->span;
+    fa->origin[n] = node;
+
+    /* номера растут, поэтому дописывание сохраняет порядок таблиц */
+    if (node->has_error && node->error_message) {
+        flat_note_set(fa, &fa->errors, &fa->error_count, &fa->error_capacity, n, node->error_message);
+    }
+    if (node->data_type) flat_type_set(fa, n, node->data_type);
+    return n;
+}
+
+FlatAST* flat_ast_build(ASTNode* root) {
+    FlatAST* fa = (FlatAST*)calloc(1, sizeof(FlatAST));
+    if (!fa) return NULL;
+
+    fa->strings_capacity = 256;
+    fa->strings = (char*)malloc(fa->strings_capacity);
+    if (!fa->strings || !flat_alloc_columns(fa, flat_count_nodes(root) + 1)) {
+        flat_ast_free(fa);
+        return NULL;
+    }
+
+    /* номер 0 - "нет узла"; смещение 0 в пуле - "нет строки" */
+    fa->strings[0] = '\0';
+    fa->strings_size = 1;
+    fa->count = 1;
+    fa->span[0].file = SOURCE_NO_FILE;
+    if (!root) return fa;
+
+    flat_append(fa, root);
+
+    /* очередь обхода - сами столбцы: узел i раскладывает детей подряд в конец */
+    for (ASTRef i = 1; i < fa->count; i++) {
+        ASTNode* node = fa->origin[i];
+        fa->first_child[i] = fa->count;
+        for (int k = 0; k < node->child_count; k++) {
+            if (!node->children[k]) continue;
+            flat_append(fa, node->children[k]);
+            fa->child_count[i]++;
+        }
+    }
+    return fa;
+}
+
+void flat_ast_free(FlatAST* fa) {
+    if (!fa) return;
+    free(fa->kind);
+    free(fa->flags);
+    free(fa->line);
+    free(fa->value);
+    free(fa->first_child);
+    free(fa->child_count);
+    free(fa->span);
+    free(fa->origin);
+    free(fa->strings);
+    free(fa->errors);
+    free(fa->types);
+    free(fa);
+}
+
+ASTRef flat_ast_root(const FlatAST* fa) {
+    return (fa && fa->count > 1) ? 1 : AST_NO_REF;
+}
+
+/* ========================= * Доступ к узлу * ========================= */
+
+#define FLAT_VALID(fa, n) ((fa) && (n) != AST_NO_REF && (n) < (fa)->count)
+
+ASTNodeType flat_ast_kind(const FlatAST* fa, ASTRef n) {
+    return FLAT_VALID(fa, n) ? (ASTNodeType)fa->kind[n] : AST_PROGRAM;
+}
+
+int flat_ast_line(const FlatAST* fa, ASTRef n) {
+    return FLAT_VALID(fa, n) ? fa->line[n] : 0;
+}
+
+const char* flat_ast_value(const FlatAST* fa, ASTRef n) {
+    return FLAT_VALID(fa, n) ? flat_string(fa, fa->value[n]) : NULL;
+}
+
+int flat_ast_child_count(const FlatAST* fa, ASTRef n) {
+    return FLAT_VALID(fa, n) ? (int)fa->child_count[n] : 0;
+}
+
+ASTRef flat_ast_child(const FlatAST* fa, ASTRef n, int i) {
+    if (!FLAT_VALID(fa, n) || i < 0 || (uint32_t)i >= fa->child_count[n]) return AST_NO_REF;
+    return fa->first_child[n] + (uint32_t)i;
+}
+
+SourceSpan flat_ast_span(const FlatAST* fa, ASTRef n) {
+    SourceSpan none = { SOURCE_NO_FILE, 0, 0 };
+    if (!FLAT_VALID(fa, n)) return none;
+    if (fa->span[n].file != SOURCE_NO_FILE) return fa->span[n];
+    for (uint32_t i = 0; i < fa->child_count[n]; i++) {
+        SourceSpan s = flat_ast_span(fa, fa->first_child[n] + i);
+        if (s.file != SOURCE_NO_FILE) return s;
+    }
+    return none;
+}
+
+/* ========================= * Аннотации * ========================= */
+
+const char* flat_ast_error(const FlatAST* fa, ASTRef n) {
+    if (!FLAT_VALID(fa, n) || !(fa->flags[n] & FLAT_HAS_ERROR)) return NULL;
+    return flat_note_get(fa, fa->errors, fa->error_count, n);
+}
+
+const Type* flat_ast_data_type(const FlatAST* fa, ASTRef n) {
+    if (!FLAT_VALID(fa, n)) return NULL;
+    int i = flat_type_lower(fa, n);
+    return (i < fa->type_count && fa->types[i].node == n) ? fa->types[i].type : NULL;
+}
+
+void flat_ast_set_error(FlatAST* fa, ASTRef n, const char* message) {
+    if (!FLAT_VALID(fa, n)) return;
+    fa->flags[n] |= FLAT_HAS_ERROR;
+    flat_note_set(fa, &fa->errors, &fa->error_count, &fa->error_capacity, n, message);
+}
+
+void flat_ast_set_data_type(FlatAST* fa, ASTRef n, const Type* data_type) {
+    if (!FLAT_VALID(fa, n)) return;
+    flat_type_set(fa, n, data_type);
+}
+
+/* ========================= * Адаптер к ASTNode * ========================= */
+
+ASTNode* flat_ast_origin(const FlatAST* fa, ASTRef n) {
+    return FLAT_VALID(fa, n) ? fa->origin[n] : NULL;
+}
+
+void flat_ast_writeback(const FlatAST* fa) {
+    if (!fa) return;
+
+    for (int i = 0; i < fa->error_count; i++) {
+        ASTNode* node = fa->origin[fa->errors[i].node];
+        const char* message = flat_string(fa, fa->errors[i].text);
+        if (!node) continue;
+        if (node->has_error && node->error_message && message &&
+            strcmp(node->error_message, message) == 0) continue;
+        ast_set_error(node, message);
+    }
+
+    for (int i = 0; i < fa->type_count; i++) {
+        ASTNode* node = fa->origin[fa->types[i].node];
+        if (node) ast_set_data_type(node, fa->types[i].type);
+    }
+}
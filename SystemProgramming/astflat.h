@@ -0,0 +1,121 @@
+﻿#pragma once
+#ifndef ASTFLAT_H
+#define ASTFLAT_H
+
+#include <stdint.h>
+#include "ast.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Компактное представление AST (struct-of-arrays).
+     *
+     * Узел - 32-битный номер (ASTRef), 0 - "нет узла". Поля узла лежат в
+     * отдельных столбцах одинаковой длины: kind, flags, line, span, value,
+     * first_child / child_count. Узлы нумеруются в ширину, поэтому дети
+     * одного узла - непрерывный диапазон номеров
+     *     [first_child[n], first_child[n] + child_count[n]),
+     * отдельного массива детей нет. Все строки (value, сообщения об ошибках)
+     * лежат в одном пуле, в столбце хранится смещение (0 - нет строки);
+     * возвращённая строка действительна до следующей записи ошибки.
+     *
+     * Ошибки и типы данных есть у немногих узлов, поэтому это не столбцы,
+     * а боковые таблицы (узел, сообщение) и (узел, дескриптор типа),
+     * упорядоченные по номеру узла.
+     *
+     * Переход проходов постепенный: flat_ast_build строит FlatAST по
+     * дереву ASTNode и помнит исходный узел каждого номера
+     * (flat_ast_origin), flat_ast_writeback возвращает аннотации,
+     * поставленные через FlatAST, в исходное дерево. Так проход на
+     * номерах и проход на указателях могут работать друг за другом.
+     */
+
+    typedef uint32_t ASTRef;
+
+#define AST_NO_REF 0u
+
+    /* flags */
+#define FLAT_EXPLICIT_TYPE 0x01     /* has_explicit_type */
+#define FLAT_HAS_ERROR     0x02     /* есть запись в errors */
+
+    /* Запись боковой таблицы: аннотация-строка узла */
+    typedef struct {
+        ASTRef node;
+        uint32_t text;              /* смещение в strings */
+    } FlatASTNote;
+
+    /* Запись боковой таблицы типов */
+    typedef struct {
+        ASTRef node;
+        const Type* type;
+    } FlatASTType;
+
+    typedef struct FlatAST {
+        uint32_t count;             /* номеров занято, включая 0 */
+        uint32_t capacity;
+
+        /* столбцы, индекс - ASTRef */
+        uint8_t* kind;              /* ASTNodeType */
+        uint8_t* flags;
+        int32_t* line;
+        uint32_t* value;            /* смещение в strings, 0 - NULL */
+        uint32_t* first_child;
+        uint32_t* child_count;
+        SourceSpan* span;
+        ASTNode** origin;           /* адаптер: исходный узел или NULL */
+
+        /* пул строк (value, сообщения), смещение 0 - "нет строки" */
+        char* strings;
+        size_t strings_size;
+        size_t strings_capacity;
+
+        /* боковые таблицы, по возрастанию node */
+        FlatASTNote* errors;
+        int error_count;
+        int error_capacity;
+        FlatASTType* types;
+        int type_count;
+        int type_capacity;
+    } FlatAST;
+
+    /* ========================= * Построение * ========================= */
+
+    /* Снимок дерева root; NULL - нет памяти. Корень получает номер 1 */
+    FlatAST* flat_ast_build(ASTNode* root);
+    void flat_ast_free(FlatAST* fa);
+
+    ASTRef flat_ast_root(const FlatAST* fa);
+
+    /* ========================= * Доступ к узлу * ========================= */
+
+    ASTNodeType flat_ast_kind(const FlatAST* fa, ASTRef n);
+    int flat_ast_line(const FlatAST* fa, ASTRef n);
+    const char* flat_ast_value(const FlatAST* fa, ASTRef n);      /* NULL - нет */
+    int flat_ast_child_count(const FlatAST* fa, ASTRef n);
+    ASTRef flat_ast_child(const FlatAST* fa, ASTRef n, int i);    /* AST_NO_REF - нет */
+
+    /* Место в исходнике: span узла или первый span в поддереве (как ast_span) */
+    SourceSpan flat_ast_span(const FlatAST* fa, ASTRef n);
+
+    /* ========================= * Аннотации * ========================= */
+
+    const char* flat_ast_error(const FlatAST* fa, ASTRef n);      /* NULL - нет */
+    const Type* flat_ast_data_type(const FlatAST* fa, ASTRef n);  /* NULL - нет */
+    void flat_ast_set_error(FlatAST* fa, ASTRef n, const char* message);
+    void flat_ast_set_data_type(FlatAST* fa, ASTRef n, const Type* data_type);
+
+    /* ========================= * Адаптер к ASTNode * ========================= */
+
+    /* Исходный узел номера n (NULL - узел создан не из дерева) */
+    ASTNode* flat_ast_origin(const FlatAST* fa, ASTRef n);
+
+    /* Перенести ошибки и типы из боковых таблиц в исходные узлы */
+    void flat_ast_writeback(const FlatAST* fa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -101,6 +101,7 @@ void callgraph_export_dot(CallGraph* cg, const char* filename) {
 
     fprintf(f, "}\n");
     fclose(f);
+    free(functions);
 }
 
 void callgraph_print_summary(CallGraph* cg) {
@@ -1,4 +1,5 @@
 #include "calltree.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -86,7 +87,7 @@ static void extract_calls_from_expression(ASTNode* expr, const char* current_fun
     
     if (expr->type == AST_CALL_EXPR) {
         if (expr->value) {
-            printf("    [CALL] %s -> %s\n", current_func, expr->value);
+            TRACE(TRACE_CFG, TRACE_DEBUG, "    [CALL] %s -> %s\n", current_func, expr->value);
             calltree_add_call(ct, current_func, expr->value);
         }
         
@@ -181,7 +182,7 @@ void calltree_build_from_ast(CallTree* ct, ASTNode* ast) {
             }
         }
 
-        printf("[*] Analyzing calls in %s...\n", func_name);
+        TRACE(TRACE_CFG, TRACE_DEBUG, "[*] Analyzing calls in %s...\n", func_name);
 
         
         if (func_def->child_count > 1) {
@@ -2,6 +2,7 @@
 #ifndef CFG_H
 #define CFG_H
 
+#include <stdint.h>
 #include "ast.h"
 #include "semantic.h"
 
@@ -18,16 +19,17 @@ typedef enum {
 } CFGNodeType;
 
 typedef struct CFGNode {
-    int id;
+    int id;                     // = индекс в cfg->nodes
     CFGNodeType type;
-    char* label;
+    const char* label;          // литерал служебного узла, кэш или NULL (cfg_node_label)
     ASTNode* ast_node;
     ASTNode* op_tree;
     struct CFGNode* defaultNext;
     struct CFGNode* conditionalNext;
 
-    ASTNode** expr_trees;
-    int expr_tree_count;
+    ASTNode** expr_trees;       // операторы блока по порядку (у CFG_CONDITION
+    int expr_tree_count;        // последнее - условие); срез cfg->expr_trees
+    int expr_tree_first;        // начало среза (указатель пересчитывается при росте)
 
     char* function_name;        // Название функции, к которой относится узел
     int is_function_entry;      // 1 если это точка входа в функцию
@@ -43,17 +45,90 @@ typedef struct {
     CFGNode* exit;
 } CFGSegment;
 
+/* Функция в CFG: её узлы - непрерывный диапазон nodes[first_node .. end_node),
+   вход - первый из них, выход - последний.
+   Обходы от входа считает cfg_finalize (поиск в глубину, преемники в порядке
+   CSR), они действительны, пока действителен CSR. Локальный номер узла -
+   id - first_node. */
+typedef struct {
+    char* name;                 // в пуле строк CFG
+    int scope_id;               // область функции (1 - не найдена)
+    int symbol;                 // индекс SYM_FUNCTION в symbol_table или -1
+    CFGNode* entry;
+    CFGNode* exit;
+    int first_node;
+    int end_node;
+
+    uint32_t* reachable;        // битовое множество по локальным номерам
+    int reachable_count;
+    int* preorder;              // id достижимых узлов в порядке входа DFS
+    int* rpo;                   // id достижимых узлов в обратном постпорядке
+    int* postorder_number;      // локальный номер -> номер в постпорядке или -1
+} CFGFunction;
+
+
+
+/*
+ * Хранение CFG.
+ *
+ * Узел - базовый блок: после построения функции цепочки узлов с одним
+ * входом и одним выходом сливаются в один узел со списком операторов
+ * (expr_trees), а пустые узлы (VAR_DECL, break, end-if, exit-while, ...)
+ * удаляются - рёбра ведут сразу к следующему непустому узлу.
+ *
+ * Узлы выделяются блоками по CFG_NODE_CHUNK и не перемещаются, id узла -
+ * его индекс в nodes. Списки деревьев выражений всех узлов лежат в
+ * одном массиве expr_trees, имена функций и запомненные метки - в пуле
+ * строк CFG. Всё это освобождается вместе с CFG. Метки при построении
+ * не создаются: их строит cfg_node_label, когда они нужны выводу.
+ *
+ * Рёбра хранятся указателями в узлах (defaultNext/conditionalNext), а для
+ * обходов cfg_finalize раскладывает их в CSR: преемники узла i -
+ * succ[succ_start[i] .. succ_start[i + 1]) (сначала defaultNext),
+ * предшественники - pred[pred_start[i] .. pred_start[i + 1]) по
+ * возрастанию id. После построения рёбра меняются только через
+ * cfg_set_edges, до следующего cfg_finalize CSR недействителен.
+ */
+#define CFG_NODE_CHUNK 64
+
 typedef struct {
     CFGNode** nodes;
     int node_count;
-    CFGNode* entry;
+    int node_capacity;
+    CFGNode* entry;             // вход и выход последней построенной функции
     CFGNode* exit;
     int next_id;
 
+    /* функции в порядке построения */
+    CFGFunction* functions;
+    int function_count;
+    int function_capacity;
+
+    struct CFGChunk* node_chunks;     /* блоки узлов (cfg_builder.c) */
+    struct CFGChunk* string_chunks;   /* пул меток */
+
+    ASTNode** expr_trees;
+    int expr_tree_count;
+    int expr_tree_capacity;
+
+    /* CSR (cfg_finalize) */
+    int edges_valid;
+    int* succ_start;            /* node_count + 1 */
+    int* succ;
+    int* pred_start;            /* node_count + 1 */
+    int* pred;
+
     SymbolTable* symbol_table;
+
+    /* состояние построения (у каждого CFG своё - построение реентерабельно) */
+    CFGNode* current_loop_exit;     /* куда ведёт break */
+    int current_scope_id;
+    int current_function_scope_id;
 } CFG;
 
 CFG* cfg_create(void);
+/* label - готовая метка, живущая не меньше CFG (литерал), или NULL:
+   тогда метка строится по AST узла при выводе */
 CFGNode* cfg_create_node(CFG* cfg, CFGNodeType type, const char* label,
     ASTNode* ast_node, ASTNode* op_tree);
 CFGNode* cfg_create_error_node(CFG* cfg, const char* label, const char* error_message);
@@ -61,16 +136,37 @@ CFGNode* cfg_create_error_node(CFG* cfg, const char* label, const char* error_me
 void cfg_add_default_edge(CFGNode* from, CFGNode* to);
 void cfg_add_conditional_edge(CFGNode* from, CFGNode* to);
 
+/* Заменить оба ребра узла после построения (CSR до cfg_finalize недействителен) */
+void cfg_set_edges(CFG* cfg, CFGNode* node, CFGNode* default_next, CFGNode* conditional_next);
+
+/* Разложить рёбра в CSR и пересчитать обходы функций; повторный вызов
+   без изменений рёбер ничего не делает */
+void cfg_finalize(CFG* cfg);
+
+/* Узел id достижим из входа функции fn (по обходу cfg_finalize) */
+int cfg_function_reaches(const CFGFunction* fn, int id);
+
 void cfg_build_from_ast(CFG* cfg, ASTNode* ast);
+void cfg_build_function(CFG* cfg, ASTNode* func_def);
 void cfg_export_dot(CFG* cfg, const char* filename);
 
-void cfg_set_symbol_table(SymbolTable* table);
-void check_expression_semantics_with_scope(ASTNode* expr, SymbolTable* symbol_table,
-    CFGNode* cfg_node, int function_scope_id);
-void cfg_check_semantics(CFG* cfg, SymbolTable* symbol_table);
+void cfg_set_symbol_table(CFG* cfg, SymbolTable* table);
 
 void cfg_free(CFG* cfg);
 
+/* Выражения, которые узел вычисляет при генерации кода, по порядку;
+   у CFG_CONDITION последнее - условие перехода. NULL и *count = 0 - нет */
+ASTNode** cfg_node_exprs(const CFGNode* n, int* count);
+
+/* Метка узла для DOT и комментариев asm. Строится по текущим деревьям
+   узла в buf (операторы блока - по строке), без выделения памяти;
+   готовая метка узла возвращается как есть. NULL - метки нет */
+const char* cfg_node_label(const CFG* cfg, const CFGNode* n, char* buf, size_t size);
+
+/* То же с запоминанием в пуле строк CFG (для многократного вывода).
+   Запомненная метка не следит за последующими изменениями деревьев */
+const char* cfg_node_label_cached(CFG* cfg, CFGNode* n);
+
 void escape_string_for_dot(const char* input, char* output, size_t max_len);
 const char* get_operation_name(ASTNodeType type, const char* value);
 
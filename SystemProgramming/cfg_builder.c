@@ -1,60 +1,57 @@
 ﻿#include "cfg.h"
 #include "ast.h"
+#include "trace.h"
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-/* Статические переменные для внутреннего состояния */
-static CFGNode* current_loop_exit = NULL;
-static SymbolTable* current_symbol_table = NULL;
-static int ast_tree_counter = 0;
-static int current_scope_id = 1;
-static int current_function_scope_id = 1;
-
 /* Вспомогательные функции */
 static const char* get_operation_name_internal(ASTNodeType type, const char* value);
 static void export_ast_tree_to_dot(ASTNode* node, FILE* f, int tree_id, int* node_counter);
-static void ast_to_string(ASTNode* node, char* buf, int max_len);
 static int segment_ends_with_break(CFGNode* exit_node);
 static CFGSegment build_cfg_for_statements(CFG* cfg, ASTNode* stmt_list, int function_scope_id);
 static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt_list, int function_scope_id);
-static void mark_error_recursive(ASTNode* node, const char* error_msg);
+static int take_expression_error(CFGNode* cfg_node, const ASTNode* expr);
 
-void cfg_set_symbol_table(SymbolTable* table) {
-    current_symbol_table = table;
-    current_function_scope_id = 1;
+void cfg_set_symbol_table(CFG* cfg, SymbolTable* table) {
+    if (!cfg) return;
+    cfg->symbol_table = table;
+    cfg->current_function_scope_id = 1;
 }
 
-void cfg_set_current_scope_id(int scope_id) {
-    current_scope_id = scope_id;
+void cfg_set_current_scope_id(CFG* cfg, int scope_id) {
+    if (!cfg) return;
+    cfg->current_scope_id = scope_id;
 }
 
-static void set_current_function_scope(const char* func_name) {
-    if (!current_symbol_table || !func_name) {
-        current_function_scope_id = 1; // Глобальная область по умолчанию
+static void set_current_function_scope(CFG* cfg, const char* func_name) {
+    if (!cfg->symbol_table || !func_name) {
+        cfg->current_function_scope_id = 1; // Глобальная область по умолчанию
         return;
     }
 
     // Ищем функцию в таблице символов
-    for (int i = 0; i < current_symbol_table->symbol_count; i++) {
-        Symbol* sym = &current_symbol_table->symbols[i];
+    for (int i = 0; i < cfg->symbol_table->symbol_count; i++) {
+        Symbol* sym = &cfg->symbol_table->symbols[i];
         if (sym->type == SYM_FUNCTION &&
             sym->name && strcmp(sym->name, func_name) == 0) {
             // Ищем область видимости этой функции
-            for (int j = 0; j < current_symbol_table->scope_count; j++) {
-                Scope* scope = current_symbol_table->scopes[j];
+            for (int j = 0; j < cfg->symbol_table->scope_count; j++) {
+                Scope* scope = cfg->symbol_table->scopes[j];
                 if (scope->type == SCOPE_FUNCTION &&
                     scope->name && strcmp(scope->name, func_name) == 0) {
-                    current_function_scope_id = scope->id;
-                    printf("    [DEBUG] Function %s found in scope %d\n", func_name, current_function_scope_id);
+                    cfg->current_function_scope_id = scope->id;
+                    TRACE(TRACE_CFG, TRACE_DEBUG, "    [DEBUG] Function %s found in scope %d\n",
+                        func_name, cfg->current_function_scope_id);
                     return;
                 }
             }
         }
     }
 
-    current_function_scope_id = 1; // Не нашли - используем глобальную
-    printf("    [WARNING] Function %s not found in symbol table\n", func_name);
+    cfg->current_function_scope_id = 1; // Не нашли - используем глобальную
+    TRACE(TRACE_CFG, TRACE_WARN, "    [WARNING] Function %s not found in symbol table\n", func_name);
 }
 
 static void export_ast_tree_to_dot_nested(ASTNode* node, FILE* f, int tree_id,
@@ -160,33 +157,106 @@ static void export_ast_tree_to_dot_nested(ASTNode* node, FILE* f, int tree_id,
     }
 }
 
+/* =========================
+ * Хранение: блоки узлов, пул меток, общий массив деревьев
+ * ========================= */
+
+typedef struct CFGChunk {
+    struct CFGChunk* next;
+    size_t used;
+    size_t capacity;
+    union {
+        CFGNode nodes[1];
+        char chars[1];
+    } data;
+} CFGChunk;
+
+static CFGChunk* cfg_chunk_new(CFGChunk* next, size_t capacity, size_t item_size) {
+    CFGChunk* c = (CFGChunk*)malloc(offsetof(CFGChunk, data) + capacity * item_size);
+    if (!c) return NULL;
+    c->next = next;
+    c->used = 0;
+    c->capacity = capacity;
+    return c;
+}
+
+static void cfg_chunks_free(CFGChunk* c) {
+    while (c) {
+        CFGChunk* next = c->next;
+        free(c);
+        c = next;
+    }
+}
+
+/* Копия строки в пуле меток; живёт до cfg_free */
+static char* cfg_strdup(CFG* cfg, const char* s) {
+    if (!s) return NULL;
+    size_t len = strlen(s) + 1;
+    CFGChunk* c = cfg->string_chunks;
+    if (!c || c->capacity - c->used < len) {
+        size_t cap = (len > 4096) ? len : 4096;
+        c = cfg_chunk_new(cfg->string_chunks, cap, 1);
+        if (!c) return NULL;
+        cfg->string_chunks = c;
+    }
+    char* p = c->data.chars + c->used;
+    memcpy(p, s, len);
+    c->used += len;
+    return p;
+}
+
+/* Место под count деревьев в конце expr_trees; срезы узлов пересчитываются */
+static int cfg_reserve_expr_trees(CFG* cfg, int count) {
+    if (cfg->expr_tree_count + count <= cfg->expr_tree_capacity) return 1;
+
+    int cap = cfg->expr_tree_capacity ? cfg->expr_tree_capacity * 2 : 64;
+    while (cap < cfg->expr_tree_count + count) cap *= 2;
+    ASTNode** p = (ASTNode**)realloc(cfg->expr_trees, (size_t)cap * sizeof(ASTNode*));
+    if (!p) return 0;
+    cfg->expr_trees = p;
+    cfg->expr_tree_capacity = cap;
+
+    for (int i = 0; i < cfg->node_count; i++) {
+        CFGNode* n = cfg->nodes[i];
+        if (n->expr_tree_count > 0) n->expr_trees = cfg->expr_trees + n->expr_tree_first;
+    }
+    return 1;
+}
+
 CFG* cfg_create(void) {
-    CFG* cfg = (CFG*)malloc(sizeof(CFG));
-    cfg->nodes = NULL;
-    cfg->node_count = 0;
-    cfg->entry = NULL;
-    cfg->exit = NULL;
-    cfg->next_id = 0;
-    cfg->symbol_table = NULL;
+    CFG* cfg = (CFG*)calloc(1, sizeof(CFG));
+    if (!cfg) return NULL;
+    cfg->current_scope_id = 1;
+    cfg->current_function_scope_id = 1;
     return cfg;
 }
 
-void cfg_add_expr_tree(CFGNode* node, ASTNode* tree) {
-    if (!node || !tree) return;
+void cfg_add_expr_tree(CFG* cfg, CFGNode* node, ASTNode* tree) {
+    if (!cfg || !node || !tree) return;
 
-    // Переаллокируем массив с увеличенным размером
-    ASTNode** new_trees = (ASTNode**)realloc(node->expr_trees,
-        (node->expr_tree_count + 1) * sizeof(ASTNode*));
-    if (!new_trees) {
+    /* срез узла не в конце массива - переносим его в конец */
+    int at_end = node->expr_tree_count == 0 ||
+        node->expr_tree_first + node->expr_tree_count == cfg->expr_tree_count;
+    int need = at_end ? 1 : node->expr_tree_count + 1;
+    if (!cfg_reserve_expr_trees(cfg, need)) {
         fprintf(stderr, "Error: Memory reallocation failed in cfg_add_expr_tree\n");
         return;
     }
 
-    node->expr_trees = new_trees;
-    node->expr_trees[node->expr_tree_count] = tree;
+    if (node->expr_tree_count == 0) {
+        node->expr_tree_first = cfg->expr_tree_count;
+    }
+    else if (!at_end) {
+        memcpy(cfg->expr_trees + cfg->expr_tree_count, cfg->expr_trees + node->expr_tree_first,
+            (size_t)node->expr_tree_count * sizeof(ASTNode*));
+        node->expr_tree_first = cfg->expr_tree_count;
+        cfg->expr_tree_count += node->expr_tree_count;
+    }
+    cfg->expr_trees[cfg->expr_tree_count++] = tree;
+    node->expr_trees = cfg->expr_trees + node->expr_tree_first;
     node->expr_tree_count++;
 
-    printf("  [+] Added expression tree %d to CFG node %d\n",
+    TRACE(TRACE_CFG, TRACE_DEBUG, "  [+] Added expression tree %d to CFG node %d\n",
         node->expr_tree_count - 1, node->id);
 }
 
@@ -194,46 +264,40 @@ CFGNode* cfg_create_node(CFG* cfg, CFGNodeType type, const char* label,
     ASTNode* ast_node, ASTNode* op_tree) {
     if (!cfg) return NULL;
 
-    CFGNode* node = (CFGNode*)malloc(sizeof(CFGNode));
-    if (!node) return NULL;
+    if (cfg->node_count >= cfg->node_capacity) {
+        int cap = cfg->node_capacity ? cfg->node_capacity * 2 : CFG_NODE_CHUNK;
+        CFGNode** nodes = (CFGNode**)realloc(cfg->nodes, (size_t)cap * sizeof(CFGNode*));
+        if (!nodes) return NULL;
+        cfg->nodes = nodes;
+        cfg->node_capacity = cap;
+    }
+    CFGChunk* c = cfg->node_chunks;
+    if (!c || c->used == c->capacity) {
+        c = cfg_chunk_new(cfg->node_chunks, CFG_NODE_CHUNK, sizeof(CFGNode));
+        if (!c) return NULL;
+        cfg->node_chunks = c;
+    }
 
+    CFGNode* node = &c->data.nodes[c->used++];
+    memset(node, 0, sizeof(*node));
     node->id = cfg->next_id++;
     node->type = type;
-    node->label = label ? (char*)malloc(strlen(label) + 1) : NULL;
-    if (label) strcpy(node->label, label);
+    node->label = label;
 
     node->ast_node = ast_node;
+    node->op_tree = op_tree;
 
-    // Инициализация массива деревьев выражений
-    node->expr_trees = NULL;
-    node->expr_tree_count = 0;
+    cfg->nodes[cfg->node_count++] = node;
+    cfg->edges_valid = 0;
 
     // Если передано одно дерево, добавляем его
-    if (op_tree) {
-        node->expr_trees = (ASTNode**)malloc(sizeof(ASTNode*));
-        if (node->expr_trees) {
-            node->expr_trees[0] = op_tree;
-            node->expr_tree_count = 1;
-        }
-    }
-
-    node->defaultNext = NULL;
-    node->conditionalNext = NULL;
-    node->function_name = NULL;
-    node->is_function_entry = 0;
-    node->is_function_exit = 0;
-    node->has_error = 0;
-    node->error_message = NULL;
-    node->is_break = 0;
-
-    cfg->nodes = (CFGNode**)realloc(cfg->nodes, (cfg->node_count + 1) * sizeof(CFGNode*));
-    if (!cfg->nodes) {
-        free(node);
-        return NULL;
+    if (op_tree && cfg_reserve_expr_trees(cfg, 1)) {
+        node->expr_tree_first = cfg->expr_tree_count;
+        cfg->expr_trees[cfg->expr_tree_count++] = op_tree;
+        node->expr_trees = cfg->expr_trees + node->expr_tree_first;
+        node->expr_tree_count = 1;
     }
 
-    cfg->nodes[cfg->node_count++] = node;
-
     return node;
 }
 
@@ -262,6 +326,134 @@ void cfg_add_conditional_edge(CFGNode* from, CFGNode* to) {
     }
 }
 
+void cfg_set_edges(CFG* cfg, CFGNode* node, CFGNode* default_next, CFGNode* conditional_next) {
+    if (!cfg || !node) return;
+    node->defaultNext = default_next;
+    node->conditionalNext = conditional_next;
+    cfg->edges_valid = 0;
+}
+
+static void cfg_function_orders_free(CFGFunction* fn) {
+    free(fn->reachable);
+    free(fn->preorder);
+    free(fn->rpo);
+    free(fn->postorder_number);
+    fn->reachable = NULL;
+    fn->preorder = NULL;
+    fn->rpo = NULL;
+    fn->postorder_number = NULL;
+    fn->reachable_count = 0;
+}
+
+/* Итеративный DFS от входа по CSR: достижимость, прямой порядок, постпорядок */
+static void cfg_function_orders(const CFG* cfg, CFGFunction* fn) {
+    cfg_function_orders_free(fn);
+
+    int first = fn->first_node;
+    int n = fn->end_node - first;
+    if (n <= 0 || !fn->entry) return;
+
+    fn->reachable = (uint32_t*)calloc((size_t)(n + 31) / 32, sizeof(uint32_t));
+    fn->preorder = (int*)malloc((size_t)n * sizeof(int));
+    fn->rpo = (int*)malloc((size_t)n * sizeof(int));
+    fn->postorder_number = (int*)malloc((size_t)n * sizeof(int));
+    int* post = (int*)malloc((size_t)n * sizeof(int));
+    int* stack = (int*)malloc((size_t)n * sizeof(int));
+    int* next_edge = (int*)malloc((size_t)n * sizeof(int));
+    if (!fn->reachable || !fn->preorder || !fn->rpo || !fn->postorder_number ||
+        !post || !stack || !next_edge) {
+        cfg_function_orders_free(fn);
+        free(post);
+        free(stack);
+        free(next_edge);
+        return;
+    }
+    for (int i = 0; i < n; i++) fn->postorder_number[i] = -1;
+
+    int count = 0, posts = 0, sp = 0;
+    int start = fn->entry->id - first;
+    fn->reachable[start >> 5] |= 1u << (start & 31);
+    fn->preorder[count++] = first + start;
+    stack[sp] = start;
+    next_edge[sp++] = cfg->succ_start[first + start];
+
+    while (sp > 0) {
+        int i = stack[sp - 1];
+        if (next_edge[sp - 1] < cfg->succ_start[first + i + 1]) {
+            int t = cfg->succ[next_edge[sp - 1]++] - first;
+            if (t < 0 || t >= n || (fn->reachable[t >> 5] >> (t & 31)) & 1u) continue;
+            fn->reachable[t >> 5] |= 1u << (t & 31);
+            fn->preorder[count++] = first + t;
+            stack[sp] = t;
+            next_edge[sp++] = cfg->succ_start[first + t];
+        }
+        else {
+            sp--;
+            fn->postorder_number[i] = posts;
+            post[posts++] = first + i;
+        }
+    }
+
+    for (int k = 0; k < posts; k++) fn->rpo[k] = post[posts - 1 - k];
+    fn->reachable_count = count;
+
+    free(post);
+    free(stack);
+    free(next_edge);
+}
+
+int cfg_function_reaches(const CFGFunction* fn, int id) {
+    int i = id - fn->first_node;
+    if (i < 0 || id >= fn->end_node || !fn->reachable) return 0;
+    return (int)((fn->reachable[i >> 5] >> (i & 31)) & 1u);
+}
+
+void cfg_finalize(CFG* cfg) {
+    if (!cfg || cfg->edges_valid) return;
+
+    int n = cfg->node_count;
+    free(cfg->succ_start);
+    free(cfg->succ);
+    free(cfg->pred_start);
+    free(cfg->pred);
+    cfg->succ_start = (int*)calloc((size_t)n + 1, sizeof(int));
+    cfg->pred_start = (int*)calloc((size_t)n + 1, sizeof(int));
+    cfg->succ = (int*)malloc((size_t)(2 * n + 1) * sizeof(int));
+    cfg->pred = (int*)malloc((size_t)(2 * n + 1) * sizeof(int));
+    if (!cfg->succ_start || !cfg->pred_start || !cfg->succ || !cfg->pred) return;
+
+    /* преемники - подряд по узлам; заодно считаем входящие */
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        const CFGNode* node = cfg->nodes[i];
+        cfg->succ_start[i] = m;
+        if (node->defaultNext) {
+            cfg->succ[m++] = node->defaultNext->id;
+            cfg->pred_start[node->defaultNext->id + 1]++;
+        }
+        if (node->conditionalNext) {
+            cfg->succ[m++] = node->conditionalNext->id;
+            cfg->pred_start[node->conditionalNext->id + 1]++;
+        }
+    }
+    cfg->succ_start[n] = m;
+
+    for (int i = 0; i < n; i++) cfg->pred_start[i + 1] += cfg->pred_start[i];
+    int* fill = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    if (!fill) return;
+    memcpy(fill, cfg->pred_start, (size_t)n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        for (int e = cfg->succ_start[i]; e < cfg->succ_start[i + 1]; e++) {
+            cfg->pred[fill[cfg->succ[e]]++] = i;
+        }
+    }
+    free(fill);
+
+    for (int f = 0; f < cfg->function_count; f++) cfg_function_orders(cfg, &cfg->functions[f]);
+
+    cfg->edges_valid = 1;
+}
+
 static int get_operator_precedence(const char* op) {
     if (!op) return 0;
 
@@ -285,124 +477,169 @@ static int get_operator_precedence(const char* op) {
 }
 
 
-static void ast_to_string(ASTNode* node, char* buf, int max_len) {
-    if (!node || !buf) {
-        buf[0] = '\0';
-        return;
-    }
+/* =========================
+ * Метки узлов (по запросу, из AST)
+ * ========================= */
 
-    // Базовые типы
-    if (node->type == AST_IDENTIFIER) {
-        if (node->value && node->value[0] != '\0') {
-            snprintf(buf, max_len, "%s", node->value);
-        }
-        else {
-            snprintf(buf, max_len, "?");
-        }
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t len;
+} LabelWriter;
+
+static void label_put(LabelWriter* w, const char* s) {
+    while (*s && w->len + 1 < w->size) w->buf[w->len++] = *s++;
+    w->buf[w->len] = '\0';
+}
+
+static const char* label_value(const ASTNode* node, const char* fallback) {
+    return (node->value && node->value[0] != '\0') ? node->value : fallback;
+}
+
+static void label_expr(LabelWriter* w, const ASTNode* node) {
+    if (!node) return;
+
+    switch (node->type) {
+    case AST_IDENTIFIER:
+        label_put(w, label_value(node, "?"));
         return;
-    }
 
-    if (node->type == AST_LITERAL) {
-        if (node->value && node->value[0] != '\0') {
-            snprintf(buf, max_len, "%s", node->value);
-        }
-        else {
-            snprintf(buf, max_len, "const");
-        }
+    case AST_LITERAL:
+        label_put(w, label_value(node, "const"));
         return;
-    }
 
-    // Унарные операции
-    if (node->type == AST_UNARY_EXPR) {
+    case AST_UNARY_EXPR:
         if (node->child_count >= 1) {
-            char operand[512] = "";
-            ast_to_string(node->children[0], operand, sizeof(operand));
-            snprintf(buf, max_len, "%s%s", node->value ? node->value : "", operand);
+            label_put(w, node->value ? node->value : "");
+            label_expr(w, node->children[0]);
         }
         else {
-            snprintf(buf, max_len, "%s", node->value ? node->value : "UnOp");
+            label_put(w, node->value ? node->value : "UnOp");
         }
         return;
-    }
 
-    if (node->type == AST_ASSIGNMENT) {
-        char left[512] = "", right[512] = "";
+    case AST_ASSIGNMENT:
         if (node->child_count >= 2) {
-            ast_to_string(node->children[0], left, sizeof(left));
-            ast_to_string(node->children[1], right, sizeof(right));
-            snprintf(buf, max_len, "%s := %s", left, right);
+            label_expr(w, node->children[0]);
+            label_put(w, " := ");
+            label_expr(w, node->children[1]);
         }
         else {
-            snprintf(buf, max_len, ":=");
+            label_put(w, ":=");
         }
         return;
-    }
 
-    // Бинарные операции
-    if (node->type == AST_BINARY_EXPR) {
+    case AST_BINARY_EXPR:
         if (node->child_count >= 2) {
-            char left[512] = "", right[512] = "";
-            ast_to_string(node->children[0], left, sizeof(left));
-            ast_to_string(node->children[1], right, sizeof(right));
-            snprintf(buf, max_len, "(%s %s %s)", left, node->value ? node->value : "op", right);
+            label_put(w, "(");
+            label_expr(w, node->children[0]);
+            label_put(w, " ");
+            label_put(w, node->value ? node->value : "op");
+            label_put(w, " ");
+            label_expr(w, node->children[1]);
+            label_put(w, ")");
         }
         else {
-            snprintf(buf, max_len, "%s", node->value ? node->value : "BinOp");
+            label_put(w, node->value ? node->value : "BinOp");
         }
         return;
-    }
 
-    // Вызовы функций - ГЛАВНОЕ УЛУЧШЕНИЕ
-    if (node->type == AST_CALL_EXPR) {
-        char args_str[1024] = "";
+    case AST_CALL_EXPR: {
+        label_put(w, node->value ? node->value : "func");
+        label_put(w, "(");
         int arg_count = 0;
-
-        // Ищем аргументы среди дочерних узлов
         for (int i = 0; i < node->child_count; i++) {
-            ASTNode* child = node->children[i];
+            const ASTNode* child = node->children[i];
 
-            // Пропускаем сам узел функции (Load(function_name))
-            if (child->type == AST_IDENTIFIER &&
-                node->value && strcmp(child->value, node->value) == 0) {
+            /* сам узел функции (Load(function_name)) */
+            if (child->type == AST_IDENTIFIER && node->value && child->value &&
+                strcmp(child->value, node->value) == 0) {
                 continue;
             }
 
-            // Найдем узел args или обрабатываем напрямую
             if (child->value && strcmp(child->value, "args") == 0) {
-                // Это узел args - раскрываем его аргументы
                 for (int j = 0; j < child->child_count; j++) {
-                    char arg[512] = "";
-                    ast_to_string(child->children[j], arg, sizeof(arg));
-
-                    if (arg_count > 0) strcat(args_str, ", ");
-                    strcat(args_str, arg);
-                    arg_count++;
+                    if (arg_count++ > 0) label_put(w, ", ");
+                    label_expr(w, child->children[j]);
                 }
             }
             else if (child->type != AST_IDENTIFIER) {
-                // Это само выражение аргумента
-                char arg[512] = "";
-                ast_to_string(child, arg, sizeof(arg));
-
-                if (arg_count > 0) strcat(args_str, ", ");
-                strcat(args_str, arg);
-                arg_count++;
+                if (arg_count++ > 0) label_put(w, ", ");
+                label_expr(w, child);
             }
         }
+        label_put(w, ")");
+        return;
+    }
 
-        snprintf(buf, max_len, "%s(%s)",
-            node->value ? node->value : "func",
-            args_str[0] != '\0' ? args_str : "");
+    default:
+        if (node->value && node->value[0] != '\0') {
+            label_put(w, node->value);
+        }
+        else {
+            label_put(w, "<");
+            label_put(w, getNodeTypeName(node->type));
+            label_put(w, ">");
+        }
         return;
     }
+}
 
-    // По умолчанию - имя типа или значение
-    if (node->value && node->value[0] != '\0') {
-        snprintf(buf, max_len, "%s", node->value);
+/* Префикс метки ошибочного условия по виду оператора */
+static const char* label_error_prefix(const ASTNode* stmt) {
+    if (!stmt) return "";
+    switch (stmt->type) {
+    case AST_IF_STATEMENT: return "IF ";
+    case AST_WHILE_STATEMENT: return "WHILE ";
+    case AST_REPEAT_STATEMENT: return "UNTIL ";
+    default: return "";
     }
-    else {
-        snprintf(buf, max_len, "<%s>", getNodeTypeName(node->type));
+}
+
+const char* cfg_node_label(const CFG* cfg, const CFGNode* n, char* buf, size_t size) {
+    if (!n || !buf || size == 0) return NULL;
+    if (n->label) return n->label;
+
+    LabelWriter w = { buf, size, 0 };
+    buf[0] = '\0';
+
+    if (n->type == CFG_START) {
+        for (int f = 0; cfg && f < cfg->function_count; f++) {
+            const CFGFunction* fn = &cfg->functions[f];
+            if (fn->entry != n) continue;
+            snprintf(buf, size, "entry: %s (scope:%d)", fn->name ? fn->name : "unknown", fn->scope_id);
+            return buf;
+        }
+        return NULL;
+    }
+
+    if (n->type == CFG_ERROR) {
+        label_put(&w, "❌ ");
+        label_put(&w, label_error_prefix(n->ast_node));
+        label_expr(&w, n->op_tree);
+        if (n->error_message) {
+            label_put(&w, "\n");
+            label_put(&w, n->error_message);
+        }
+        return buf;
+    }
+
+    /* базовый блок - операторы по строке */
+    for (int i = 0; i < n->expr_tree_count; i++) {
+        if (i > 0) label_put(&w, "\n");
+        label_expr(&w, n->expr_trees[i]);
     }
+    return n->expr_tree_count > 0 ? buf : NULL;
+}
+
+const char* cfg_node_label_cached(CFG* cfg, CFGNode* n) {
+    if (!cfg || !n) return NULL;
+    if (!n->label) {
+        char buf[2048];
+        const char* label = cfg_node_label(cfg, n, buf, sizeof(buf));
+        if (label) n->label = cfg_strdup(cfg, label);
+    }
+    return n->label;
 }
 
 static int segment_ends_with_break(CFGNode* exit_node) {
@@ -448,29 +685,13 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
 
     if (!cfg || !stmt) return result;
 
-    char label[1024] = "";
-
     switch (stmt->type) {
     case AST_EXPR_STATEMENT: {
         if (stmt->child_count > 0) {
             ASTNode* expr = stmt->children[0];
-            ast_to_string(expr, label, sizeof(label));
-
-            CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, label, stmt, expr);
-
-            if (current_symbol_table) {
-                check_expression_semantics(expr, current_symbol_table, node, function_scope_id);
+            CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, NULL, stmt, expr);
 
-                if (node->has_error) {
-                    node->type = CFG_ERROR;
-
-                    char error_label[1024];
-                    snprintf(error_label, sizeof(error_label), "❌ %s\n%s", label, node->error_message);
-                    if (node->label) free(node->label);
-                    node->label = (char*)malloc(strlen(error_label) + 1);
-                    strcpy(node->label, error_label);
-                }
-            }
+            if (take_expression_error(node, expr)) node->type = CFG_ERROR;
 
             result.entry = node;
             result.exit = node;
@@ -482,26 +703,13 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
         if (stmt->child_count < 1) break;
 
         ASTNode* cond = stmt->children[0];
-        ast_to_string(cond, label, sizeof(label));
-
-        CFGNode* cond_node = cfg_create_node(cfg, CFG_CONDITION, label, stmt, cond);
+        CFGNode* cond_node = cfg_create_node(cfg, CFG_CONDITION, NULL, stmt, cond);
 
-        if (current_symbol_table) {
-            check_expression_semantics(cond, current_symbol_table, cond_node, function_scope_id);
-
-            if (cond_node->has_error) {
-                cond_node->type = CFG_ERROR;
-
-                char error_label[1024];
-                snprintf(error_label, sizeof(error_label), "❌ IF %s\n%s", label, cond_node->error_message);
-                if (cond_node->label) free(cond_node->label);
-                cond_node->label = (char*)malloc(strlen(error_label) + 1);
-                strcpy(cond_node->label, error_label);
-
-                result.entry = cond_node;
-                result.exit = cond_node;
-                break;
-            }
+        if (take_expression_error(cond_node, cond)) {
+            cond_node->type = CFG_ERROR;
+            result.entry = cond_node;
+            result.exit = cond_node;
+            break;
         }
 
         CFGSegment then_seg = { NULL, NULL };
@@ -548,32 +756,19 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
         if (stmt->child_count < 1) break;
 
         ASTNode* cond = stmt->children[0];
-        ast_to_string(cond, label, sizeof(label));
-
-        CFGNode* loopcond = cfg_create_node(cfg, CFG_CONDITION, label, stmt, cond);
-
-        if (current_symbol_table) {
-            check_expression_semantics(cond, current_symbol_table, loopcond, function_scope_id);
+        CFGNode* loopcond = cfg_create_node(cfg, CFG_CONDITION, NULL, stmt, cond);
 
-            if (loopcond->has_error) {
-                loopcond->type = CFG_ERROR;
-
-                char error_label[1024];
-                snprintf(error_label, sizeof(error_label), "❌ WHILE %s\n%s", label, loopcond->error_message);
-                if (loopcond->label) free(loopcond->label);
-                loopcond->label = (char*)malloc(strlen(error_label) + 1);
-                strcpy(loopcond->label, error_label);
-
-                result.entry = loopcond;
-                result.exit = loopcond;
-                break;
-            }
+        if (take_expression_error(loopcond, cond)) {
+            loopcond->type = CFG_ERROR;
+            result.entry = loopcond;
+            result.exit = loopcond;
+            break;
         }
 
         CFGNode* exitnode = cfg_create_node(cfg, CFG_MERGE, "exit-while", NULL, NULL);
 
-        CFGNode* old_loop_exit = current_loop_exit;
-        current_loop_exit = exitnode;
+        CFGNode* old_loop_exit = cfg->current_loop_exit;
+        cfg->current_loop_exit = exitnode;
 
         CFGSegment bodyseg = { NULL, NULL };
         if (stmt->child_count > 1) {
@@ -592,7 +787,7 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
 
         cfg_add_default_edge(loopcond, exitnode);
 
-        current_loop_exit = old_loop_exit;
+        cfg->current_loop_exit = old_loop_exit;
 
         result.entry = loopcond;
         result.exit = exitnode;
@@ -600,13 +795,12 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
     }
 
     case AST_REPEAT_STATEMENT: {
-        snprintf(label, sizeof(label), "begin-repeat");
-        CFGNode* repeat_entry = cfg_create_node(cfg, CFG_MERGE, label, stmt, NULL);
+        CFGNode* repeat_entry = cfg_create_node(cfg, CFG_MERGE, "begin-repeat", stmt, NULL);
 
         CFGNode* exit_node = cfg_create_node(cfg, CFG_MERGE, "exit-repeat", NULL, NULL);
 
-        CFGNode* old_loop_exit = current_loop_exit;
-        current_loop_exit = exit_node;
+        CFGNode* old_loop_exit = cfg->current_loop_exit;
+        cfg->current_loop_exit = exit_node;
 
         CFGSegment body_seg = { NULL, NULL };
         if (stmt->child_count > 0) {
@@ -619,30 +813,19 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
         CFGNode* until_node = NULL;
         if (stmt->child_count > 1) {
             ASTNode* until_cond = stmt->children[1];
-            ast_to_string(until_cond, label, sizeof(label));
-            until_node = cfg_create_node(cfg, CFG_CONDITION, label, stmt, until_cond);
-
-            if (current_symbol_table) {
-                check_expression_semantics(until_cond, current_symbol_table, until_node, function_scope_id);
-
-                if (until_node->has_error) {
-                    until_node->type = CFG_ERROR;
-
-                    char error_label[1024];
-                    snprintf(error_label, sizeof(error_label), "❌ UNTIL %s\n%s", label, until_node->error_message);
-                    if (until_node->label) free(until_node->label);
-                    until_node->label = (char*)malloc(strlen(error_label) + 1);
-                    strcpy(until_node->label, error_label);
+            until_node = cfg_create_node(cfg, CFG_CONDITION, NULL, stmt, until_cond);
 
-                    if (body_seg.exit) {
-                        cfg_add_default_edge(body_seg.exit, until_node);
-                    }
+            if (take_expression_error(until_node, until_cond)) {
+                until_node->type = CFG_ERROR;
 
-                    result.entry = repeat_entry;
-                    result.exit = until_node;
-                    current_loop_exit = old_loop_exit;
-                    break;
+                if (body_seg.exit) {
+                    cfg_add_default_edge(body_seg.exit, until_node);
                 }
+
+                result.entry = repeat_entry;
+                result.exit = until_node;
+                cfg->current_loop_exit = old_loop_exit;
+                break;
             }
 
             if (body_seg.exit) {
@@ -653,7 +836,7 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
             cfg_add_default_edge(until_node, repeat_entry);
         }
 
-        current_loop_exit = old_loop_exit;
+        cfg->current_loop_exit = old_loop_exit;
 
         result.entry = repeat_entry;
         result.exit = exit_node;
@@ -661,12 +844,11 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
     }
 
     case AST_BREAK_STATEMENT: {
-        snprintf(label, sizeof(label), "break");
-        CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, label, stmt, NULL);
+        CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, "break", stmt, NULL);
 
-        if (current_loop_exit) {
+        if (cfg->current_loop_exit) {
             node->is_break = 1;
-            cfg_add_default_edge(node, current_loop_exit);
+            cfg_add_default_edge(node, cfg->current_loop_exit);
         }
 
         result.entry = node;
@@ -681,8 +863,7 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
     }
 
     case AST_VAR_DECLARATION: {
-        snprintf(label, sizeof(label), "VAR_DECL");
-        CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, label, stmt, NULL);
+        CFGNode* node = cfg_create_node(cfg, CFG_BLOCK, "VAR_DECL", stmt, NULL);
         result.entry = node;
         result.exit = node;
         break;
@@ -695,79 +876,254 @@ static CFGSegment build_cfg_for_statement(CFG* cfg, ASTNode* stmt, int function_
     return result;
 }
 
-void cfg_build_from_ast(CFG* cfg, ASTNode* ast) {
-    if (!cfg || !ast || ast->type != AST_PROGRAM) return;
+/* Индекс символа-функции name в глобальной области или -1 */
+static int cfg_function_symbol(const SymbolTable* st, const char* name) {
+    if (!st || st->scope_count == 0) return -1;
+    const Scope* global_scope = st->scopes[0];
+    for (int k = 0; k < global_scope->symbol_count; k++) {
+        const Symbol* sym = &st->symbols[global_scope->symbols[k]];
+        if (sym->type == SYM_FUNCTION && sym->name && strcmp(sym->name, name) == 0) {
+            return global_scope->symbols[k];
+        }
+    }
+    return -1;
+}
 
-    for (int i = 0; i < ast->child_count; i++) {
-        ASTNode* func_def = ast->children[i];
-        if (func_def->type != AST_FUNCTION_DEF) continue;
+static CFGFunction* cfg_add_function(CFG* cfg) {
+    if (cfg->function_count >= cfg->function_capacity) {
+        int cap = cfg->function_capacity ? cfg->function_capacity * 2 : 8;
+        CFGFunction* p = (CFGFunction*)realloc(cfg->functions, (size_t)cap * sizeof(CFGFunction));
+        if (!p) return NULL;
+        cfg->functions = p;
+        cfg->function_capacity = cap;
+    }
+    CFGFunction* fn = &cfg->functions[cfg->function_count++];
+    memset(fn, 0, sizeof(*fn));
+    return fn;
+}
 
-        if ((func_def->value && strcmp(func_def->value, "declaration") == 0) || func_def->child_count < 2) {
-            continue;
-        }
+/* =========================
+ * Базовые блоки
+ * ========================= */
 
-        char func_name[256] = "unknown";
-        if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
-            if (func_def->children[0]->value) {
-                snprintf(func_name, sizeof(func_name), "%s", func_def->children[0]->value);
-            }
-        }
+/* Узел только передаёт управление дальше: ничего не вычисляет, один преемник */
+static int cfg_is_empty_jump(const CFGNode* n) {
+    return (n->type == CFG_BLOCK || n->type == CFG_MERGE) && !n->has_error &&
+        n->expr_tree_count == 0 && n->defaultNext && !n->conditionalNext &&
+        n->defaultNext != n;
+}
 
-        // Получаем scope_id для этой функции
-        int func_scope_id = 1; // По умолчанию глобальная
-        if (!current_symbol_table || !func_name) {
-            func_scope_id = 1;
-        }
-        else {
-            // Ищем функцию в таблице символов
-            for (int j = 0; j < current_symbol_table->symbol_count; j++) {
-                Symbol* sym = &current_symbol_table->symbols[j];
-                if (sym->type == SYM_FUNCTION && sym->name &&
-                    strcmp(sym->name, func_name) == 0) {
-                    // Ищем область видимости этой функции
-                    for (int k = 0; k < current_symbol_table->scope_count; k++) {
-                        Scope* scope = current_symbol_table->scopes[k];
-                        if (scope->type == SCOPE_FUNCTION && scope->name &&
-                            strcmp(scope->name, func_name) == 0) {
-                            func_scope_id = scope->id;
-                            printf("    [DEBUG] Function %s found in scope %d\n",
-                                func_name, func_scope_id);
-                            break;
-                        }
-                    }
-                    break;
-                }
-            }
-        }
+/* Первый непустой узел по цепочке пустых; цикл из пустых узлов не трогаем */
+static CFGNode* cfg_skip_empty(CFGNode* n, int limit) {
+    CFGNode* cur = n;
+    while (cur && cfg_is_empty_jump(cur)) {
+        if (limit-- <= 0) return n;
+        cur = cur->defaultNext;
+    }
+    return cur;
+}
 
-        char entry_label[512];
-        snprintf(entry_label, sizeof(entry_label), "entry: %s (scope:%d)",
-            func_name, func_scope_id);
-        CFGNode* entry = cfg_create_node(cfg, CFG_START, entry_label, NULL, NULL);
-        cfg->entry = entry;
+/* b дописывается в конец a: a - безусловный переход в b, у b единственный вход */
+static int cfg_can_absorb(const CFGNode* a, const CFGNode* b) {
+    if (a->type != CFG_BLOCK && a->type != CFG_MERGE) return 0;
+    if (a->has_error || a->conditionalNext || a->defaultNext != b || b == a) return 0;
+    if (b->type != CFG_BLOCK && b->type != CFG_MERGE && b->type != CFG_CONDITION) return 0;
+    return !b->has_error;
+}
 
-        current_loop_exit = NULL;
+/* Цепочка head -> ... -> last становится одним узлом: операторы подряд,
+   переход и тип - последнего узла; остальные - в gone */
+static void cfg_merge_chain(CFG* cfg, CFGNode* head, const int* next, int first, unsigned char* gone) {
+    int count = 0;
+    for (int i = head->id - first; i >= 0; i = next[i]) count += cfg->nodes[first + i]->expr_tree_count;
+    if (!cfg_reserve_expr_trees(cfg, count)) return;
+
+    int at = cfg->expr_tree_count;
+    CFGNode* last = head;
+    for (int i = head->id - first; i >= 0; i = next[i]) {
+        CFGNode* m = cfg->nodes[first + i];
+        memcpy(cfg->expr_trees + cfg->expr_tree_count, cfg->expr_trees + m->expr_tree_first,
+            (size_t)m->expr_tree_count * sizeof(ASTNode*));
+        cfg->expr_tree_count += m->expr_tree_count;
+        if (m != head) gone[i] = 1;
+        last = m;
+    }
+
+    head->expr_tree_first = at;
+    head->expr_tree_count = count;
+    head->expr_trees = count > 0 ? cfg->expr_trees + at : NULL;
+    if (count > 0) head->label = NULL;     /* метка блока - по его операторам */
+
+    head->type = last->type;
+    head->ast_node = last->ast_node;
+    head->op_tree = last->op_tree;
+    head->defaultNext = last->defaultNext;
+    head->conditionalNext = last->conditionalNext;
+}
 
-        CFGSegment body_seg = { NULL, NULL };
-        if (func_def->child_count > 1) {
-            // Используем функцию с явным scope_id
-            body_seg = build_cfg_for_statement(cfg, func_def->children[1], func_scope_id);
+/* Узлы функции fn (хвост cfg->nodes) сворачиваются в базовые блоки:
+   пустые переходы обходятся, цепочки с одним входом и выходом сливаются,
+   лишние узлы уходят из nodes (их память остаётся в пуле до cfg_free) */
+static void cfg_form_blocks(CFG* cfg, CFGFunction* fn) {
+    int first = fn->first_node;
+    int n = cfg->node_count - first;
+    if (n <= 0 || fn->end_node != cfg->node_count) return;
+
+    int* preds = (int*)calloc((size_t)n, sizeof(int));
+    int* next = (int*)malloc((size_t)n * sizeof(int));
+    unsigned char* gone = (unsigned char*)calloc((size_t)n, 1);
+    unsigned char* absorbed = (unsigned char*)calloc((size_t)n, 1);
+    if (!preds || !next || !gone || !absorbed) {
+        free(preds);
+        free(next);
+        free(gone);
+        free(absorbed);
+        return;
+    }
 
-            if (body_seg.entry) {
-                cfg_add_default_edge(entry, body_seg.entry);
-            }
+    /* рёбра - сразу к непустым узлам */
+    for (int i = 0; i < n; i++) {
+        CFGNode* node = cfg->nodes[first + i];
+        node->defaultNext = cfg_skip_empty(node->defaultNext, n);
+        node->conditionalNext = cfg_skip_empty(node->conditionalNext, n);
+    }
+
+    /* пустой переход уходит, если на него больше никто не ссылается */
+    for (int i = 0; i < n; i++) {
+        CFGNode* node = cfg->nodes[first + i];
+        if (node->defaultNext) preds[node->defaultNext->id - first]++;
+        if (node->conditionalNext) preds[node->conditionalNext->id - first]++;
+    }
+    preds[fn->entry->id - first]++;
+    for (int i = 0; i < n; i++) {
+        CFGNode* node = cfg->nodes[first + i];
+        if (preds[i] > 0 || !cfg_is_empty_jump(node)) continue;
+        gone[i] = 1;
+        node->defaultNext = NULL;
+        preds[i] = 0;
+    }
+
+    /* входы заново (без ушедших узлов) и цепочки */
+    memset(preds, 0, (size_t)n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        const CFGNode* node = cfg->nodes[first + i];
+        if (node->defaultNext) preds[node->defaultNext->id - first]++;
+        if (node->conditionalNext) preds[node->conditionalNext->id - first]++;
+    }
+    preds[fn->entry->id - first]++;
+    for (int i = 0; i < n; i++) {
+        const CFGNode* node = cfg->nodes[first + i];
+        next[i] = -1;
+        if (gone[i] || !node->defaultNext) continue;
+        int b = node->defaultNext->id - first;
+        if (preds[b] == 1 && cfg_can_absorb(node, node->defaultNext)) {
+            next[i] = b;
+            absorbed[b] = 1;
+        }
+    }
+
+    /* голова цепочки - узел, который сам ни к кому не дописан */
+    for (int i = 0; i < n; i++) {
+        if (next[i] < 0 || absorbed[i]) continue;
+        cfg_merge_chain(cfg, cfg->nodes[first + i], next, first, gone);
+    }
+
+    int out = first;
+    for (int i = 0; i < n; i++) {
+        CFGNode* node = cfg->nodes[first + i];
+        if (gone[i]) continue;
+        node->id = out;
+        cfg->nodes[out++] = node;
+    }
+    cfg->node_count = out;
+    cfg->next_id = out;
+    fn->end_node = out;
+    cfg->edges_valid = 0;
+
+    free(preds);
+    free(next);
+    free(gone);
+    free(absorbed);
+}
+
+static void build_function(CFG* cfg, ASTNode* func_def) {
+    if (!cfg || !func_def || func_def->type != AST_FUNCTION_DEF) return;
+
+    if ((func_def->value && strcmp(func_def->value, "declaration") == 0) || func_def->child_count < 2) {
+        return;
+    }
+
+    char func_name[256] = "unknown";
+    if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
+        if (func_def->children[0]->value) {
+            snprintf(func_name, sizeof(func_name), "%s", func_def->children[0]->value);
         }
+    }
 
-        CFGNode* exit = cfg_create_node(cfg, CFG_END, "return", NULL, NULL);
-        if (body_seg.exit) {
-            cfg_add_default_edge(body_seg.exit, exit);
+    // Получаем scope_id и символ этой функции
+    int func_scope_id = 1; // По умолчанию глобальная
+    int func_symbol = cfg_function_symbol(cfg->symbol_table, func_name);
+    if (func_symbol >= 0) {
+        Scope* scope = symbol_table_find_function_scope(cfg->symbol_table, func_name);
+        if (scope) {
+            func_scope_id = scope->id;
+            TRACE(TRACE_CFG, TRACE_DEBUG, "    [DEBUG] Function %s found in scope %d\n",
+                func_name, func_scope_id);
         }
-        else {
-            cfg_add_default_edge(entry, exit);
+    }
+
+    int first_node = cfg->node_count;
+    CFGNode* entry = cfg_create_node(cfg, CFG_START, NULL, NULL, NULL);
+    cfg->entry = entry;
+
+    cfg->current_loop_exit = NULL;
+
+    CFGSegment body_seg = { NULL, NULL };
+    if (func_def->child_count > 1) {
+        // Используем функцию с явным scope_id
+        body_seg = build_cfg_for_statement(cfg, func_def->children[1], func_scope_id);
+
+        if (body_seg.entry) {
+            cfg_add_default_edge(entry, body_seg.entry);
         }
+    }
+
+    CFGNode* exit = cfg_create_node(cfg, CFG_END, "return", NULL, NULL);
+    if (body_seg.exit) {
+        cfg_add_default_edge(body_seg.exit, exit);
+    }
+    else {
+        cfg_add_default_edge(entry, exit);
+    }
+
+    cfg->exit = exit;
+
+    CFGFunction* fn = cfg_add_function(cfg);
+    if (!fn) return;
+    fn->name = cfg_strdup(cfg, func_name);
+    fn->scope_id = func_scope_id;
+    fn->symbol = func_symbol;
+    fn->entry = entry;
+    fn->exit = exit;
+    fn->first_node = first_node;
+    fn->end_node = cfg->node_count;
+
+    cfg_form_blocks(cfg, fn);
+}
+
+/* CFG одной функции (AST_FUNCTION_DEF); объявления без тела пропускаются */
+void cfg_build_function(CFG* cfg, ASTNode* func_def) {
+    build_function(cfg, func_def);
+    cfg_finalize(cfg);
+}
 
-        cfg->exit = exit;
+void cfg_build_from_ast(CFG* cfg, ASTNode* ast) {
+    if (!cfg || !ast || ast->type != AST_PROGRAM) return;
+
+    for (int i = 0; i < ast->child_count; i++) {
+        build_function(cfg, ast->children[i]);
     }
+    cfg_finalize(cfg);
 
     printf("[+] CFG generated with %d nodes\n", cfg->node_count);
 }
@@ -982,6 +1338,21 @@ void escape_string_for_dot(const char* input, char* output, size_t max_len) {
     output[j] = '\0';
 }
 
+/* Метка блока - операторы через '\n'; в DOT перевод строки пишется как \n */
+static void dot_label_lines(const char* input, char* output, size_t max_len) {
+    size_t j = 0;
+    for (size_t i = 0; input[i] != '\0' && j + 2 < max_len; i++) {
+        if (input[i] == '\n') {
+            output[j++] = '\\';
+            output[j++] = 'n';
+        }
+        else {
+            output[j++] = input[i];
+        }
+    }
+    output[j] = '\0';
+}
+
 void cfg_export_dot(CFG* cfg, const char* filename) {
     if (!cfg || !filename) return;
 
@@ -1002,22 +1373,26 @@ void cfg_export_dot(CFG* cfg, const char* filename) {
         CFGNode* cfg_node = cfg->nodes[i];
 
         char final_label[2048];
+        char raw_label[1024];
+        char node_label[1536] = "";
+        const char* label = cfg_node_label(cfg, cfg_node, raw_label, sizeof(raw_label));
+        if (label) dot_label_lines(label, node_label, sizeof(node_label));
+
         if (cfg_node->has_error && cfg_node->error_message) {
             char escaped_error[1024];
             escape_string_for_dot(cfg_node->error_message, escaped_error, sizeof(escaped_error));
 
-            if (cfg_node->label) {
+            if (label) {
                 snprintf(final_label, sizeof(final_label),
-                    "%s\\n❌ %s", cfg_node->label, escaped_error);
+                    "%s\\n❌ %s", node_label, escaped_error);
             }
             else {
                 snprintf(final_label, sizeof(final_label),
                     "❌ ERROR\\n%s", escaped_error);
             }
         }
-        else if (cfg_node->label) {
-            strncpy(final_label, cfg_node->label, sizeof(final_label) - 1);
-            final_label[sizeof(final_label) - 1] = '\0';
+        else if (label) {
+            snprintf(final_label, sizeof(final_label), "%s", node_label);
         }
         else {
             snprintf(final_label, sizeof(final_label), "Node %d", cfg_node->id);
@@ -1159,209 +1534,44 @@ void cfg_export_dot(CFG* cfg, const char* filename) {
 }
 
 
-static void mark_error_recursive(ASTNode* node, const char* error_msg) {
-    if (!node) return;
-
-    node->has_error = 1;
-    if (!node->error_message) {
-        node->error_message = (char*)malloc(strlen(error_msg) + 1);
-        strcpy(node->error_message, error_msg);
+/* Ошибка, отмеченная в дереве выражения semantic_analyze (или парсером), переходит на узел CFG */
+static const ASTNode* find_expression_error(const ASTNode* expr) {
+    if (!expr) return NULL;
+    if (expr->has_error && expr->error_message) return expr;
+    for (int i = 0; i < expr->child_count; i++) {
+        const ASTNode* err = find_expression_error(expr->children[i]);
+        if (err) return err;
     }
+    return NULL;
 }
 
+static int take_expression_error(CFGNode* cfg_node, const ASTNode* expr) {
+    const ASTNode* err = find_expression_error(expr);
+    if (!err) return 0;
 
-void check_expression_semantics(ASTNode* expr, SymbolTable* symbol_table, CFGNode* cfg_node, int function_scope_id) {
-    if (!expr || !symbol_table) return;
-
-    switch (expr->type) {
-    case AST_IDENTIFIER: {
-        Symbol* sym = NULL;
-
-        // Сначала ищем в указанной области функции
-        for (int i = 0; i < symbol_table->symbol_count; i++) {
-            if (strcmp(symbol_table->symbols[i].name, expr->value) == 0 &&
-                symbol_table->symbols[i].scope_id == function_scope_id) {
-                sym = &symbol_table->symbols[i];
-                break;
-            }
-        }
-
-        // Если не нашли, ищем в глобальной области
-        if (!sym) {
-            for (int i = 0; i < symbol_table->symbol_count; i++) {
-                if (strcmp(symbol_table->symbols[i].name, expr->value) == 0 &&
-                    symbol_table->symbols[i].scope->type == SCOPE_GLOBAL) {
-                    sym = &symbol_table->symbols[i];
-                    break;
-                }
-            }
-        }
-
-        if (!sym) {
-            char error_msg[512];
-            snprintf(error_msg, sizeof(error_msg),
-                "Undeclared variable '%s' (function scope: %d)",
-                expr->value, function_scope_id);
-
-            cfg_node->has_error = 1;
-            cfg_node->error_message = (char*)malloc(strlen(error_msg) + 1);
-            strcpy(cfg_node->error_message, error_msg);
-
-            expr->has_error = 1;
-            if (!expr->error_message) {
-                expr->error_message = (char*)malloc(strlen(error_msg) + 1);
-                strcpy(expr->error_message, error_msg);
-            }
-
-            printf("    [ERROR] Undeclared variable '%s' (scope: %d)\n",
-                expr->value, function_scope_id);
-        }
-        break;
-    }
-
-    case AST_ASSIGNMENT: {
-        int has_child_error = 0;
-
-        // Проверяем левую часть (идентификатор)
-        if (expr->child_count >= 1) {
-            check_expression_semantics(expr->children[0], symbol_table, cfg_node, function_scope_id);
-            if (expr->children[0] && expr->children[0]->has_error) {
-                has_child_error = 1;
-            }
-        }
-
-        // Проверяем правую часть (значение)
-        if (expr->child_count >= 2) {
-            check_expression_semantics(expr->children[1], symbol_table, cfg_node, function_scope_id);
-            if (expr->children[1] && expr->children[1]->has_error) {
-                has_child_error = 1;
-            }
-        }
-
-        if (has_child_error) {
-            mark_error_recursive(expr, "Assignment has error in child expression");
-            cfg_node->has_error = 1;
-            if (!cfg_node->error_message) {
-                cfg_node->error_message = (char*)malloc(256);
-                strcpy(cfg_node->error_message, "Assignment has error in child expression");
-            }
-        }
-        break;
-    }
-
-    case AST_BINARY_EXPR: {
-        int has_child_error = 0;
-        if (expr->child_count >= 2) {
-            check_expression_semantics(expr->children[0], symbol_table, cfg_node, function_scope_id);
-            check_expression_semantics(expr->children[1], symbol_table, cfg_node, function_scope_id);
-
-            if ((expr->children[0] && expr->children[0]->has_error) ||
-                (expr->children[1] && expr->children[1]->has_error)) {
-                has_child_error = 1;
-            }
-        }
-
-        if (has_child_error) {
-            mark_error_recursive(expr, "Child expression has error");
-            cfg_node->has_error = 1;
-            if (!cfg_node->error_message) {
-                cfg_node->error_message = (char*)malloc(256);
-                strcpy(cfg_node->error_message, "Child expression has error");
-            }
-        }
-        break;
-    }
-
-    case AST_UNARY_EXPR: {
-        if (expr->child_count > 0) {
-            check_expression_semantics(expr->children[0], symbol_table, cfg_node, function_scope_id);
-
-            if (expr->children[0] && expr->children[0]->has_error) {
-                mark_error_recursive(expr, "Child expression has error");
-                cfg_node->has_error = 1;
-                if (!cfg_node->error_message) {
-                    cfg_node->error_message = (char*)malloc(256);
-                    strcpy(cfg_node->error_message, "Child expression has error");
-                }
-            }
-        }
-        break;
-    }
-
-    case AST_CALL_EXPR: {
-        Symbol* sym = symbol_table_lookup(symbol_table, expr->value);
-        if (!sym || sym->type != SYM_FUNCTION) {
-            char error_msg[512];
-            snprintf(error_msg, sizeof(error_msg),
-                "Undeclared function '%s'", expr->value);
-
-            cfg_node->has_error = 1;
-            cfg_node->error_message = (char*)malloc(strlen(error_msg) + 1);
-            strcpy(cfg_node->error_message, error_msg);
-
-            expr->has_error = 1;
-            if (!expr->error_message) {
-                expr->error_message = (char*)malloc(strlen(error_msg) + 1);
-                strcpy(expr->error_message, error_msg);
-            }
-
-            printf("    [ERROR] Undeclared function '%s'\n", expr->value);
-        }
-
-        int has_child_error = 0;
-        for (int i = 0; i < expr->child_count; i++) {
-            check_expression_semantics(expr->children[i], symbol_table, cfg_node, function_scope_id);
-            if (expr->children[i] && expr->children[i]->has_error) {
-                has_child_error = 1;
-            }
-        }
-
-        if (has_child_error) {
-            mark_error_recursive(expr, "Child expression has error");
-            cfg_node->has_error = 1;
-            if (!cfg_node->error_message) {
-                cfg_node->error_message = (char*)malloc(256);
-                strcpy(cfg_node->error_message, "Child expression has error");
-            }
-        }
-        break;
-    }
-
-    case AST_INDEX_EXPR: {
-        int has_child_error = 0;
-        if (expr->child_count > 0) {
-            check_expression_semantics(expr->children[0], symbol_table, cfg_node, function_scope_id);
-            if (expr->children[0] && expr->children[0]->has_error) {
-                has_child_error = 1;
-            }
-        }
-        if (expr->child_count > 1) {
-            check_expression_semantics(expr->children[1], symbol_table, cfg_node, function_scope_id);
-            if (expr->children[1] && expr->children[1]->has_error) {
-                has_child_error = 1;
-            }
-        }
-
-        if (has_child_error) {
-            mark_error_recursive(expr, "Child expression has error");
-            cfg_node->has_error = 1;
-            if (!cfg_node->error_message) {
-                cfg_node->error_message = (char*)malloc(256);
-                strcpy(cfg_node->error_message, "Child expression has error");
-            }
-        }
-        break;
-    }
-
-    default:
-        break;
+    cfg_node->has_error = 1;
+    if (!cfg_node->error_message) {
+        cfg_node->error_message = (char*)malloc(strlen(err->error_message) + 1);
+        strcpy(cfg_node->error_message, err->error_message);
     }
+    return 1;
 }
 
-void cfg_check_semantics(CFG* cfg, SymbolTable* symbol_table) {
-    if (!cfg || !symbol_table) return;
-
-    printf("    [INFO] Semantic checking is done during CFG construction\n");
+/* Выражения узла по порядку (у CFG_CONDITION последнее - условие) */
+ASTNode** cfg_node_exprs(const CFGNode* n, int* count) {
+    *count = 0;
+    if (!n) return NULL;
+    if (n->type == CFG_START || n->type == CFG_END || n->type == CFG_ERROR) return NULL;
+
+    ASTNode* stmt = n->ast_node;
+    if (n->type == CFG_RETURN || (stmt && stmt->type == AST_RETURN_STATEMENT)) {
+        if (!stmt || stmt->child_count == 0) return NULL;
+        *count = 1;
+        return stmt->children;
+    }
+    if (n->expr_tree_count == 0) return NULL;
+    *count = n->expr_tree_count;
+    return n->expr_trees;
 }
 
 void cfg_free(CFG* cfg) {
@@ -1369,19 +1579,20 @@ void cfg_free(CFG* cfg) {
 
     for (int i = 0; i < cfg->node_count; i++) {
         CFGNode* node = cfg->nodes[i];
-        if (node->label) free(node->label);
         if (node->error_message) free(node->error_message);
         if (node->function_name) free(node->function_name);
-
-        // Освобождаем массив деревьев (сами деревья в другом месте)
-        if (node->expr_trees) {
-            free(node->expr_trees);
-            node->expr_trees = NULL;
-        }
-
-        free(node);
     }
 
-    if (cfg->nodes) free(cfg->nodes);
+    /* узлы, метки и массив деревьев (сами деревья в другом месте) */
+    cfg_chunks_free(cfg->node_chunks);
+    cfg_chunks_free(cfg->string_chunks);
+    free(cfg->expr_trees);
+    free(cfg->nodes);
+    for (int f = 0; f < cfg->function_count; f++) cfg_function_orders_free(&cfg->functions[f]);
+    free(cfg->functions);
+    free(cfg->succ_start);
+    free(cfg->succ);
+    free(cfg->pred_start);
+    free(cfg->pred);
     free(cfg);
 }
\ No newline at end of file
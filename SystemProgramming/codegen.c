@@ -1,9 +1,9 @@
 ﻿#include "codegen.h"
+#include "sched.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
-#include <ctype.h>
 #include <math.h>
 #include <stdint.h>
 
@@ -15,16 +15,6 @@ enum {
     DIN_TAG_STRING = 5
 };
 
-static int32_t parse_float_to_q16_16(const char* s) {
-    if (!s) return 0;
-    double d = strtod(s, NULL);
-    double scaled = d * 65536.0;
-    long long v = (long long)llround(scaled);
-    if (v > 2147483647LL) v = 2147483647LL;
-    if (v < -2147483648LL) v = -2147483648LL;
-    return (int32_t)v;
-}
-
 typedef struct {
     char* buf;
     size_t len;
@@ -94,6 +84,7 @@ static int sb_appendf(Str* s, const char* fmt, ...) {
 
 typedef struct {
     int used[8];
+    int pinned[8]; /* registers holding promoted variables for the whole function */
 } RegPool;
 
 static void reg_init(RegPool* rp) {
@@ -102,6 +93,10 @@ static void reg_init(RegPool* rp) {
     rp->used[7] = 1;
     /* reserve r0 for CALL return / special cases */
     rp->used[0] = 1;
+    /* promoted variables stay in their registers across nodes */
+    for (int i = 1; i <= 6; i++) {
+        if (rp->pinned[i]) rp->used[i] = 1;
+    }
 }
 
 static int reg_alloc(RegPool* rp) {
@@ -117,6 +112,7 @@ static int reg_alloc(RegPool* rp) {
 
 static void reg_free(RegPool* rp, int r) {
     if (r < 1 || r > 6) return;
+    if (rp->pinned[r]) return;
     rp->used[r] = 0;
 }
 
@@ -128,154 +124,21 @@ static const char* rname(int r) {
 }
 
 /* =========================
- * CFG function discovery
- * ========================= */
-
-typedef struct {
-    char name[256];
-    int scope_id;
-    const CFGNode* entry;
-} FunctionInfo;
-
-static int starts_with(const char* s, const char* pref) {
-    if (!s || !pref) return 0;
-    size_t n = strlen(pref);
-    return strncmp(s, pref, n) == 0;
-}
-
-static void trim_spaces(char* s) {
-    if (!s) return;
-    size_t n = strlen(s);
-    while (n > 0 && isspace((unsigned char)s[n - 1])) { s[n - 1] = 0; n--; }
-    char* p = s;
-    while (*p && isspace((unsigned char)*p)) p++;
-    if (p != s) memmove(s, p, strlen(p) + 1);
-}
-
-/* label вида: "entry: main (scope:2)" */
-static int parse_entry_label(const char* label, char* out_name, size_t out_cap, int* out_scope) {
-    if (!label || !starts_with(label, "entry:")) return 0;
-
-    const char* p = label + strlen("entry:");
-    while (*p && isspace((unsigned char)*p)) p++;
-
-    const char* par = strstr(p, "(");
-    size_t name_len = par ? (size_t)(par - p) : strlen(p);
-    if (name_len >= out_cap) name_len = out_cap - 1;
-
-    memcpy(out_name, p, name_len);
-    out_name[name_len] = 0;
-    trim_spaces(out_name);
-
-    int scope = 1;
-    if (par) {
-        const char* sc = strstr(par, "scope:");
-        if (sc) {
-            sc += strlen("scope:");
-            scope = atoi(sc);
-        }
-    }
-    if (out_scope) *out_scope = scope;
-    return 1;
-}
-
-static int collect_functions(const CFG* cfg, FunctionInfo** out_funcs, int* out_count) {
-    if (!cfg || !out_funcs || !out_count) return 0;
-
-    int cap = 8;
-    int count = 0;
-    FunctionInfo* funcs = (FunctionInfo*)calloc((size_t)cap, sizeof(FunctionInfo));
-    if (!funcs) return 0;
-
-    for (int i = 0; i < cfg->node_count; i++) {
-        const CFGNode* n = cfg->nodes[i];
-        if (!n) continue;
-        if (n->type != CFG_START) continue;
-
-        char fname[256];
-        int sid = 1;
-        if (!parse_entry_label(n->label, fname, sizeof(fname), &sid)) continue;
-
-        if (count >= cap) {
-            cap *= 2;
-            FunctionInfo* nf = (FunctionInfo*)realloc(funcs, (size_t)cap * sizeof(FunctionInfo));
-            if (!nf) { free(funcs); return 0; }
-            funcs = nf;
-        }
-
-        memset(&funcs[count], 0, sizeof(FunctionInfo));
-        snprintf(funcs[count].name, sizeof(funcs[count].name), "%s", fname);
-        funcs[count].scope_id = sid;
-        funcs[count].entry = n;
-        count++;
-    }
-
-    *out_funcs = funcs;
-    *out_count = count;
-    return 1;
-}
-
-/* =========================
- * Symbol lookup in a given scope chain
+ * Scopes
+ *
+ * Символы идентификаторов не ищутся по имени: semantic_analyze связывает
+ * каждый идентификатор с символом (ASTNode.symbol), см. symbol_table_resolve.
  * ========================= */
 
-static Scope* find_scope_by_id(const SymbolTable* st, int id) {
-    if (!st) return NULL;
-    for (int i = 0; i < st->scope_count; i++) {
-        if (st->scopes[i] && st->scopes[i]->id == id) return st->scopes[i];
-    }
-    return NULL;
-}
-
-static Symbol* find_symbol_in_scope(const SymbolTable* st, const char* name, int scope_id) {
-    if (!st || !name) return NULL;
-    for (int i = 0; i < st->symbol_count; i++) {
-        Symbol* sym = &st->symbols[i];
-        if (!sym->name) continue;
-        if (sym->scope_id != scope_id) continue;
-        if (strcmp(sym->name, name) == 0) {
-            return sym;
-        }
-    }
-    return NULL;
-}
-
-static Symbol* cg_lookup_symbol(const SymbolTable* st, const char* name, int scope_id) {
-    if (!st || !name) return NULL;
-
-    Scope* sc = find_scope_by_id(st, scope_id);
-    while (sc) {
-        Symbol* s = find_symbol_in_scope(st, name, sc->id);
-        if (s) return s;
-        sc = sc->parent;
-    }
-
-    /* fallback: global */
-    return find_symbol_in_scope(st, name, 1);
-}
-
 static int symbol_is_stack_resident(const Symbol* s) {
     if (!s) return 0;
     return (s->type == SYM_LOCAL || s->type == SYM_PARAMETER);
 }
 
-/*
- * Вычислить размер фрейма функции: берем все локальные символы/параметры внутри поддерева scopes.
- * Для простоты: учитываем все SYM_LOCAL у которых scope лежит в цепочке родительства от function scope.
- */
-static int scope_is_descendant_of(Scope* candidate, Scope* ancestor) {
-    if (!candidate || !ancestor) return 0;
-    Scope* cur = candidate;
-    while (cur) {
-        if (cur->id == ancestor->id) return 1;
-        cur = cur->parent;
-    }
-    return 0;
-}
-
+/* Вычислить размер фрейма функции */
 static int compute_frame_size_bytes(const SymbolTable* st, int function_scope_id) {
     if (!st) return 0;
-    Scope* func_scope = find_scope_by_id(st, function_scope_id);
+    Scope* func_scope = symbol_table_scope(st, function_scope_id);
     if (!func_scope) return 0;
 
     /*
@@ -317,9 +180,11 @@ typedef struct {
     /* множество reachable nodes текущей функции */
 
 
+    /* текущая функция CFG: её узлы - cfg->nodes[fn->first_node .. fn->end_node) */
+    const CFGFunction* fn;
+
     /* label storage (avoid static-buffer aliasing) */
-    int max_node_id;
-    char** node_label_map; /* by node id */
+    char** node_label_map; /* by node id - fn->first_node */
     char** temp_labels;
     int temp_count;
     int temp_cap;
@@ -329,7 +194,9 @@ typedef struct {
     const Symbol* return_sym; /* heuristic: variable holding return value */
     int has_return_value;
 
-    unsigned char* reachable; /* cfg->node_count */
+
+    /* register-promoted variables of the current function (by register) */
+    const Symbol* promoted[8];
 } CG;
 
 static void cg_comment(CG* cg, const char* fmt, ...) {
@@ -339,7 +206,14 @@ static void cg_comment(CG* cg, const char* fmt, ...) {
     char buf[2048];
     vsnprintf(buf, sizeof(buf), fmt, ap);
     va_end(ap);
-    sb_appendf(&cg->out, "; %s\n", buf);
+
+    /* метка блока - по оператору в строке, каждая строка - свой комментарий */
+    for (char* line = buf; line; ) {
+        char* nl = strchr(line, '\n');
+        if (nl) *nl = '\0';
+        sb_appendf(&cg->out, "; %s\n", line);
+        line = nl ? nl + 1 : NULL;
+    }
 }
 
 static char* xstrdup(const char* s) {
@@ -353,28 +227,24 @@ static char* xstrdup(const char* s) {
 
 static void cg_labels_init(CG* cg) {
     if (!cg || !cg->cfg) return;
-    int max_id = 0;
-    for (int i = 0; i < cg->cfg->node_count; i++) {
-        if (cg->cfg->nodes[i] && cg->cfg->nodes[i]->id > max_id) {
-            max_id = cg->cfg->nodes[i]->id;
-        }
-    }
-    cg->max_node_id = max_id;
-    cg->node_label_map = (char**)calloc((size_t)(max_id + 1), sizeof(char*));
+    cg->node_label_map = NULL;
     cg->temp_labels = NULL;
     cg->temp_count = 0;
     cg->temp_cap = 0;
 }
 
+static void cg_node_labels_free(CG* cg) {
+    if (!cg->node_label_map || !cg->fn) return;
+    for (int i = 0; i < cg->fn->end_node - cg->fn->first_node; i++) {
+        free(cg->node_label_map[i]);
+    }
+    free(cg->node_label_map);
+    cg->node_label_map = NULL;
+}
+
 static void cg_labels_free(CG* cg) {
     if (!cg) return;
-    if (cg->node_label_map) {
-        for (int i = 0; i <= cg->max_node_id; i++) {
-            free(cg->node_label_map[i]);
-        }
-        free(cg->node_label_map);
-        cg->node_label_map = NULL;
-    }
+    cg_node_labels_free(cg);
     for (int i = 0; i < cg->temp_count; i++) {
         free(cg->temp_labels[i]);
     }
@@ -387,13 +257,14 @@ static void cg_labels_free(CG* cg) {
 static const char* cg_node_label(CG* cg, const CFGNode* n) {
     if (!cg || !n) return "_L_invalid";
     int id = n->id;
-    if (id < 0 || id > cg->max_node_id || !cg->node_label_map) return "_L_invalid";
-    if (!cg->node_label_map[id]) {
+    if (!cg->fn || id < cg->fn->first_node || id >= cg->fn->end_node || !cg->node_label_map) return "_L_invalid";
+    char** slot = &cg->node_label_map[id - cg->fn->first_node];
+    if (!*slot) {
         char buf[256];
         snprintf(buf, sizeof(buf), "_L_%s_%d", cg->func_name, id);
-        cg->node_label_map[id] = xstrdup(buf);
+        *slot = xstrdup(buf);
     }
-    return cg->node_label_map[id] ? cg->node_label_map[id] : "_L_invalid";
+    return *slot ? *slot : "_L_invalid";
 }
 
 static const char* cg_new_label(CG* cg, const char* prefix) {
@@ -507,6 +378,15 @@ static void emit_addr_abs(CG* cg, const Symbol* sym) {
     emit(cg, "    LA r7, #%d\n", sym->address);
 }
 
+/* register holding a promoted variable, or -1 if it lives in memory */
+static int cg_promoted_reg(const CG* cg, const Symbol* sym) {
+    if (!cg || !sym) return -1;
+    for (int r = 1; r <= 6; r++) {
+        if (cg->promoted[r] == sym) return r;
+    }
+    return -1;
+}
+
 static int emit_load_symbol(CG* cg, const Symbol* sym) {
     int r = reg_alloc(&cg->regs);
     if (r < 0) {
@@ -514,6 +394,12 @@ static int emit_load_symbol(CG* cg, const Symbol* sym) {
         r = 1; /* best effort */
     }
 
+    int rp = cg_promoted_reg(cg, sym);
+    if (rp > 0) {
+        emit_ins2(cg, "MOV", rname(r), rname(rp));
+        return r;
+    }
+
     /* static arrays evaluate to their base address; dynamic arrays are pointers */
     if (sym && sym->is_array && sym->array_size > 0) {
         if (symbol_is_stack_resident(sym)) {
@@ -553,6 +439,11 @@ static int emit_load_symbol(CG* cg, const Symbol* sym) {
 
 static void emit_store_symbol(CG* cg, const Symbol* sym, int r_value) {
     if (!sym) return;
+    int rp = cg_promoted_reg(cg, sym);
+    if (rp > 0) {
+        emit_ins2(cg, "MOV", rname(rp), rname(r_value));
+        return;
+    }
     if (symbol_is_stack_resident(sym)) {
         emit_addr_stack_sym(cg, sym);
         emit_ins2(cg, "STS", "r7", rname(r_value));
@@ -573,65 +464,9 @@ static void emit_store_symbol(CG* cg, const Symbol* sym, int r_value) {
 static int cg_eval_expr(CG* cg, const ASTNode* e);
 static void cg_emit_branch_on_expr(CG* cg, const ASTNode* e, const char* lbl_true, const char* lbl_false);
 
-static long parse_int_literal(const char* s, int* ok) {
-    if (ok) *ok = 0;
-    if (!s) return 0;
-    char* end = NULL;
-    long v = strtol(s, &end, 0);
-    if (end != s) {
-        if (ok) *ok = 1;
-        return v;
-    }
-    return 0;
-}
-
-static int parse_bool_literal(const char* s, int* ok) {
-    if (ok) *ok = 0;
-    if (!s) return 0;
-    if (strcmp(s, "true") == 0) { if (ok) *ok = 1; return 1; }
-    if (strcmp(s, "false") == 0) { if (ok) *ok = 1; return 0; }
-    return 0;
-}
-
-static long parse_char_literal(const char* s, int* ok) {
-    if (ok) *ok = 0;
-    if (!s) return 0;
-    size_t n = strlen(s);
-    if (n < 3 || s[0] != '\'' || s[n - 1] != '\'') return 0;
-
-    const char* inner = s + 1;
-    size_t in_len = n - 2;
-
-    if (in_len == 1) {
-        if (ok) *ok = 1;
-        return (unsigned char)inner[0];
-    }
-
-    if (in_len == 2 && inner[0] == '\\') {
-        char c = inner[1];
-        long v = 0;
-        switch (c) {
-        case 'n': v = 10; break;
-        case 'r': v = 13; break;
-        case 't': v = 9; break;
-        case '0': v = 0; break;
-        case '\\': v = '\\'; break;
-        case '\'': v = '\''; break;
-        default: v = (unsigned char)c; break;
-        }
-        if (ok) *ok = 1;
-        return v;
-    }
-
-    return 0;
-}
-
-/* Размер типа в байтах (должен быть согласован с semantic.c). */
-static int cg_type_size_bytes(const char* t) {
-    if (!t) return 4;
-    if (strcmp(t, "din") == 0) return 8;
-    if (strcmp(t, "long") == 0 || strcmp(t, "ulong") == 0) return 8;
-    return 4;
+/* din-символ (или массив din): значение + тег */
+static int cg_is_din(const Symbol* s) {
+    return s && s->dtype && type_element(s->dtype)->kind == TYPE_DIN;
 }
 
 /*
@@ -934,8 +769,8 @@ static DinVal cg_eval_din_expr(CG* cg, const ASTNode* e) {
 
     /* din identifier */
     if (e->type == AST_IDENTIFIER && e->value) {
-        const Symbol* s = cg_lookup_symbol((SymbolTable*)cg->st, e->value, cg->func_scope_id);
-        if (s && s->data_type && strcmp(s->data_type, "din") == 0) {
+        const Symbol* s = symbol_table_resolve(cg->st, e, cg->func_scope_id);
+        if (cg_is_din(s)) {
             return cg_load_din_symbol(cg, s);
         }
 
@@ -955,7 +790,7 @@ static DinVal cg_eval_din_expr(CG* cg, const ASTNode* e) {
         if (dv.v < 0) { dv.v = 1; cg->regs.used[dv.v] = 1; }
         dv.tag = reg_alloc(&cg->regs);
         if (dv.tag < 0) { dv.tag = 2; cg->regs.used[dv.tag] = 1; }
-        int32_t q = parse_float_to_q16_16(e->value);
+        int32_t q = (int32_t)e->literal.value;
         emit_load_i32(cg, dv.v, q);
         emit(cg, "    MOVI %s, #%d\n", rname(dv.tag), DIN_TAG_FLOAT);
         return dv;
@@ -1079,7 +914,7 @@ static int cg_eval_lvalue_address(CG* cg, const ASTNode* lv) {
 
     /* &identifier */
     if (lv->type == AST_IDENTIFIER && lv->value) {
-        const Symbol* sym = cg_lookup_symbol((SymbolTable*)cg->st, lv->value, cg->func_scope_id);
+        const Symbol* sym = symbol_table_resolve(cg->st, lv, cg->func_scope_id);
         int r_addr = reg_alloc(&cg->regs);
         if (r_addr < 0) { r_addr = 1; cg->regs.used[r_addr] = 1; }
 
@@ -1112,7 +947,7 @@ static int cg_eval_lvalue_address(CG* cg, const ASTNode* lv) {
         if (r_addr < 0) { r_addr = 1; cg->regs.used[r_addr] = 1; }
 
         if (base && base->type == AST_IDENTIFIER && base->value) {
-            sym = cg_lookup_symbol((SymbolTable*)cg->st, base->value, cg->func_scope_id);
+            sym = symbol_table_resolve(cg->st, base, cg->func_scope_id);
         }
 
         if (sym && symbol_is_stack_resident(sym)) {
@@ -1214,14 +1049,15 @@ static int cg_eval_call(CG* cg, const ASTNode* e) {
     }
 
     /* Save caller-live regs (r1..r6) because callee may clobber anything.
-       We push them and mark free so arg-eval can reuse them. */
+       We push them and mark free so arg-eval can reuse them.
+       Promoted variables are saved too but stay readable during arg-eval. */
     int saved[8];
     int saved_count = 0;
     for (int r = 1; r <= 6; r++) {
         if (cg->regs.used[r]) {
             emit(cg, "    PUSH %s\n", rname(r));
             saved[saved_count++] = r;
-            cg->regs.used[r] = 0;
+            if (!cg->regs.pinned[r]) cg->regs.used[r] = 0;
         }
     }
 
@@ -1275,7 +1111,7 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
         int r = reg_alloc(&cg->regs);
         if (r < 0) r = 1;
         /* Float is represented as fixed-point Q16.16 in 32-bit int */
-        int32_t q = parse_float_to_q16_16(e->value);
+        int32_t q = (int32_t)e->literal.value;
         emit_load_i32(cg, r, q);
         return r;
     }
@@ -1283,23 +1119,22 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
         /* integer literal (signed) */
         int r = reg_alloc(&cg->regs);
         if (r < 0) r = 1;
-        long v = 0;
-        if (e->value) v = strtol(e->value, NULL, 0);
+        long long v = e->literal.value;
         if (v >= 0 && v <= 65535) {
-            emit(cg, "    MOVI %s, #%ld\n", rname(r), v);
+            emit(cg, "    MOVI %s, #%lld\n", rname(r), v);
             return r;
         }
         if (v < 0 && (-v) <= 65535) {
             int tmp = reg_alloc(&cg->regs);
             if (tmp < 0) tmp = 2;
             emit(cg, "    MOVI %s, #0\n", rname(r));
-            emit(cg, "    MOVI %s, #%ld\n", rname(tmp), -v);
+            emit(cg, "    MOVI %s, #%lld\n", rname(tmp), -v);
             emit_ins3(cg, "SUB", rname(r), rname(r), rname(tmp));
             reg_free(&cg->regs, tmp);
             return r;
         }
-        /* fallback: clamp to 0 */
-        emit(cg, "    MOVI %s, #0\n", rname(r));
+        /* full 32 bits (wider literals are reported by the lexer) */
+        emit_load_u32(cg, r, (uint32_t)v);
         return r;
     }
 
@@ -1307,20 +1142,14 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
     case AST_BOOL_LITERAL: {
         int r = reg_alloc(&cg->regs);
         if (r < 0) r = 1;
-        int ok = 0;
-        int v = parse_bool_literal(e->value, &ok);
-        if (!ok) v = 0;
-        emit(cg, "    MOVI %s, #%d\n", rname(r), v);
+        emit(cg, "    MOVI %s, #%d\n", rname(r), (int)e->literal.value);
         return r;
     }
 
     case AST_CHAR_LITERAL: {
         int r = reg_alloc(&cg->regs);
         if (r < 0) r = 1;
-        int ok = 0;
-        long v = parse_char_literal(e->value, &ok);
-        if (!ok) v = 0;
-        emit(cg, "    MOVI %s, #%ld\n", rname(r), v);
+        emit(cg, "    MOVI %s, #%lld\n", rname(r), (long long)e->literal.value);
         return r;
     }
 
@@ -1341,7 +1170,7 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
         if (r_addr < 0) { r_addr = 1; cg->regs.used[r_addr] = 1; }
 
         if (base && base->type == AST_IDENTIFIER && base->value) {
-            sym = cg_lookup_symbol((SymbolTable*)cg->st, base->value, cg->func_scope_id);
+            sym = symbol_table_resolve(cg->st, base, cg->func_scope_id);
         }
 
         /* base address */
@@ -1394,7 +1223,7 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
                 if (es > 0) elem_sz = es;
             }
             else {
-                elem_sz = cg_type_size_bytes(sym->data_type);
+                elem_sz = type_element(sym->dtype)->size;
             }
         }
 
@@ -1443,7 +1272,7 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
     }
 
     case AST_IDENTIFIER: {
-        Symbol* sym = cg_lookup_symbol(cg->st, e->value, cg->func_scope_id);
+        Symbol* sym = symbol_table_resolve(cg->st, e, cg->func_scope_id);
         if (!sym) {
             int r = reg_alloc(&cg->regs);
             if (r < 0) r = 1;
@@ -1470,7 +1299,7 @@ static int cg_eval_expr(CG* cg, const ASTNode* e) {
     case AST_ADDR_OF: {
         /* адрес переменной */
         if (e->child_count > 0 && e->children[0] && e->children[0]->type == AST_IDENTIFIER) {
-            Symbol* sym = cg_lookup_symbol(cg->st, e->children[0]->value, cg->func_scope_id);
+            Symbol* sym = symbol_table_resolve(cg->st, e->children[0], cg->func_scope_id);
             int r = reg_alloc(&cg->regs);
             if (r < 0) r = 1;
             if (sym && symbol_is_stack_resident(sym)) {
@@ -1587,36 +1416,6 @@ static void cg_emit_branch_on_expr(CG* cg, const ASTNode* e, const char* lbl_tru
  * Reachability (per-function)
  * ========================= */
 
-static int node_index(const CFG* cfg, const CFGNode* n) {
-    if (!cfg || !n) return -1;
-    for (int i = 0; i < cfg->node_count; i++) {
-        if (cfg->nodes[i] == n) return i;
-    }
-    return -1;
-}
-
-static void mark_reachable(CG* cg, const CFGNode* start) {
-    int ncount = cg->cfg->node_count;
-    memset(cg->reachable, 0, (size_t)ncount);
-
-    const CFGNode** stack = (const CFGNode**)malloc((size_t)ncount * sizeof(CFGNode*));
-    int sp = 0;
-    stack[sp++] = start;
-
-    while (sp > 0) {
-        const CFGNode* cur = stack[--sp];
-        int idx = node_index(cg->cfg, cur);
-        if (idx < 0) continue;
-        if (cg->reachable[idx]) continue;
-        cg->reachable[idx] = 1;
-
-        if (cur->defaultNext) stack[sp++] = cur->defaultNext;
-        if (cur->conditionalNext) stack[sp++] = cur->conditionalNext;
-    }
-
-    free((void*)stack);
-}
-
 /* =========================
  * Node emission
  * ========================= */
@@ -1631,14 +1430,16 @@ static int infer_din_tag(CG* cg, const ASTNode* e) {
     case AST_FLOAT_LITERAL:  return DIN_TAG_FLOAT;
     case AST_LITERAL:        return DIN_TAG_INT;
     case AST_IDENTIFIER: {
-        const Symbol* s = cg ? symbol_table_lookup(cg->st, e->value) : NULL;
-        if (!s || !s->data_type) return DIN_TAG_INT;
-        if (strcmp(s->data_type, "din") == 0) return 0; /* means: copy tag from source */
-        if (strcmp(s->data_type, "float") == 0) return DIN_TAG_FLOAT;
-        if (strcmp(s->data_type, "char") == 0) return DIN_TAG_CHAR;
-        if (strcmp(s->data_type, "bool") == 0) return DIN_TAG_BOOL;
-        if (strcmp(s->data_type, "string") == 0) return DIN_TAG_STRING;
-        return DIN_TAG_INT;
+        const Symbol* s = cg ? symbol_table_resolve(cg->st, e, cg->func_scope_id) : NULL;
+        if (!s || !s->dtype) return DIN_TAG_INT;
+        switch (type_element(s->dtype)->kind) {
+        case TYPE_DIN:    return 0; /* means: copy tag from source */
+        case TYPE_FLOAT:  return DIN_TAG_FLOAT;
+        case TYPE_CHAR:   return DIN_TAG_CHAR;
+        case TYPE_BOOL:   return DIN_TAG_BOOL;
+        case TYPE_STRING: return DIN_TAG_STRING;
+        default:          return DIN_TAG_INT;
+        }
     }
     case AST_UNARY_EXPR: {
         if (e->child_count > 0 && infer_din_tag(cg, e->children[0]) == DIN_TAG_FLOAT) return DIN_TAG_FLOAT;
@@ -1684,7 +1485,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
         if (r_addr < 0) { r_addr = 1; cg->regs.used[r_addr] = 1; }
 
         if (base && base->type == AST_IDENTIFIER && base->value) {
-            sym = cg_lookup_symbol((SymbolTable*)cg->st, base->value, cg->func_scope_id);
+            sym = symbol_table_resolve(cg->st, base, cg->func_scope_id);
         }
 
         /* base address */
@@ -1736,7 +1537,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
                 if (es > 0) elem_sz = es;
             }
             else {
-                elem_sz = cg_type_size_bytes(sym->data_type);
+                elem_sz = type_element(sym->dtype)->size;
             }
         }
 
@@ -1786,7 +1587,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
     if (!lhs || lhs->type != AST_IDENTIFIER || !lhs->value) {
         return cg_eval_expr(cg, rhs);
     }
-    const Symbol* sym = cg_lookup_symbol((SymbolTable*)cg->st, lhs->value, cg->func_scope_id);
+    const Symbol* sym = symbol_table_resolve(cg->st, lhs, cg->func_scope_id);
 
     /* Typed dynamic array allocation: arr := new_arr(n)
        Works when arr is declared as dynamic array type: array[x] of T (array_size==0). */
@@ -1796,7 +1597,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
         int argc = args ? args->child_count : 0;
         if (fn && strcmp(fn, "new_arr") == 0 && argc == 1) {
             int r_n = cg_eval_expr(cg, args->children[0]);
-            int elem_sz = cg_type_size_bytes(sym->data_type);
+            int elem_sz = type_element(sym->dtype)->size;
             int r_ptr = cg_emit_new_arr(cg, r_n, elem_sz);
             /* store pointer into variable */
             if (sym->type == SYM_GLOBAL) {
@@ -1814,7 +1615,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
     int rv = -1;
     int r_tag = -1;
 
-    if (sym && sym->data_type && strcmp(sym->data_type, "din") == 0) {
+    if (cg_is_din(sym)) {
         /* Runtime-tagged din assignment */
         DinVal dv = cg_eval_din_expr(cg, rhs);
         rv = dv.v;
@@ -1826,7 +1627,7 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
 
     if (sym) {
         /* Dynamic variable: store <value, tag> as 8 bytes */
-        if (sym->data_type && strcmp(sym->data_type, "din") == 0) {
+        if (cg_is_din(sym)) {
 
             /* store value */
             if (sym->type == SYM_GLOBAL) {
@@ -1855,7 +1656,10 @@ static int cg_eval_assignment(CG* cg, const ASTNode* e) {
         }
 
         /* Normal store */
-        if (sym->type == SYM_GLOBAL) {
+        if (cg_promoted_reg(cg, sym) > 0) {
+            emit_store_symbol(cg, sym, rv);
+        }
+        else if (sym->type == SYM_GLOBAL) {
             emit_addr_abs(cg, sym);
             emit_ins2(cg, "ST", "r7", rname(rv));
         }
@@ -1880,6 +1684,14 @@ static void emit_function_prolog(CG* cg) {
         emit(cg, "    MOVI r7, #%d\n", frame);
         emit_ins3(cg, "SUB", "sp", "sp", "r7");
     }
+
+    /* promoted parameters: load once from the caller's argument slot */
+    for (int r = 1; r <= 6; r++) {
+        const Symbol* s = cg->promoted[r];
+        if (!s || s->type != SYM_PARAMETER) continue;
+        emit_addr_stack_sym(cg, s);
+        emit_ins2(cg, "LDS", rname(r), "r7");
+    }
 }
 
 static void emit_function_epilog(CG* cg) {
@@ -1888,7 +1700,11 @@ static void emit_function_epilog(CG* cg) {
     /* If function returns a value and there is an implicit return variable (e.g. 'result'),
        load it into r0 before tearing down the frame. */
     if (cg->has_return_value && cg->return_sym) {
-        if (cg->return_sym->type == SYM_GLOBAL) {
+        int rp = cg_promoted_reg(cg, cg->return_sym);
+        if (rp > 0) {
+            emit_ins2(cg, "MOV", "r0", rname(rp));
+        }
+        else if (cg->return_sym->type == SYM_GLOBAL) {
             emit_addr_abs(cg, cg->return_sym);
             emit_ins2(cg, "LD", "r0", "r7");
         }
@@ -1928,29 +1744,31 @@ static void emit_one_node(CG* cg, const CFGNode* n) {
     }
 
     if (n->type == CFG_ERROR) {
-        cg_comment(cg, "CFG_ERROR: %s", n->label ? n->label : "(no label)");
+        char buf[1024];
+        const char* label = cfg_node_label(cg->cfg, n, buf, sizeof(buf));
+        cg_comment(cg, "CFG_ERROR: %s", label ? label : "(no label)");
         if (n->defaultNext) emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
         return;
     }
 
+    /* операторы блока по порядку; у условия последнее выражение - переход */
+    int count = 0;
+    ASTNode** exprs = cfg_node_exprs(n, &count);
+
     if (n->type == CFG_CONDITION) {
         const char* t = n->conditionalNext ? cg_node_label(cg, n->conditionalNext) : cg_new_label(cg, "cond_true");
         const char* f = n->defaultNext ? cg_node_label(cg, n->defaultNext) : cg_new_label(cg, "cond_false");
 
-        const ASTNode* expr = (n->expr_tree_count > 0) ? n->expr_trees[0] : n->op_tree;
-        cg_emit_branch_on_expr(cg, expr, t, f);
-        return;
-    }
-
-    /* merge / block etc */
-    if (n->type == CFG_MERGE) {
-        if (n->defaultNext) {
-            emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
+        for (int i = 0; i + 1 < count; i++) {
+            int rv = cg_eval_expr(cg, exprs[i]);
+            reg_free(&cg->regs, rv);
         }
+        const ASTNode* expr = (count > 0) ? exprs[count - 1] : n->op_tree;
+        cg_emit_branch_on_expr(cg, expr, t, f);
         return;
     }
 
-    /* здесь обычные блоки */
+    /* здесь обычные блоки (merge, var decl и break - без операторов) */
     const ASTNode* stmt = n->ast_node;
 
     /* поддержка return на уровне AST (если CFG builder начнёт его создавать) */
@@ -1966,44 +1784,308 @@ static void emit_one_node(CG* cg, const CFGNode* n) {
         return;
     }
 
-    if (stmt && stmt->type == AST_VAR_DECLARATION) {
-        /* var decl: место в стеке уже зарезервировано в фрейме */
-        if (n->defaultNext) emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
-        return;
+    /* выражения; результат можно выкинуть */
+    for (int i = 0; i < count; i++) {
+        int rv = cg_eval_expr(cg, exprs[i]);
+        reg_free(&cg->regs, rv);
     }
 
-    if (n->is_break) {
-        /* break: просто переход */
-        if (n->defaultNext) emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
-        return;
+    if (n->defaultNext) {
+        emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
     }
+}
 
-    /* выражения */
-    if (n->expr_tree_count > 0 && n->expr_trees[0]) {
-        int rv = cg_eval_expr(cg, n->expr_trees[0]);
-        /* результат можно выкинуть */
-        reg_free(&cg->regs, rv);
+/* =========================
+ * Cost estimate (для оптимизаций по CFG)
+ * ========================= */
+
+int codegen_estimate_expr_cost(const ASTNode* e) {
+    if (!e) return 0;
+
+    switch (e->type) {
+    case AST_IDENTIFIER:
+        return 3;                       /* MOVI r7; SUB r7, fp, r7; LDS */
+
+    case AST_LITERAL: {
+        long long v = e->literal.value;
+        if (v >= 0 && v <= 65535) return 1;
+        return (v < 0 && -v <= 65535) ? 3 : 5;   /* MOVI; SUB | emit_load_u32 */
     }
 
-    if (n->defaultNext) {
-        emit(cg, "    JMP %s\n", cg_node_label(cg, n->defaultNext));
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+        return 1;
+
+    case AST_FLOAT_LITERAL:
+        return 5;                       /* emit_load_i32 */
+
+    case AST_UNARY_EXPR: {
+        int c = (e->child_count > 0) ? codegen_estimate_expr_cost(e->children[0]) : 1;
+        if (e->value && strcmp(e->value, "!") == 0) return c + 5;
+        if (e->value && strcmp(e->value, "+") == 0) return c;
+        return c + 1;
+    }
+
+    case AST_BINARY_EXPR:
+    case AST_ARITHMETIC_EXPR: {
+        int c = 0;
+        for (int i = 0; i < e->child_count; i++) c += codegen_estimate_expr_cost(e->children[i]);
+        const char* op = e->value ? e->value : "";
+        if (!strcmp(op, "==") || !strcmp(op, "!=") || !strcmp(op, "<") ||
+            !strcmp(op, "<=") || !strcmp(op, ">") || !strcmp(op, ">=")) {
+            return c + 5;               /* CMP, Jcc, MOVI, JMP, MOVI */
+        }
+        if (!strcmp(op, "&&") || !strcmp(op, "||")) return c + 8;
+        return c + 1;
+    }
+
+    case AST_INDEX_EXPR: {
+        int c = 0;
+        for (int i = 0; i < e->child_count; i++) c += codegen_estimate_expr_cost(e->children[i]);
+        return c + 4;                   /* MOV base, MOVI/SHL scale, SUB, LDS */
+    }
+
+    default: {
+        int c = 0;
+        for (int i = 0; i < e->child_count; i++) c += codegen_estimate_expr_cost(e->children[i]);
+        return c;
+    }
     }
 }
 
 /* =========================
- * Function emission
+ * Register promotion
+ *
+ * Scalars that escape analysis proved frame-local (address never taken,
+ * never stored outside the frame) are kept in r6, r5, ... for the whole
+ * function instead of being reloaded with LDS on every use. The number of
+ * pinned registers is limited so that the remaining pool still covers the
+ * expression with the highest register pressure in the function.
  * ========================= */
 
-static int cmp_node_id_ptr(const void* a, const void* b) {
-    const CFGNode* na = *(const CFGNode* const*)a;
-    const CFGNode* nb = *(const CFGNode* const*)b;
-    if (!na || !nb) return 0;
-    return (na->id < nb->id) ? -1 : (na->id > nb->id ? 1 : 0);
+static int cg_expr_pressure(const ASTNode* e);
+
+/* pressure of e while `held` registers are already live (calls spill them) */
+static int cg_expr_pressure_held(const ASTNode* e, int held) {
+    int p = cg_expr_pressure(e);
+    if (e && e->type == AST_CALL_EXPR) return p;
+    return p + held;
+}
+
+/* element access: address register + index/rhs + scale temp */
+static int cg_addr_pressure(const ASTNode* e) {
+    int need = 3;
+    for (int i = 0; i < e->child_count; i++) {
+        int c = cg_expr_pressure_held(e->children[i], 1);
+        if (c > need) need = c;
+    }
+    return need;
+}
+
+/* upper bound of r1..r6 needed by cg_eval_expr(e) */
+static int cg_expr_pressure(const ASTNode* e) {
+    if (!e) return 1;
+
+    switch (e->type) {
+    case AST_IDENTIFIER:
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+        return 1;
+
+    case AST_LITERAL: {
+        long long v = e->literal.value;
+        if (v >= 0 && v <= 65535) return 1;
+        if (v < 0 && -v <= 65535) return 2;
+        return 3;                       /* emit_load_u32 */
+    }
+
+    case AST_FLOAT_LITERAL:
+        /* emit_load_u32 may need two temporaries */
+        return 3;
+
+    case AST_UNARY_EXPR:
+    case AST_DEREF:
+    case AST_ADDR_OF:
+        return (e->child_count > 0) ? cg_expr_pressure(e->children[0]) : 1;
+
+    case AST_BINARY_EXPR:
+    case AST_ARITHMETIC_EXPR: {
+        int l = (e->child_count > 0) ? cg_expr_pressure(e->children[0]) : 1;
+        int r = (e->child_count > 1) ? cg_expr_pressure_held(e->children[1], 1) : 2;
+        int need = (l > r) ? l : r;
+        if (e->value && (!strcmp(e->value, "&&") || !strcmp(e->value, "||"))) need++;
+        return need;
+    }
+
+    case AST_ASSIGNMENT:
+        /* scalar store needs only the value register */
+        if (e->child_count > 1 && e->children[0] && e->children[0]->type == AST_IDENTIFIER) {
+            return cg_expr_pressure(e->children[1]);
+        }
+        return cg_addr_pressure(e);
+
+    case AST_INDEX_EXPR:
+        return cg_addr_pressure(e);
+
+    case AST_CALL_EXPR: {
+        /* caller-saved regs are freed during arg-eval, new_arr needs 3 */
+        const ASTNode* callee = (e->child_count > 0) ? e->children[0] : NULL;
+        int need = (callee && callee->value && strcmp(callee->value, "new_arr") == 0) ? 3 : 1;
+        const ASTNode* args = (e->child_count > 1) ? e->children[1] : NULL;
+        for (int i = 0; args && i < args->child_count; i++) {
+            int c = cg_expr_pressure(args->children[i]);
+            if (c > need) need = c;
+        }
+        return need;
+    }
+
+    case AST_STATEMENT_LIST: {
+        int need = 1;
+        for (int i = 0; i < e->child_count; i++) {
+            int c = cg_expr_pressure(e->children[i]);
+            if (c > need) need = c;
+        }
+        return need;
+    }
+
+    default:
+        return 6;
+    }
+}
+
+/* upper bound of r1..r6 needed by cg_eval_din_expr(e): value and tag included */
+static int cg_din_pressure(const CG* cg, const ASTNode* e) {
+    if (!e) return 2;
+
+    if (e->type == AST_IDENTIFIER && e->value
+        && cg_is_din(symbol_table_resolve(cg->st, e, cg->func_scope_id))) {
+        return 3;                       /* value, tag, tag address */
+    }
+    if (e->type == AST_FLOAT_LITERAL) return 4;    /* value, tag + emit_load_i32 */
+
+    if (e->type == AST_UNARY_EXPR && e->value && e->child_count > 0) {
+        return cg_din_pressure(cg, e->children[0]);
+    }
+    if ((e->type == AST_BINARY_EXPR || e->type == AST_ARITHMETIC_EXPR) && e->value && e->child_count >= 2) {
+        int need = cg_din_pressure(cg, e->children[0]);
+        int r = 2 + cg_din_pressure(cg, e->children[1]);
+        if (r > need) need = r;
+        return need > 5 ? need : 5;     /* both operands + shift temp */
+    }
+
+    /* evaluated as int, then the tag */
+    int p = cg_expr_pressure(e);
+    return p > 2 ? p : 2;
 }
 
-static int emit_function(CG* cg, const FunctionInfo* fn) {
+/* assignments to din cells in e are evaluated by cg_eval_din_expr */
+static int cg_din_assign_pressure(const CG* cg, const ASTNode* e) {
+    if (!e) return 0;
+    int need = 0;
+    if (e->type == AST_ASSIGNMENT && e->child_count > 1 && e->children[0]
+        && e->children[0]->type == AST_IDENTIFIER
+        && cg_is_din(symbol_table_resolve(cg->st, e->children[0], cg->func_scope_id))) {
+        need = cg_din_pressure(cg, e->children[1]);
+        if (need < 3) need = 3;         /* value, tag, tag address at the store */
+    }
+    for (int i = 0; i < e->child_count; i++) {
+        int c = cg_din_assign_pressure(cg, e->children[i]);
+        if (c > need) need = c;
+    }
+    return need;
+}
+
+static void cg_count_uses(CG* cg, const ASTNode* e, int* uses) {
+    if (!e) return;
+    if (e->type == AST_IDENTIFIER && e->value) {
+        const Symbol* s = symbol_table_resolve(cg->st, e, cg->func_scope_id);
+        if (s) uses[s - cg->st->symbols]++;
+    }
+    for (int i = 0; i < e->child_count; i++) {
+        cg_count_uses(cg, e->children[i], uses);
+    }
+}
+
+/* din cells are <value, tag> pairs in memory - they stay on the stack */
+static int cg_is_promotable(const Symbol* s, const Scope* func_scope) {
+    if (!symbol_is_stack_resident(s)) return 0;
+    if (!scope_contains(func_scope, s->scope)) return 0;
+    if (s->is_address_taken || s->escapes) return 0;
+    if (s->is_array || cg_is_din(s)) return 0;
+    if (!s->dtype || s->dtype->kind == TYPE_UNKNOWN) return 0;
+    if (s->dtype->size != 4) return 0;
+    return 1;
+}
+
+static void cg_select_promoted(CG* cg) {
+    memset(cg->promoted, 0, sizeof(cg->promoted));
+    memset(cg->regs.pinned, 0, sizeof(cg->regs.pinned));
+
+    if (!cg->opt.promote_registers || !cg->st || !cg->st->escape_analyzed) return;
+
+    Scope* func_scope = symbol_table_scope(cg->st, cg->func_scope_id);
+    if (!func_scope || cg->st->symbol_count == 0) return;
+
+    /* кандидаты - только символы областей функции */
+    int nsyms = 0;
+    int* syms = symbol_table_scope_symbols(cg->st, func_scope, &nsyms);
+    if (!syms) return;
+
+    int* uses = (int*)calloc((size_t)cg->st->symbol_count, sizeof(int));
+    if (!uses) {
+        free(syms);
+        return;
+    }
+
+    int pressure = 1;
+    for (int i = cg->fn->first_node; i < cg->fn->end_node; i++) {
+        if (!cfg_function_reaches(cg->fn, i)) continue;
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(cg->cfg->nodes[i], &count);
+        for (int j = 0; j < count; j++) {
+            int p = cg_expr_pressure(exprs[j]);
+            if (p > pressure) pressure = p;
+            p = cg_din_assign_pressure(cg, exprs[j]);
+            if (p > pressure) pressure = p;
+            cg_count_uses(cg, exprs[j], uses);
+        }
+    }
+
+    int slots = 6 - pressure;
+
+    for (int k = 0; k < slots; k++) {
+        int best = -1;
+        for (int j = 0; j < nsyms; j++) {
+            int i = syms[j];
+            const Symbol* s = &cg->st->symbols[i];
+            if (uses[i] == 0 || cg_promoted_reg(cg, s) > 0) continue;
+            if (!cg_is_promotable(s, func_scope)) continue;
+            if (best < 0 || uses[i] > uses[best]) best = i;
+        }
+        if (best < 0) break;
+
+        int r = 6 - k;
+        cg->promoted[r] = &cg->st->symbols[best];
+        cg->regs.pinned[r] = 1;
+    }
+
+    free(uses);
+    free(syms);
+}
+
+/* =========================
+ * Function emission
+ * ========================= */
+
+static int emit_function(CG* cg, const CFGFunction* fn) {
     if (!cg || !fn || !fn->entry) return 0;
 
+    int range = fn->end_node - fn->first_node;
+    cg_node_labels_free(cg);
+    cg->fn = fn;
+    cg->node_label_map = (char**)calloc((size_t)(range > 0 ? range : 1), sizeof(char*));
+    if (!cg->node_label_map) return 0;
+
     snprintf(cg->func_name, sizeof(cg->func_name), "%s", fn->name);
     cg->func_scope_id = fn->scope_id;
     cg->label_seq = 0;
@@ -2015,40 +2097,33 @@ static int emit_function(CG* cg, const FunctionInfo* fn) {
     cg->return_sym = NULL;
     cg->has_return_value = 0;
     if (cg->st) {
-        for (int i = 0; i < cg->st->symbol_count; i++) {
-            Symbol* s = (Symbol*)&cg->st->symbols[i];
-            if (s->type == SYM_FUNCTION && s->name && strcmp(s->name, cg->func_name) == 0) {
-                cg->func_sym = s;
-                if (s->return_type && strcmp(s->return_type, "void") != 0) {
-                    cg->has_return_value = 1;
-                }
-                break;
+        if (fn->symbol >= 0 && fn->symbol < cg->st->symbol_count) {
+            const Symbol* s = &cg->st->symbols[fn->symbol];
+            cg->func_sym = s;
+            if (s->dtype && s->dtype->kind == TYPE_FUNCTION && s->dtype->ret->kind != TYPE_VOID) {
+                cg->has_return_value = 1;
             }
         }
         if (cg->has_return_value) {
-            cg->return_sym = cg_lookup_symbol((SymbolTable*)cg->st, "result", cg->func_scope_id);
+            cg->return_sym = symbol_table_lookup_in_scope(cg->st, "result", cg->func_scope_id);
             if (!cg->return_sym) {
-                cg->return_sym = cg_lookup_symbol((SymbolTable*)cg->st, cg->func_name, cg->func_scope_id);
+                cg->return_sym = symbol_table_lookup_in_scope(cg->st, cg->func_name, cg->func_scope_id);
             }
         }
     }
 
-    mark_reachable(cg, fn->entry);
-
-    /* собрать список reachable nodes */
-    int ncount = 0;
-    for (int i = 0; i < cg->cfg->node_count; i++) {
-        if (cg->reachable[i]) ncount++;
-    }
+    cg_select_promoted(cg);
+    reg_init(&cg->regs);
 
-    const CFGNode** nodes = (const CFGNode**)malloc((size_t)ncount * sizeof(CFGNode*));
+    /* reachable nodes - из обхода cfg_finalize, по возрастанию id */
+    int ncount = fn->reachable_count;
+    const CFGNode** nodes = (const CFGNode**)malloc((size_t)(ncount > 0 ? ncount : 1) * sizeof(CFGNode*));
     if (!nodes) return 0;
 
     int k = 0;
-    for (int i = 0; i < cg->cfg->node_count; i++) {
-        if (cg->reachable[i]) nodes[k++] = cg->cfg->nodes[i];
+    for (int i = fn->first_node; i < fn->end_node && k < ncount; i++) {
+        if (cfg_function_reaches(fn, i)) nodes[k++] = cg->cfg->nodes[i];
     }
-    qsort(nodes, (size_t)ncount, sizeof(CFGNode*), cmp_node_id_ptr);
 
     /* function label */
     {
@@ -2058,13 +2133,18 @@ static int emit_function(CG* cg, const FunctionInfo* fn) {
     }
 
     cg_comment(cg, "CFG nodes reachable: %d", ncount);
+    for (int r = 1; r <= 6; r++) {
+        if (cg->promoted[r]) cg_comment(cg, "%s promoted to %s", cg->promoted[r]->name, rname(r));
+    }
 
     /* emit each node with its internal label */
     for (int i = 0; i < ncount; i++) {
         const CFGNode* n = nodes[i];
         emit_label(cg, cg_node_label(cg, n));
-        if (cg->opt.emit_comments && n->label) {
-            cg_comment(cg, "node %d: %s", n->id, n->label);
+        if (cg->opt.emit_comments) {
+            char buf[1024];
+            const char* label = cfg_node_label(cg->cfg, n, buf, sizeof(buf));
+            if (label) cg_comment(cg, "node %d: %s", n->id, label);
         }
         emit_one_node(cg, n);
         emit(cg, "\n");
@@ -2086,60 +2166,180 @@ CodegenOptions codegen_default_options(void) {
     CodegenOptions o;
     o.emit_comments = 1;
     o.emit_start_stub = 1;
+    o.promote_registers = 1;
+    o.workers = 0;
     return o;
 }
 
-int codegen_generate_stream(const CFG* cfg, const SymbolTable* st, FILE* out, CodegenOptions opt) {
-    if (!cfg || !out) return 0;
+/* заголовок модуля: секция кода и (по опции) точка входа _start */
+static void cg_append_prologue(Str* out, CodegenOptions opt) {
+    sb_append(out, "; ---- Noobik assembly generated from CFG ----\n\n");
+    sb_append(out, "[section cram]\n\n");
+
+    if (opt.emit_start_stub) {
+        sb_append(out, "_start:\n");
+        sb_append(out, "    MOVI sp, #0xFFFC\n");
+        sb_append(out, "    MOVI fp, #0xFFFC\n");
+        sb_append(out, "    CALL _func_main\n");
+        sb_append(out, "    HLT\n\n");
+    }
+}
 
-    FunctionInfo* funcs = NULL;
-    int fcount = 0;
-    if (!collect_functions(cfg, &funcs, &fcount)) return 0;
+static void cg_append_epilogue(Str* out) {
+    sb_append(out, "[section name=dram, bank=dram, start=0x8000]\n");
+}
 
+/* одна функция в отдельном контексте (свои метки, регистры) */
+static int cg_generate_one_function(const CFG* cfg, const SymbolTable* st, CodegenOptions opt,
+    const CFGFunction* fn, Str* out) {
     CG cg;
     memset(&cg, 0, sizeof(cg));
     cg.cfg = cfg;
     cg.st = st;
     cg.opt = opt;
-    sb_init(&cg.out);
+    cg.out = *out;
 
     cg_labels_init(&cg);
+    int ok = emit_function(&cg, fn);
+    *out = cg.out;
 
-    cg.reachable = (unsigned char*)malloc((size_t)cfg->node_count);
-    if (!cg.reachable) {
-        free(funcs);
-        sb_free(&cg.out);
+    cg_labels_free(&cg);
+    return ok;
+}
+
+typedef struct {
+    const CFG* cfg;
+    const SymbolTable* st;
+    CodegenOptions opt;
+    const CFGFunction* funcs;
+    Str* texts;                 /* текст каждой функции */
+    int* ok;
+} CGParallelJob;
+
+static void cg_function_task(void* arg, int index) {
+    CGParallelJob* job = (CGParallelJob*)arg;
+    job->ok[index] = cg_generate_one_function(job->cfg, job->st, job->opt,
+        &job->funcs[index], &job->texts[index]);
+}
+
+/* функции генерируются параллельно и склеиваются в порядке cfg->functions -
+   результат совпадает с последовательным байт в байт */
+static int cg_generate_functions_parallel(const CFG* cfg, const SymbolTable* st, CodegenOptions opt,
+    const CFGFunction* funcs, int fcount, Str* out) {
+    Str* texts = (Str*)calloc((size_t)fcount, sizeof(Str));
+    int* ok = (int*)calloc((size_t)fcount, sizeof(int));
+    Scheduler* sched = scheduler_create(opt.workers < fcount ? opt.workers : fcount);
+    if (!texts || !ok || !sched) {
+        free(texts);
+        free(ok);
+        scheduler_free(sched);
         return 0;
     }
 
-    /* header */
-    sb_append(&cg.out, "; ---- Noobik assembly generated from CFG ----\n\n");
-    sb_append(&cg.out, "[section cram]\n\n");
+    CGParallelJob job;
+    job.cfg = cfg;
+    job.st = st;
+    job.opt = opt;
+    job.funcs = funcs;
+    job.texts = texts;
+    job.ok = ok;
+    scheduler_parallel_for(sched, fcount, cg_function_task, &job);
+    scheduler_free(sched);
 
-    if (opt.emit_start_stub) {
-        sb_append(&cg.out, "_start:\n");
-        sb_append(&cg.out, "    MOVI sp, #0xFFFC\n");
-        sb_append(&cg.out, "    MOVI fp, #0xFFFC\n");
-        sb_append(&cg.out, "    CALL _func_main\n");
-        sb_append(&cg.out, "    HLT\n\n");
+    int all_ok = 1;
+    for (int i = 0; i < fcount; i++) {
+        if (!ok[i]) all_ok = 0;
+        if (texts[i].buf) sb_append(out, texts[i].buf);
+        sb_free(&texts[i]);
     }
+    free(texts);
+    free(ok);
+    return all_ok;
+}
 
-    for (int i = 0; i < fcount; i++) {
-        emit_function(&cg, &funcs[i]);
+/* код всех функций CFG (без заголовка) в out */
+static int cg_generate_functions(const CFG* cfg, const SymbolTable* st, CodegenOptions opt, Str* out) {
+    const CFGFunction* funcs = cfg->functions;
+    int fcount = cfg->function_count;
+
+    if (opt.workers != 1 && fcount > 1) {
+        return cg_generate_functions_parallel(cfg, st, opt, funcs, fcount, out);
     }
 
-    sb_append(&cg.out, "[section name=dram, bank=dram, start=0x8000]\n");
+    CG cg;
+    memset(&cg, 0, sizeof(cg));
+    cg.cfg = cfg;
+    cg.st = st;
+    cg.opt = opt;
+    cg.out = *out;
+
+    cg_labels_init(&cg);
 
-    int ok = 1;
-    if (cg.out.buf) {
-        if (fwrite(cg.out.buf, 1, cg.out.len, out) != cg.out.len) ok = 0;
+    int all_ok = 1;
+    for (int i = 0; i < fcount; i++) {
+        if (!emit_function(&cg, &funcs[i])) all_ok = 0;
     }
 
+    *out = cg.out;
+
     cg_labels_free(&cg);
+    return all_ok;
+}
+
+static int cg_write_str(const Str* s, FILE* out) {
+    if (!s->buf) return 1;
+    return fwrite(s->buf, 1, s->len, out) == s->len;
+}
+
+int codegen_generate_stream(const CFG* cfg, const SymbolTable* st, FILE* out, CodegenOptions opt) {
+    if (!cfg || !out) return 0;
+
+    Str text;
+    sb_init(&text);
+
+    cg_append_prologue(&text, opt);
+    if (!cg_generate_functions(cfg, st, opt, &text)) {
+        sb_free(&text);
+        return 0;
+    }
+    cg_append_epilogue(&text);
+
+    int ok = cg_write_str(&text, out);
+    sb_free(&text);
+    return ok;
+}
+
+char* codegen_generate_functions(const CFG* cfg, const SymbolTable* st, CodegenOptions opt, size_t* out_len) {
+    if (out_len) *out_len = 0;
+    if (!cfg) return NULL;
+
+    Str text;
+    sb_init(&text);
+    if (!cg_generate_functions(cfg, st, opt, &text) || !sb_reserve(&text, 0)) {
+        sb_free(&text);
+        return NULL;
+    }
+    if (out_len) *out_len = text.len;
+    return text.buf;
+}
+
+int codegen_write_prologue(FILE* out, CodegenOptions opt) {
+    if (!out) return 0;
+    Str text;
+    sb_init(&text);
+    cg_append_prologue(&text, opt);
+    int ok = cg_write_str(&text, out);
+    sb_free(&text);
+    return ok;
+}
 
-    free(cg.reachable);
-    free(funcs);
-    sb_free(&cg.out);
+int codegen_write_epilogue(FILE* out) {
+    if (!out) return 0;
+    Str text;
+    sb_init(&text);
+    cg_append_epilogue(&text);
+    int ok = cg_write_str(&text, out);
+    sb_free(&text);
     return ok;
 }
 
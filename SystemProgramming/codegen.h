@@ -12,6 +12,9 @@ extern "C" {
     typedef struct {
         int emit_comments;      /* 1: добавлять комментарии в asm */
         int emit_start_stub;    /* 1: добавить _start: CALL _func_main; HLT */
+        int promote_registers;  /* 1: держать неубегающие скаляры в r5/r6 (нужен escape_analyze) */
+        int workers;            /* потоков для генерации функций: 1 - последовательно,
+                                   0 - по числу CPU; вывод от этого не зависит */
     } CodegenOptions;
 
     CodegenOptions codegen_default_options(void);
@@ -26,6 +29,18 @@ extern "C" {
         const char* output_path,
         CodegenOptions opt);
 
+    /* Раздельная генерация для сборки одного asm из нескольких CFG:
+       prologue, затем код функций каждого CFG в нужном порядке, затем epilogue.
+       codegen_generate_functions возвращает malloc-строку (NULL = error). */
+    int codegen_write_prologue(FILE* out, CodegenOptions opt);
+    char* codegen_generate_functions(const CFG* cfg, const SymbolTable* st,
+        CodegenOptions opt, size_t* out_len);
+    int codegen_write_epilogue(FILE* out);
+
+    /* Оценка числа инструкций, которые codegen выдаст для выражения
+       (переменные считаются лежащими в стеке) */
+    int codegen_estimate_expr_cost(const ASTNode* e);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,290 @@
+﻿#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "parser.tab.h"
+#include "lexer.h"
+#include "sccp.h"
+#include "cse.h"
+#include "dse.h"
+#include "framelayout.h"
+#include "trace.h"
+
+CompilerContext* compiler_context_create(const char* source_name) {
+    CompilerContext* ctx = (CompilerContext*)calloc(1, sizeof(CompilerContext));
+    if (!ctx) return NULL;
+    ctx->source_name = strdup(source_name ? source_name : "<input>");
+    ctx->line_num = 1;
+    ctx->file_id = SOURCE_NO_FILE;
+    ctx->sources = source_manager_create();
+    if (!ctx->sources) {
+        free(ctx->source_name);
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void compiler_context_free(CompilerContext* ctx) {
+    if (!ctx) return;
+    if (ctx->cfg) cfg_free(ctx->cfg);
+    if (ctx->root_ast) freeAST(ctx->root_ast);
+    if (ctx->escape_info) escape_free(ctx->escape_info);
+    if (ctx->symbol_table) symbol_table_free(ctx->symbol_table);
+    source_manager_free(ctx->sources);
+    free(ctx->source_name);
+    free(ctx);
+}
+
+/* Разбор файла file из ctx->sources; буфер остаётся в менеджере -
+   на него ссылаются span узлов AST */
+static int compiler_parse_source(CompilerContext* ctx, int file) {
+    Lexer* scanner = lexer_create(ctx, file);
+    if (!scanner) {
+        fprintf(stderr, "[ERROR] Cannot initialize scanner for %s\n", ctx->source_name);
+        return 0;
+    }
+
+    ctx->file_id = file;
+    ctx->line_num = 1;
+    ctx->parse_failed = 0;
+    int parse_result = yyparse(scanner, ctx);
+    lexer_free(scanner);
+
+    return parse_result == 0 && !ctx->parse_failed && ctx->root_ast != NULL;
+}
+
+int compiler_parse(CompilerContext* ctx, FILE* input) {
+    if (!ctx || !input) return 0;
+
+    int file = source_manager_add_stream(ctx->sources, ctx->source_name, input);
+    if (file < 0) {
+        fprintf(stderr, "[ERROR] Cannot read %s\n", ctx->source_name);
+        return 0;
+    }
+    return compiler_parse_source(ctx, file);
+}
+
+int compiler_parse_file(CompilerContext* ctx, const char* path) {
+    if (!ctx || !path) return 0;
+
+    int file = source_manager_open(ctx->sources, path);
+    if (file < 0) {
+        fprintf(stderr, "[ERROR] Cannot open input file: %s\n", path);
+        return 0;
+    }
+    return compiler_parse_source(ctx, file);
+}
+
+int compiler_analyze(CompilerContext* ctx) {
+    if (!ctx || !ctx->root_ast) return 0;
+
+    ctx->symbol_table = symbol_table_create();
+    if (!ctx->symbol_table) return 0;
+    semantic_analyze_parallel(ctx->root_ast, ctx->symbol_table, ctx->scheduler);
+
+    ctx->escape_info = escape_analyze(ctx->root_ast, ctx->symbol_table);
+    return 1;
+}
+
+int compiler_build_cfg(CompilerContext* ctx) {
+    if (!ctx || !ctx->root_ast || !ctx->symbol_table) return 0;
+
+    ctx->cfg = cfg_create();
+    if (!ctx->cfg) return 0;
+    cfg_set_symbol_table(ctx->cfg, ctx->symbol_table);
+    cfg_build_from_ast(ctx->cfg, ctx->root_ast);
+    return 1;
+}
+
+void compiler_run_passes(CFG* cfg, SymbolTable* st) {
+    if (!cfg || !st) return;
+
+    SCCPStats sccp_stats = sccp_run(cfg, st);
+    sccp_print_stats(&sccp_stats);
+
+    CSEStats cse_stats = cse_run(cfg, st);
+    cse_print_stats(&cse_stats);
+
+    DSEStats dse_stats = dse_run(cfg, st);
+    dse_print_stats(&dse_stats);
+
+    FrameLayoutStats frame_stats = frame_layout_run(cfg, st);
+    frame_layout_print_stats(&frame_stats);
+}
+
+void compiler_optimize(CompilerContext* ctx) {
+    if (!ctx) return;
+    compiler_run_passes(ctx->cfg, ctx->symbol_table);
+}
+
+int compiler_emit_asm(CompilerContext* ctx, const char* output_path, CodegenOptions opt) {
+    if (!ctx || !ctx->cfg || !ctx->symbol_table || !output_path) return 0;
+    return codegen_generate_file(ctx->cfg, ctx->symbol_table, output_path, opt);
+}
+
+/* =========================
+ * Потоковая компиляция
+ * ========================= */
+
+struct CompilerStream {
+    FILE* out;
+    CodegenOptions opt;
+
+    ASTNode** pending;          /* funcDef, ждущие объявления вызываемых */
+    int pending_count;
+    int pending_cap;
+
+    ASTNode* unit;              /* AST_PROGRAM с одной функцией для escape_analyze */
+    int functions;              /* функций сгенерировано */
+    int errors;                 /* ошибок семантики и CFG */
+    int write_failed;
+};
+
+/* Все ли функции, вызываемые в поддереве, уже объявлены */
+static int stream_callees_declared(SymbolTable* st, const ASTNode* n) {
+    if (!n) return 1;
+    if (n->type == AST_CALL_EXPR && n->value) {
+        Symbol* sym = symbol_table_lookup_global(st, n->value);
+        if (!sym || sym->type != SYM_FUNCTION) return 0;
+    }
+    for (int i = 0; i < n->child_count; i++) {
+        if (!stream_callees_declared(st, n->children[i])) return 0;
+    }
+    return 1;
+}
+
+static int stream_count_ast_errors(const ASTNode* n) {
+    if (!n) return 0;
+    int count = (n->has_error && n->error_message) ? 1 : 0;
+    for (int i = 0; i < n->child_count; i++) count += stream_count_ast_errors(n->children[i]);
+    return count;
+}
+
+/* semantic -> escape -> CFG -> оптимизации -> asm одной функции, затем освобождение */
+static void stream_compile_function(CompilerContext* ctx, ASTNode* func_def) {
+    struct CompilerStream* s = ctx->stream;
+    SymbolTable* st = ctx->symbol_table;
+
+    int errors_before = st->error_count;
+    semantic_analyze_function(func_def, st);
+    s->errors += st->error_count - errors_before + stream_count_ast_errors(func_def);
+
+    s->unit->children[0] = func_def;
+    s->unit->child_count = 1;
+    EscapeInfo* escape_info = escape_analyze(s->unit, st);
+    escape_free(escape_info);
+    s->unit->child_count = 0;
+
+    CFG* cfg = cfg_create();
+    if (cfg) {
+        cfg_set_symbol_table(cfg, st);
+        cfg_build_function(cfg, func_def);
+
+        /* у forward-объявления CFG пуст */
+        if (cfg->node_count > 0) {
+            for (int i = 0; i < cfg->node_count; i++) {
+                if (cfg->nodes[i]->has_error) s->errors++;
+            }
+
+            compiler_run_passes(cfg, st);
+
+            size_t len = 0;
+            char* text = codegen_generate_functions(cfg, st, s->opt, &len);
+            if (!text || fwrite(text, 1, len, s->out) != len) s->write_failed = 1;
+            free(text);
+            s->functions++;
+        }
+        cfg_free(cfg);
+    }
+    else {
+        s->write_failed = 1;
+    }
+
+    freeAST(func_def);
+}
+
+/* Компилирует готовые к этому функции в порядке поступления;
+   force - все оставшиеся (конец файла: необъявленные вызовы станут ошибками) */
+static void stream_flush(CompilerContext* ctx, int force) {
+    struct CompilerStream* s = ctx->stream;
+    int kept = 0;
+    for (int i = 0; i < s->pending_count; i++) {
+        ASTNode* func_def = s->pending[i];
+        if (force || stream_callees_declared(ctx->symbol_table, func_def)) {
+            stream_compile_function(ctx, func_def);
+        }
+        else {
+            s->pending[kept++] = func_def;
+        }
+    }
+    s->pending_count = kept;
+}
+
+void compiler_stream_function(CompilerContext* ctx, ASTNode* func_def) {
+    if (!ctx || !ctx->stream || !func_def) return;
+    struct CompilerStream* s = ctx->stream;
+
+    /* сигнатура известна сразу - от неё могут зависеть ждущие функции */
+    semantic_declare_function(func_def, ctx->symbol_table);
+
+    if (s->pending_count >= s->pending_cap) {
+        int cap = s->pending_cap ? s->pending_cap * 2 : 8;
+        ASTNode** p = (ASTNode**)realloc(s->pending, (size_t)cap * sizeof(ASTNode*));
+        if (!p) {
+            freeAST(func_def);
+            s->write_failed = 1;
+            return;
+        }
+        s->pending = p;
+        s->pending_cap = cap;
+    }
+    s->pending[s->pending_count++] = func_def;
+
+    stream_flush(ctx, 0);
+}
+
+int compiler_compile_stream(CompilerContext* ctx, FILE* input,
+    const char* output_path, CodegenOptions opt) {
+    if (!ctx || !input || !output_path) return 0;
+
+    ctx->symbol_table = symbol_table_create();
+    if (!ctx->symbol_table) return 0;
+    ctx->symbol_table->debug_enabled = TRACE_ON(TRACE_SEMANTIC, TRACE_DEBUG);
+
+    struct CompilerStream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.opt = opt;
+    stream.opt.workers = 1;     /* в CFG одна функция */
+    stream.unit = createASTNode(AST_PROGRAM, "Program", 0);
+    stream.unit->children = (ASTNode**)malloc(sizeof(ASTNode*));
+    stream.out = fopen(output_path, "wb");
+    if (!stream.out || !stream.unit->children) {
+        if (stream.out) fclose(stream.out);
+        freeAST(stream.unit);
+        return 0;
+    }
+
+    int ok = codegen_write_prologue(stream.out, opt);
+
+    ctx->stream = &stream;
+    int parsed = compiler_parse(ctx, input);
+    if (parsed) {
+        stream_flush(ctx, 1);
+        semantic_finish(ctx->symbol_table);
+    }
+    else {
+        for (int i = 0; i < stream.pending_count; i++) freeAST(stream.pending[i]);
+    }
+    ctx->stream = NULL;
+
+    ok = ok && parsed && !stream.write_failed && codegen_write_epilogue(stream.out);
+    fclose(stream.out);
+    /* ошибки семантики и CFG - неудача, даже если asm записан целиком */
+    ok = ok && stream.errors == 0;
+
+    printf("[+] Streamed %d function(s), %d error(s)\n", stream.functions, stream.errors);
+
+    free(stream.pending);
+    freeAST(stream.unit);
+    return ok;
+}
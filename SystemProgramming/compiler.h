@@ -0,0 +1,99 @@
+﻿#pragma once
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stdio.h>
+#include "ast.h"
+#include "source.h"
+#include "semantic.h"
+#include "escape.h"
+#include "cfg.h"
+#include "codegen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Контекст компиляции одного исходного файла.
+     *
+     * Владеет всем состоянием конвейера: исходники (source.h), номер строки
+     * разбора, AST, таблица символов, результат escape-анализа, CFG. Парсер (bison, api.pure) и
+     * сканер (lexer.c) получают контекст параметром, построитель CFG
+     * держит своё состояние в самом CFG - глобальных переменных нет.
+     * Поэтому разные контексты можно обрабатывать в разных потоках
+     * одновременно; один контекст - только в одном потоке.
+     *
+     * Стадии вызываются по порядку:
+     *   compiler_parse -> compiler_analyze -> compiler_build_cfg
+     *   -> compiler_optimize -> compiler_emit_asm
+     * Каждая возвращает 1 при успехе, 0 при ошибке (кроме compiler_optimize).
+     *
+     * Потоковый режим (compiler_compile_stream) проходит те же стадии по
+     * одной функции: парсер отдаёт каждый свёрнутый funcDef в конвейер,
+     * функция анализируется, оптимизируется, её asm сразу пишется в файл,
+     * а AST и CFG освобождаются. Пиковая память - одна функция (плюс
+     * таблица символов), а не вся программа.
+     */
+
+    struct CompilerStream;
+
+    typedef struct CompilerContext {
+        char* source_name;          /* имя файла (для сообщений) */
+        SourceManager* sources;     /* буферы исходников - на них ссылаются span */
+        int file_id;                /* разбираемый файл в sources */
+        int line_num;               /* текущая строка сканера */
+        int parse_failed;           /* yyerror был вызван */
+
+        ASTNode* root_ast;
+        SymbolTable* symbol_table;
+        EscapeInfo* escape_info;
+        CFG* cfg;
+
+        struct CompilerStream* stream;  /* не NULL: потоковый режим */
+        struct Scheduler* scheduler;    /* не NULL: тела функций анализируются параллельно
+                                           (не владеет; NULL внутри задач project.c) */
+    } CompilerContext;
+
+    CompilerContext* compiler_context_create(const char* source_name);
+    void compiler_context_free(CompilerContext* ctx);
+
+    /* Разбор потока в ctx->root_ast */
+    int compiler_parse(CompilerContext* ctx, FILE* input);
+
+    /* Разбор файла по пути (отображается в память без копирования) */
+    int compiler_parse_file(CompilerContext* ctx, const char* path);
+
+    /* Таблица символов, семантический анализ, escape-анализ */
+    int compiler_analyze(CompilerContext* ctx);
+
+    /* Построение CFG и проверка выражений в его узлах */
+    int compiler_build_cfg(CompilerContext* ctx);
+
+    /* Оптимизации по CFG: SCCP -> CSE -> DSE -> раскладка кадра */
+    void compiler_optimize(CompilerContext* ctx);
+
+    /* Тот же конвейер оптимизаций для произвольного CFG (например, CFG
+       одной функции в project.c); st - таблица символов его исходного файла */
+    void compiler_run_passes(CFG* cfg, SymbolTable* st);
+
+    /* Генерация asm NOOBIK в файл */
+    int compiler_emit_asm(CompilerContext* ctx, const char* output_path, CodegenOptions opt);
+
+    /* Потоковая компиляция потока сразу в asm. Функция уходит в конвейер,
+       как только объявлены все вызываемые ею функции (builtins, forward-
+       объявления, ранее разобранные определения); до этого её AST ждёт.
+       Escape-анализ при этом локален для функции: вызов другой функции
+       считается вызовом неизвестной (аргументы убегают). */
+    int compiler_compile_stream(CompilerContext* ctx, FILE* input,
+        const char* output_path, CodegenOptions opt);
+
+    /* Вызывается парсером в потоковом режиме для каждого funcDef;
+       владение func_def переходит конвейеру */
+    void compiler_stream_function(CompilerContext* ctx, ASTNode* func_def);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,645 @@
+﻿#include "cse.h"
+#include "liveness.h"
+#include "dataflow.h"
+#include "codegen.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================
+ * State
+ * ========================= */
+
+typedef enum {
+    CSE_COLLECT,    /* собрать классы выражений */
+    CSE_LOCAL,      /* GEN/KILL узла */
+    CSE_COUNT,      /* посчитать повторные вычисления */
+    CSE_REWRITE     /* заменить повторные вычисления временными */
+} CSEMode;
+
+typedef struct {
+    char* key;
+    int* deps;              /* символы: скаляры, ссылки на динамические массивы, частные массивы */
+    int dep_count;
+    int aliased;            /* читает общую память (массивы, видимые снаружи) */
+    int cost;               /* оценка инструкций одного вычисления */
+    int redundant;
+    int generated;
+    int temp;               /* 1 - заведена временная */
+    int temp_symbol;        /* её индекс в st->symbols (ASTNode.symbol) */
+    char temp_name[24];
+} CSEClass;
+
+typedef struct {
+    SymbolTable* st;
+    Liveness* lv;
+    int symbol_count;           /* символов до появления временных */
+    unsigned char* exposed;     /* символ -> статический массив используется не только как a[i] */
+
+    CSEClass* classes;
+    int class_count;
+    int class_cap;
+    int* table;                 /* открытая адресация: номер класса или -1 */
+    int table_cap;
+
+    int words;
+    uint32_t* kill_aliased;     /* классы, читающие общую память */
+    uint32_t** kill_sym;        /* символ -> классы, зависящие от него (или NULL) */
+
+    CSEMode mode;
+    int frozen;                 /* узел не переписывается, учитываются только убийства */
+    uint32_t* kill;             /* CSE_LOCAL: убитые в узле классы */
+    int replaced;
+
+    /* ключ текущего выражения */
+    char* kbuf;
+    int klen;
+    int kcap;
+    int* kdeps;
+    int kdep_count;
+    int kdep_cap;
+    int kaliased;
+} CSE;
+
+static int cse_bit(const uint32_t* set, int c) {
+    return (set[c >> 5] >> (c & 31)) & 1u;
+}
+
+static void cse_set(uint32_t* set, int c) {
+    set[c >> 5] |= (uint32_t)1u << (c & 31);
+}
+
+static int cse_is_int_type(const Type* t) {
+    return t && type_element(t)->is_integer;
+}
+
+static int cse_symbol(const CSE* g, const ASTNode* ident) {
+    if (!ident || ident->type != AST_IDENTIFIER || !ident->value) return -1;
+    const Symbol* sym = symbol_table_resolve(g->st, ident, g->lv->scope_id);
+    if (!sym) return -1;
+    int idx = (int)(sym - g->st->symbols);
+    return (idx < g->symbol_count) ? idx : -1;
+}
+
+/* Скаляр, значение которого меняется только явным присваиванием */
+static int cse_is_operand(const Symbol* sym) {
+    return (sym->type == SYM_LOCAL || sym->type == SYM_PARAMETER) &&
+        !sym->is_array && !sym->is_address_taken && !sym->escapes && cse_is_int_type(sym->dtype);
+}
+
+/* Статический массив кадра, в который можно попасть только через a[i] этой функции */
+static int cse_is_private_array(const CSE* g, int s) {
+    const Symbol* sym = &g->st->symbols[s];
+    return sym->type == SYM_LOCAL && sym->is_array && sym->array_size > 0 &&
+        !sym->is_address_taken && !sym->escapes && !g->exposed[s];
+}
+
+/* =========================
+ * Expression keys
+ * ========================= */
+
+static void cse_kput(CSE* g, const char* s) {
+    int n = (int)strlen(s);
+    if (g->klen + n + 1 > g->kcap) {
+        g->kcap = (g->klen + n + 1) * 2;
+        g->kbuf = (char*)realloc(g->kbuf, (size_t)g->kcap);
+    }
+    memcpy(g->kbuf + g->klen, s, (size_t)n + 1);
+    g->klen += n;
+}
+
+static void cse_kdep(CSE* g, int s) {
+    for (int i = 0; i < g->kdep_count; i++) {
+        if (g->kdeps[i] == s) return;
+    }
+    if (g->kdep_count == g->kdep_cap) {
+        g->kdep_cap = g->kdep_cap ? g->kdep_cap * 2 : 8;
+        g->kdeps = (int*)realloc(g->kdeps, (size_t)g->kdep_cap * sizeof(int));
+    }
+    g->kdeps[g->kdep_count++] = s;
+}
+
+static int cse_is_value_op(const char* op) {
+    static const char* ops[] = { "+", "-", "*", "/", "%", "&", "|", "^", "<<", ">>",
+        "==", "!=", "<", "<=", ">", ">=", NULL };
+    for (int i = 0; ops[i]; i++) {
+        if (strcmp(op, ops[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+/* Ключ выражения; 0 - выражение не нумеруется */
+static int cse_key(CSE* g, const ASTNode* e) {
+    char tmp[48];
+    if (!e) return 0;
+
+    switch (e->type) {
+    case AST_LITERAL:
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+        /* по значению: 0x10 и 16, 'A' и 65 загружаются одинаково */
+        snprintf(tmp, sizeof(tmp), "#%lld", (long long)e->literal.value);
+        cse_kput(g, tmp);
+        return 1;
+
+    case AST_IDENTIFIER: {
+        int s = cse_symbol(g, e);
+        if (s < 0 || !cse_is_operand(&g->st->symbols[s])) return 0;
+        snprintf(tmp, sizeof(tmp), "v%d", s);
+        cse_kput(g, tmp);
+        cse_kdep(g, s);
+        return 1;
+    }
+
+    case AST_UNARY_EXPR: {
+        const char* op = e->value ? e->value : "";
+        if (e->child_count != 1 || (strcmp(op, "-") && strcmp(op, "~") && strcmp(op, "!"))) return 0;
+        cse_kput(g, "(u");
+        cse_kput(g, op);
+        cse_kput(g, " ");
+        if (!cse_key(g, e->children[0])) return 0;
+        cse_kput(g, ")");
+        return 1;
+    }
+
+    case AST_BINARY_EXPR:
+    case AST_ARITHMETIC_EXPR: {
+        const char* op = e->value ? e->value : "";
+        if (e->child_count != 2 || !cse_is_value_op(op)) return 0;
+        cse_kput(g, "(");
+        cse_kput(g, op);
+        cse_kput(g, " ");
+        if (!cse_key(g, e->children[0])) return 0;
+        cse_kput(g, " ");
+        if (!cse_key(g, e->children[1])) return 0;
+        cse_kput(g, ")");
+        return 1;
+    }
+
+    case AST_INDEX_EXPR: {
+        if (e->child_count < 2 || !e->children[1] || e->children[1]->child_count != 1) return 0;
+        int s = cse_symbol(g, e->children[0]);
+        if (s < 0) return 0;
+        const Symbol* sym = &g->st->symbols[s];
+        if (!sym->is_array || !cse_is_int_type(sym->dtype)) return 0;
+
+        if (sym->array_size > 0) {
+            if (cse_is_private_array(g, s)) cse_kdep(g, s);
+            else g->kaliased = 1;
+        }
+        else {
+            /* динамический массив: база - значение переменной-ссылки */
+            if (sym->is_address_taken) return 0;
+            cse_kdep(g, s);
+            g->kaliased = 1;
+        }
+
+        snprintf(tmp, sizeof(tmp), "[a%d ", s);
+        cse_kput(g, tmp);
+        if (!cse_key(g, e->children[1]->children[0])) return 0;
+        cse_kput(g, "]");
+        return 1;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+static unsigned cse_hash(const char* s) {
+    unsigned h = 2166136261u;
+    for (; *s; s++) h = (h ^ (unsigned char)*s) * 16777619u;
+    return h;
+}
+
+static void cse_table_insert(CSE* g, int c) {
+    unsigned i = cse_hash(g->classes[c].key) & (unsigned)(g->table_cap - 1);
+    while (g->table[i] >= 0) i = (i + 1) & (unsigned)(g->table_cap - 1);
+    g->table[i] = c;
+}
+
+/* Номер класса выражения (-1 - не нумеруется или новый класс при create == 0) */
+static int cse_class_of(CSE* g, const ASTNode* e, int create) {
+    g->klen = 0;
+    g->kdep_count = 0;
+    g->kaliased = 0;
+    if (g->kbuf) g->kbuf[0] = '\0';
+    if (!cse_key(g, e)) return -1;
+
+    unsigned i = cse_hash(g->kbuf) & (unsigned)(g->table_cap - 1);
+    while (g->table[i] >= 0) {
+        if (strcmp(g->classes[g->table[i]].key, g->kbuf) == 0) return g->table[i];
+        i = (i + 1) & (unsigned)(g->table_cap - 1);
+    }
+    if (!create) return -1;
+
+    if (g->class_count == g->class_cap) {
+        g->class_cap = g->class_cap ? g->class_cap * 2 : 16;
+        g->classes = (CSEClass*)realloc(g->classes, (size_t)g->class_cap * sizeof(CSEClass));
+    }
+    int c = g->class_count++;
+    CSEClass* cl = &g->classes[c];
+    memset(cl, 0, sizeof(*cl));
+    cl->key = strdup(g->kbuf);
+    cl->dep_count = g->kdep_count;
+    cl->deps = (int*)malloc((size_t)(g->kdep_count > 0 ? g->kdep_count : 1) * sizeof(int));
+    memcpy(cl->deps, g->kdeps, (size_t)g->kdep_count * sizeof(int));
+    cl->aliased = g->kaliased;
+    cl->cost = codegen_estimate_expr_cost(e);
+
+    /* таблица заполнена не больше чем наполовину */
+    if (g->class_count * 2 > g->table_cap) {
+        free(g->table);
+        g->table_cap *= 2;
+        g->table = (int*)malloc((size_t)g->table_cap * sizeof(int));
+        for (int k = 0; k < g->table_cap; k++) g->table[k] = -1;
+        for (int k = 0; k < g->class_count; k++) cse_table_insert(g, k);
+    }
+    else {
+        cse_table_insert(g, c);
+    }
+    return c;
+}
+
+/* =========================
+ * Rewriting
+ * ========================= */
+
+/* e := чтение временной */
+static void cse_replace(CSE* g, ASTNode* e, const CSEClass* cl) {
+    for (int i = 0; i < e->child_count; i++) freeAST(e->children[i]);
+    free(e->children);
+    e->children = NULL;
+    e->child_count = 0;
+    free(e->value);
+    e->value = strdup(cl->temp_name);
+    e->type = AST_IDENTIFIER;
+    e->symbol = cl->temp_symbol;
+    g->replaced++;
+}
+
+/* e := ($cseN := e) - узел остаётся на месте, указатели на него валидны */
+static void cse_wrap(ASTNode* e, const CSEClass* cl) {
+    ASTNode* moved = (ASTNode*)malloc(sizeof(ASTNode));
+    *moved = *e;
+
+    e->type = AST_ASSIGNMENT;
+    e->has_explicit_type = 0;
+    e->value = strdup(":=");
+    e->children = NULL;
+    e->child_count = 0;
+    e->has_error = 0;
+    e->error_message = NULL;
+    e->data_type = NULL;
+    e->symbol = AST_NO_SYMBOL;
+
+    ASTNode* temp = createASTNode(AST_IDENTIFIER, cl->temp_name, e->line_number);
+    temp->symbol = cl->temp_symbol;
+    addChild(e, temp);
+    addChild(e, moved);
+}
+
+/* =========================
+ * Walk (порядок вычисления как в codegen)
+ * ========================= */
+
+static void cse_kill(CSE* g, uint32_t* avail, const uint32_t* set) {
+    if (!set) return;
+    for (int w = 0; w < g->words; w++) {
+        if (avail) avail[w] &= ~set[w];
+        if (g->kill) g->kill[w] |= set[w];
+    }
+}
+
+static void cse_kill_symbol(CSE* g, uint32_t* avail, int s) {
+    if (g->mode == CSE_COLLECT || s < 0) return;
+    cse_kill(g, avail, g->kill_sym[s]);
+}
+
+static void cse_kill_memory(CSE* g, uint32_t* avail) {
+    if (g->mode == CSE_COLLECT) return;
+    cse_kill(g, avail, g->kill_aliased);
+}
+
+static void cse_walk(CSE* g, ASTNode* e, uint32_t* avail);
+
+static void cse_walk_children(CSE* g, ASTNode* e, uint32_t* avail) {
+    for (int i = 0; i < e->child_count; i++) cse_walk(g, e->children[i], avail);
+}
+
+static void cse_walk(CSE* g, ASTNode* e, uint32_t* avail) {
+    if (!e) return;
+
+    switch (e->type) {
+    case AST_IDENTIFIER:
+    case AST_LITERAL:
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+    case AST_FLOAT_LITERAL:
+    case AST_STRING_LITERAL:
+        return;
+
+    case AST_ADDR_OF:
+        /* lvalue: адрес, а не значение */
+        return;
+
+    case AST_CALL_EXPR: {
+        const char* fname = (e->child_count > 0 && e->children[0]) ? e->children[0]->value : NULL;
+        ASTNode* args = (e->child_count > 1) ? e->children[1] : NULL;
+        int din_io = fname && (strcmp(fname, "read_din") == 0 || strcmp(fname, "write_din") == 0);
+        if (args && !din_io) {
+            /* аргументы кладутся справа налево */
+            for (int i = args->child_count - 1; i >= 0; i--) cse_walk(g, args->children[i], avail);
+        }
+        cse_kill_memory(g, avail);
+        return;
+    }
+
+    case AST_ASSIGNMENT: {
+        if (e->child_count < 2) return;
+        ASTNode* lhs = e->children[0];
+        ASTNode* rhs = e->children[1];
+
+        if (lhs && lhs->type == AST_IDENTIFIER) {
+            cse_walk(g, rhs, avail);
+            int s = cse_symbol(g, lhs);
+            cse_kill_symbol(g, avail, s);
+            return;
+        }
+
+        /* a[i] := rhs: база, индекс, затем правая часть */
+        if (lhs) cse_walk_children(g, lhs, avail);
+        cse_walk(g, rhs, avail);
+
+        int s = (lhs && lhs->type == AST_INDEX_EXPR && lhs->child_count > 0) ? cse_symbol(g, lhs->children[0]) : -1;
+        if (s >= 0 && cse_is_private_array(g, s)) cse_kill_symbol(g, avail, s);
+        else cse_kill_memory(g, avail);
+        return;
+    }
+
+    case AST_UNARY_EXPR:
+    case AST_BINARY_EXPR:
+    case AST_ARITHMETIC_EXPR:
+    case AST_INDEX_EXPR: {
+        const char* op = e->value ? e->value : "";
+        if ((e->type == AST_BINARY_EXPR || e->type == AST_ARITHMETIC_EXPR) &&
+            (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0)) {
+            /* правая часть исполняется не всегда: её вычисления не доступны после */
+            if (e->child_count < 2) return;
+            cse_walk(g, e->children[0], avail);
+            if (!avail) {
+                cse_walk(g, e->children[1], NULL);
+                return;
+            }
+            uint32_t* alt = (uint32_t*)malloc((size_t)g->words * sizeof(uint32_t));
+            memcpy(alt, avail, (size_t)g->words * sizeof(uint32_t));
+            cse_walk(g, e->children[1], alt);
+            for (int w = 0; w < g->words; w++) avail[w] &= alt[w];
+            free(alt);
+            return;
+        }
+
+        int c = g->frozen ? -1 : cse_class_of(g, e, g->mode == CSE_COLLECT);
+        int was_avail = (c >= 0 && avail && cse_bit(avail, c));
+
+        if (was_avail) {
+            CSEClass* cl = &g->classes[c];
+            if (g->mode == CSE_COUNT) { cl->redundant++; return; }
+            if (g->mode == CSE_LOCAL) return;
+            if (g->mode == CSE_REWRITE && cl->temp) { cse_replace(g, e, cl); return; }
+        }
+
+        cse_walk_children(g, e, avail);
+
+        if (c >= 0 && !was_avail) {
+            CSEClass* cl = &g->classes[c];
+            if (g->mode == CSE_COUNT) cl->generated++;
+            if (g->mode == CSE_REWRITE && cl->temp) cse_wrap(e, cl);
+        }
+        if (c >= 0 && avail) cse_set(avail, c);
+        return;
+    }
+
+    default:
+        cse_walk_children(g, e, avail);
+        return;
+    }
+}
+
+/* =========================
+ * Per-function analysis
+ * ========================= */
+
+static void cse_mark_exposed(CSE* g, const ASTNode* e, int is_base) {
+    if (!e) return;
+    if (e->type == AST_IDENTIFIER) {
+        int s = cse_symbol(g, e);
+        if (s >= 0 && !is_base && g->st->symbols[s].is_array) g->exposed[s] = 1;
+        return;
+    }
+    int first = 0;
+    if (e->type == AST_CALL_EXPR) first = 1;  /* имя функции */
+    for (int i = first; i < e->child_count; i++) {
+        cse_mark_exposed(g, e->children[i], e->type == AST_INDEX_EXPR && i == 0);
+    }
+}
+
+static int cse_plain_types(const CSE* g, const ASTNode* e) {
+    if (!e) return 1;
+    if (e->type == AST_FLOAT_LITERAL || e->type == AST_STRING_LITERAL) return 0;
+    if (e->type == AST_IDENTIFIER) {
+        int s = cse_symbol(g, e);
+        const Type* t = (s >= 0) ? g->st->symbols[s].dtype : NULL;
+        if (!t) return 1;
+        TypeKind k = type_element(t)->kind;
+        return k != TYPE_DIN && k != TYPE_FLOAT && k != TYPE_STRING;
+    }
+    for (int i = 0; i < e->child_count; i++) {
+        if (!cse_plain_types(g, e->children[i])) return 0;
+    }
+    return 1;
+}
+
+static void cse_add_temp(CSE* g, CSEClass* cl, int number) {
+    Scope* func_scope = symbol_table_scope(g->st, g->lv->scope_id);
+    if (!func_scope) return;
+
+    snprintf(cl->temp_name, sizeof(cl->temp_name), "$cse%d", number);
+    Scope* saved = g->st->current_scope;
+    g->st->current_scope = func_scope;
+    int symbol = symbol_table_add_local(g->st, cl->temp_name, "int", 0, 0);
+    g->st->current_scope = saved;
+    if (symbol < 0) return;
+    cl->temp_symbol = symbol;
+    cl->temp = 1;
+}
+
+static void cse_function(CFG* cfg, SymbolTable* st, const CFGFunction* fn, CSEStats* stats) {
+    Liveness* lv = liveness_compute(cfg, st, fn);
+    if (!lv) return;
+
+    CSE g;
+    memset(&g, 0, sizeof(g));
+    g.st = st;
+    g.lv = lv;
+    g.symbol_count = st->symbol_count;
+    g.exposed = (unsigned char*)calloc((size_t)(st->symbol_count > 0 ? st->symbol_count : 1), 1);
+    g.table_cap = 64;
+    g.table = (int*)malloc((size_t)g.table_cap * sizeof(int));
+    for (int k = 0; k < g.table_cap; k++) g.table[k] = -1;
+
+    /* операторы узлов подряд: узел p - roots[root_start[p] .. root_start[p + 1]) */
+    int n = lv->node_count;
+    int* root_start = (int*)malloc((size_t)(n + 1) * sizeof(int));
+    root_start[0] = 0;
+    for (int p = 0; p < n; p++) {
+        int count = 0;
+        cfg_node_exprs(cfg->nodes[lv->nodes[p]], &count);
+        root_start[p + 1] = root_start[p] + count;
+    }
+    int nroots = root_start[n];
+    ASTNode** roots = (ASTNode**)calloc((size_t)(nroots > 0 ? nroots : 1), sizeof(ASTNode*));
+    unsigned char* root_ok = (unsigned char*)calloc((size_t)(nroots > 0 ? nroots : 1), 1);
+    for (int p = 0; p < n; p++) {
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(cfg->nodes[lv->nodes[p]], &count);
+        for (int i = 0; i < count; i++) {
+            roots[root_start[p] + i] = exprs[i];
+            cse_mark_exposed(&g, exprs[i], 0);
+        }
+    }
+    for (int r = 0; r < nroots; r++) {
+        /* у каждого оператора своё дерево (cfg_builder их не разделяет); din/float не переписываем */
+        if (roots[r]) root_ok[r] = cse_plain_types(&g, roots[r]);
+    }
+
+    g.mode = CSE_COLLECT;
+    for (int r = 0; r < nroots; r++) {
+        g.frozen = !root_ok[r];
+        cse_walk(&g, roots[r], NULL);
+    }
+
+    int saved_insns = 0, temps = 0;
+    if (g.class_count > 0) {
+        int W = (g.class_count + 31) / 32;
+        g.words = W;
+
+        /* какие классы убивает запись в символ / в общую память */
+        g.kill_aliased = (uint32_t*)calloc((size_t)W, sizeof(uint32_t));
+        g.kill_sym = (uint32_t**)calloc((size_t)(g.symbol_count > 0 ? g.symbol_count : 1), sizeof(uint32_t*));
+        for (int c = 0; c < g.class_count; c++) {
+            const CSEClass* cl = &g.classes[c];
+            if (cl->aliased) cse_set(g.kill_aliased, c);
+            for (int d = 0; d < cl->dep_count; d++) {
+                int s = cl->deps[d];
+                if (!g.kill_sym[s]) g.kill_sym[s] = (uint32_t*)calloc((size_t)W, sizeof(uint32_t));
+                cse_set(g.kill_sym[s], c);
+            }
+        }
+
+        /* GEN/KILL узлов */
+        uint32_t* gen = (uint32_t*)calloc((size_t)n * W, sizeof(uint32_t));
+        uint32_t* kill = (uint32_t*)calloc((size_t)n * W, sizeof(uint32_t));
+        g.mode = CSE_LOCAL;
+        for (int p = 0; p < n; p++) {
+            g.kill = kill + (size_t)p * W;
+            for (int r = root_start[p]; r < root_start[p + 1]; r++) {
+                g.frozen = !root_ok[r];
+                cse_walk(&g, roots[r], gen + (size_t)p * W);
+            }
+        }
+        g.kill = NULL;
+
+        /* доступные выражения: out = gen | (in & ~kill), in = пересечение out предшественников */
+        DataflowProblem problem = { DATAFLOW_FORWARD, DATAFLOW_INTERSECT, g.class_count, gen, kill, NULL };
+        Dataflow* flow = dataflow_solve(lv->graph, &problem);
+        const uint32_t* in = flow ? flow->in : NULL;
+
+        uint32_t* avail = (uint32_t*)malloc((size_t)W * sizeof(uint32_t));
+
+        /* сколько раз каждое выражение вычисляется повторно (без решения - нисколько) */
+        g.mode = CSE_COUNT;
+        for (int p = 0; in && p < n; p++) {
+            memcpy(avail, in + (size_t)p * W, (size_t)W * sizeof(uint32_t));
+            for (int r = root_start[p]; r < root_start[p + 1]; r++) {
+                g.frozen = !root_ok[r];
+                cse_walk(&g, roots[r], avail);
+            }
+        }
+
+        /* временная окупается: чтение и запись $cse - по 3 инструкции */
+        for (int c = 0; c < g.class_count; c++) {
+            CSEClass* cl = &g.classes[c];
+            int benefit = cl->redundant * (cl->cost - 3) - cl->generated * 3;
+            if (cl->redundant == 0 || benefit <= 0) continue;
+            cse_add_temp(&g, cl, stats->temps + temps);
+            if (!cl->temp) continue;
+            temps++;
+            saved_insns += benefit;
+        }
+
+        if (temps > 0) {
+            g.mode = CSE_REWRITE;
+            for (int p = 0; p < n; p++) {
+                memcpy(avail, in + (size_t)p * W, (size_t)W * sizeof(uint32_t));
+                for (int r = root_start[p]; r < root_start[p + 1]; r++) {
+                    g.frozen = !root_ok[r];
+                    cse_walk(&g, roots[r], avail);
+                }
+            }
+        }
+
+        free(avail);
+        dataflow_free(flow);
+        free(gen);
+        free(kill);
+        for (int s = 0; s < g.symbol_count; s++) free(g.kill_sym[s]);
+        free(g.kill_sym);
+        free(g.kill_aliased);
+    }
+
+    stats->functions++;
+    stats->expressions += g.class_count;
+    stats->redundant += g.replaced;
+    stats->temps += temps;
+    stats->insns_saved += saved_insns;
+
+    TRACE(TRACE_CFG, TRACE_INFO, "  %s: %d expression(s), %d redundant evaluation(s) replaced, %d temp(s), ~%d instruction(s) saved\n",
+        lv->name, g.class_count, g.replaced, temps, saved_insns);
+
+    for (int c = 0; c < g.class_count; c++) {
+        free(g.classes[c].key);
+        free(g.classes[c].deps);
+    }
+    free(g.classes);
+    free(g.table);
+    free(g.kbuf);
+    free(g.kdeps);
+    free(g.exposed);
+    free(roots);
+    free(root_ok);
+    free(root_start);
+    liveness_free(lv);
+}
+
+CSEStats cse_run(CFG* cfg, SymbolTable* st) {
+    CSEStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!cfg || !st) return stats;
+
+    printf("[*] Eliminating common subexpressions...\n");
+
+    for (int f = 0; f < cfg->function_count; f++) {
+        cse_function(cfg, st, &cfg->functions[f], &stats);
+    }
+
+    return stats;
+}
+
+void cse_print_stats(const CSEStats* stats) {
+    if (!stats) return;
+    printf("[+] Common subexpressions: %d function(s), %d expression(s), %d evaluation(s) reused via %d temp(s), ~%d instruction(s)\n",
+        stats->functions, stats->expressions, stats->redundant, stats->temps, stats->insns_saved);
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+#ifndef CSE_H
+#define CSE_H
+
+#include "cfg.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Устранение общих подвыражений между узлами CFG (после SCCP, до DSE).
+     *
+     * Выражения нумеруются по структуре (одинаковые операции над одними и
+     * теми же переменными, литералами и массивами - один номер). Прямой
+     * поток "доступных выражений" по CFG функции находит вычисления, значение
+     * которых уже посчитано на всех путях и с тех пор не менялось:
+     *   - запись в переменную убивает выражения с ней;
+     *   - запись в элемент массива убивает загрузки из него; массивы, адрес
+     *     которых виден снаружи (escape-анализ, передача в вызов), считаются
+     *     одним классом памяти, который убивают любые записи в него и вызовы.
+     *
+     * Выгодные выражения получают временную переменную ($cseN): первое
+     * вычисление превращается в "$cseN := e", повторные - в чтение $cseN.
+     *
+     * Это не нумерация значений по дереву доминаторов: равенство только
+     * структурное, копии (x := y) не отслеживаются, а операторы с
+     * din/float/string операндами (в том числе загрузки тега din-ячейки)
+     * не нумеруются и не переписываются.
+     */
+
+    typedef struct {
+        int functions;
+        int expressions;       /* различных выражений-кандидатов */
+        int redundant;         /* повторных вычислений заменено */
+        int temps;             /* временных переменных заведено */
+        int insns_saved;       /* оценка сэкономленных инструкций */
+    } CSEStats;
+
+    CSEStats cse_run(CFG* cfg, SymbolTable* st);
+    void cse_print_stats(const CSEStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
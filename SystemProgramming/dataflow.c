@@ -0,0 +1,307 @@
+﻿#include "dataflow.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#define DATAFLOW_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DATAFLOW_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* =========================
+ * Операции над множествами
+ * ========================= */
+
+int dataflow_words(int bits) {
+    int words = (bits + 31) / 32;
+    return words > 0 ? words : 1;
+}
+
+int dataflow_test(const uint32_t* set, int bit) {
+    return (set[bit >> 5] >> (bit & 31)) & 1u;
+}
+
+void dataflow_set(uint32_t* set, int bit) {
+    set[bit >> 5] |= (uint32_t)1u << (bit & 31);
+}
+
+void dataflow_clear(uint32_t* set, int bit) {
+    set[bit >> 5] &= ~((uint32_t)1u << (bit & 31));
+}
+
+void dataflow_fill(uint32_t* dst, int bits, int words) {
+    memset(dst, 0xFF, (size_t)words * sizeof(uint32_t));
+    if (bits < words * 32) {
+        int full = bits >> 5;
+        if (bits & 31) dst[full++] = ((uint32_t)1u << (bits & 31)) - 1u;
+        for (int w = full; w < words; w++) dst[w] = 0;
+    }
+}
+
+/* dst = dst OP a: векторная часть, затем хвост по словам */
+#if defined(DATAFLOW_AVX2)
+#define DATAFLOW_KERNEL(name, vec_op, expr)                                         \
+    void name(uint32_t* dst, const uint32_t* a, int words) {                        \
+        int w = 0;                                                                  \
+        for (; w + 8 <= words; w += 8) {                                            \
+            __m256i x = _mm256_loadu_si256((const __m256i*)(dst + w));              \
+            __m256i y = _mm256_loadu_si256((const __m256i*)(a + w));                \
+            _mm256_storeu_si256((__m256i*)(dst + w), vec_op);                       \
+        }                                                                           \
+        for (; w < words; w++) dst[w] = (expr);                                     \
+    }
+#define DATAFLOW_OR     _mm256_or_si256(x, y)
+#define DATAFLOW_AND    _mm256_and_si256(x, y)
+#define DATAFLOW_ANDNOT _mm256_andnot_si256(y, x)
+#elif defined(DATAFLOW_SSE2)
+#define DATAFLOW_KERNEL(name, vec_op, expr)                                         \
+    void name(uint32_t* dst, const uint32_t* a, int words) {                        \
+        int w = 0;                                                                  \
+        for (; w + 4 <= words; w += 4) {                                            \
+            __m128i x = _mm_loadu_si128((const __m128i*)(dst + w));                 \
+            __m128i y = _mm_loadu_si128((const __m128i*)(a + w));                   \
+            _mm_storeu_si128((__m128i*)(dst + w), vec_op);                          \
+        }                                                                           \
+        for (; w < words; w++) dst[w] = (expr);                                     \
+    }
+#define DATAFLOW_OR     _mm_or_si128(x, y)
+#define DATAFLOW_AND    _mm_and_si128(x, y)
+#define DATAFLOW_ANDNOT _mm_andnot_si128(y, x)
+#else
+#define DATAFLOW_KERNEL(name, vec_op, expr)                                         \
+    void name(uint32_t* dst, const uint32_t* a, int words) {                        \
+        for (int w = 0; w < words; w++) dst[w] = (expr);                            \
+    }
+#endif
+
+DATAFLOW_KERNEL(dataflow_or, DATAFLOW_OR, dst[w] | a[w])
+DATAFLOW_KERNEL(dataflow_and, DATAFLOW_AND, dst[w] & a[w])
+DATAFLOW_KERNEL(dataflow_andnot, DATAFLOW_ANDNOT, dst[w] & ~a[w])
+
+int dataflow_transfer(uint32_t* dst, const uint32_t* gen, const uint32_t* in,
+    const uint32_t* kill, int words) {
+    int w = 0;
+    uint32_t diff = 0;
+
+#if defined(DATAFLOW_AVX2)
+    __m256i vdiff = _mm256_setzero_si256();
+    for (; w + 8 <= words; w += 8) {
+        __m256i g = _mm256_loadu_si256((const __m256i*)(gen + w));
+        __m256i i = _mm256_loadu_si256((const __m256i*)(in + w));
+        __m256i k = _mm256_loadu_si256((const __m256i*)(kill + w));
+        __m256i old = _mm256_loadu_si256((const __m256i*)(dst + w));
+        __m256i v = _mm256_or_si256(g, _mm256_andnot_si256(k, i));
+        vdiff = _mm256_or_si256(vdiff, _mm256_xor_si256(v, old));
+        _mm256_storeu_si256((__m256i*)(dst + w), v);
+    }
+    if (!_mm256_testz_si256(vdiff, vdiff)) diff = 1;
+#elif defined(DATAFLOW_SSE2)
+    __m128i vdiff = _mm_setzero_si128();
+    for (; w + 4 <= words; w += 4) {
+        __m128i g = _mm_loadu_si128((const __m128i*)(gen + w));
+        __m128i i = _mm_loadu_si128((const __m128i*)(in + w));
+        __m128i k = _mm_loadu_si128((const __m128i*)(kill + w));
+        __m128i old = _mm_loadu_si128((const __m128i*)(dst + w));
+        __m128i v = _mm_or_si128(g, _mm_andnot_si128(k, i));
+        vdiff = _mm_or_si128(vdiff, _mm_xor_si128(v, old));
+        _mm_storeu_si128((__m128i*)(dst + w), v);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(vdiff, _mm_setzero_si128())) != 0xFFFF) diff = 1;
+#endif
+
+    for (; w < words; w++) {
+        uint32_t v = gen[w] | (in[w] & ~kill[w]);
+        diff |= v ^ dst[w];
+        dst[w] = v;
+    }
+    return diff != 0;
+}
+
+/* =========================
+ * Граф функции
+ * ========================= */
+
+void dataflow_graph_free(DataflowGraph* g) {
+    if (!g) return;
+    free(g->nodes);
+    free(g->node_pos);
+    free(g->succ);
+    free(g->succ_start);
+    free(g->succ_list);
+    free(g->pred_start);
+    free(g->pred_list);
+    free(g->rpo);
+    free(g);
+}
+
+DataflowGraph* dataflow_graph_create(const CFG* cfg, const CFGFunction* fn) {
+    if (!cfg || !fn || !fn->entry || !cfg->edges_valid || !fn->rpo) return NULL;
+
+    DataflowGraph* g = (DataflowGraph*)calloc(1, sizeof(DataflowGraph));
+    if (!g) return NULL;
+    g->cfg = cfg;
+    g->fn = fn;
+
+    int first = fn->first_node;
+    int n = fn->end_node - first;
+    int m = fn->reachable_count;
+    g->node_pos = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    g->nodes = (int*)malloc((size_t)(m > 0 ? m : 1) * sizeof(int));
+    g->succ = (int*)malloc((size_t)(m > 0 ? 2 * m : 1) * sizeof(int));
+    g->succ_start = (int*)calloc((size_t)m + 1, sizeof(int));
+    g->pred_start = (int*)calloc((size_t)m + 1, sizeof(int));
+    g->succ_list = (int*)malloc((size_t)(m > 0 ? 2 * m : 1) * sizeof(int));
+    g->pred_list = (int*)malloc((size_t)(m > 0 ? 2 * m : 1) * sizeof(int));
+    g->rpo = (int*)malloc((size_t)(m > 0 ? m : 1) * sizeof(int));
+    if (!g->node_pos || !g->nodes || !g->succ || !g->succ_start || !g->pred_start ||
+        !g->succ_list || !g->pred_list || !g->rpo) {
+        dataflow_graph_free(g);
+        return NULL;
+    }
+
+    /* позиции - достижимые узлы по возрастанию id */
+    for (int i = 0; i < n; i++) {
+        g->node_pos[i] = -1;
+        if (cfg_function_reaches(fn, first + i)) {
+            g->node_pos[i] = g->node_count;
+            g->nodes[g->node_count++] = first + i;
+        }
+    }
+    g->entry = g->node_pos[fn->entry->id - first];
+
+    for (int p = 0; p < g->node_count; p++) {
+        const CFGNode* cur = cfg->nodes[g->nodes[p]];
+        g->succ[2 * p] = cur->defaultNext ? g->node_pos[cur->defaultNext->id - first] : -1;
+        g->succ[2 * p + 1] = cur->conditionalNext ? g->node_pos[cur->conditionalNext->id - first] : -1;
+    }
+
+    /* CSR: преемники без повторов, предшественники подсчётом */
+    int edges = 0;
+    for (int p = 0; p < g->node_count; p++) {
+        g->succ_start[p] = edges;
+        int a = g->succ[2 * p], b = g->succ[2 * p + 1];
+        if (a >= 0) {
+            g->succ_list[edges++] = a;
+            g->pred_start[a + 1]++;
+        }
+        if (b >= 0 && b != a) {
+            g->succ_list[edges++] = b;
+            g->pred_start[b + 1]++;
+        }
+    }
+    g->succ_start[g->node_count] = edges;
+    for (int p = 0; p < g->node_count; p++) g->pred_start[p + 1] += g->pred_start[p];
+    int* fill = g->rpo;     /* временно - курсоры заполнения pred_list */
+    memcpy(fill, g->pred_start, (size_t)g->node_count * sizeof(int));
+    for (int p = 0; p < g->node_count; p++) {
+        for (int e = g->succ_start[p]; e < g->succ_start[p + 1]; e++) {
+            g->pred_list[fill[g->succ_list[e]]++] = p;
+        }
+    }
+
+    for (int k = 0; k < g->node_count; k++) g->rpo[k] = g->node_pos[fn->rpo[k] - first];
+    return g;
+}
+
+/* =========================
+ * Решатель
+ * ========================= */
+
+const uint32_t* dataflow_row(const uint32_t* sets, int words, int pos) {
+    return sets + (size_t)pos * (size_t)words;
+}
+
+void dataflow_free(Dataflow* df) {
+    if (!df) return;
+    free(df->in);
+    free(df->out);
+    free(df);
+}
+
+Dataflow* dataflow_solve(const DataflowGraph* g, const DataflowProblem* p) {
+    if (!g || !p) return NULL;
+
+    Dataflow* df = (Dataflow*)calloc(1, sizeof(Dataflow));
+    if (!df) return NULL;
+    df->graph = g;
+    int n = g->node_count;
+    int words = df->words = dataflow_words(p->bits);
+    size_t total = (size_t)(n > 0 ? n : 1) * (size_t)words;
+    df->in = (uint32_t*)calloc(total, sizeof(uint32_t));
+    df->out = (uint32_t*)calloc(total, sizeof(uint32_t));
+    int* order = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    unsigned char* queued = (unsigned char*)malloc((size_t)(n > 0 ? n : 1));
+    if (!df->in || !df->out || !order || !queued) {
+        free(order);
+        free(queued);
+        dataflow_free(df);
+        return NULL;
+    }
+
+    int forward = (p->direction == DATAFLOW_FORWARD);
+    int intersect = (p->meet == DATAFLOW_INTERSECT);
+
+    /* прямая задача - обратный постпорядок, обратная - постпорядок */
+    for (int k = 0; k < n; k++) order[k] = forward ? g->rpo[k] : g->rpo[n - 1 - k];
+
+    /* начало снизу (пусто) для объединения, сверху (всё) для пересечения */
+    if (intersect) {
+        for (int q = 0; q < n; q++) {
+            dataflow_fill(df->in + (size_t)q * words, p->bits, words);
+            dataflow_fill(df->out + (size_t)q * words, p->bits, words);
+        }
+    }
+
+    /* acc - слияние соседей, res - результат передаточной функции */
+    uint32_t* acc_sets = forward ? df->in : df->out;
+    uint32_t* res_sets = forward ? df->out : df->in;
+    const int* meet_start = forward ? g->pred_start : g->succ_start;
+    const int* meet_list = forward ? g->pred_list : g->succ_list;
+    const int* dep_start = forward ? g->succ_start : g->pred_start;
+    const int* dep_list = forward ? g->succ_list : g->pred_list;
+
+    memset(queued, 1, (size_t)n);
+    int pending = n;
+    while (pending > 0) {
+        df->stats.iterations++;
+        for (int k = 0; k < n; k++) {
+            int q = order[k];
+            if (!queued[q]) continue;
+            queued[q] = 0;
+            pending--;
+            df->stats.visits++;
+
+            uint32_t* acc = acc_sets + (size_t)q * words;
+            uint32_t* res = res_sets + (size_t)q * words;
+            int boundary = forward ? (q == g->entry) : (meet_start[q] == meet_start[q + 1]);
+
+            if (boundary && p->boundary) memcpy(acc, p->boundary, (size_t)words * sizeof(uint32_t));
+            else if (boundary || !intersect) memset(acc, 0, (size_t)words * sizeof(uint32_t));
+            else dataflow_fill(acc, p->bits, words);
+
+            for (int e = meet_start[q]; e < meet_start[q + 1]; e++) {
+                const uint32_t* src = res_sets + (size_t)meet_list[e] * words;
+                if (intersect) dataflow_and(acc, src, words);
+                else dataflow_or(acc, src, words);
+                df->stats.words += words;
+            }
+
+            df->stats.words += words;
+            if (!dataflow_transfer(res, p->gen + (size_t)q * words, acc, p->kill + (size_t)q * words, words)) continue;
+            for (int e = dep_start[q]; e < dep_start[q + 1]; e++) {
+                int d = dep_list[e];
+                if (!queued[d]) {
+                    queued[d] = 1;
+                    pending++;
+                }
+            }
+        }
+    }
+
+    free(order);
+    free(queued);
+    return df;
+}
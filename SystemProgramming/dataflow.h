@@ -0,0 +1,127 @@
+﻿#pragma once
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include <stdint.h>
+#include "cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Битовый поток данных по CFG одной функции.
+     *
+     * Общая часть анализов вида out = gen | (in & ~kill) с объединением
+     * или пересечением на слиянии: живость, достигающие определения,
+     * доступные выражения, определённая инициализация. Анализ задаёт
+     * направление, операцию слияния, gen/kill по узлам и граничное
+     * значение; решатель находит неподвижную точку.
+     *
+     * Граф (DataflowGraph) - достижимые из входа узлы функции, позиция
+     * узла - его номер по возрастанию id. Рёбра в позициях лежат в CSR,
+     * порядок обхода - обратный постпорядок из cfg_finalize (прямые
+     * задачи) или постпорядок (обратные). Решатель - список работ поверх
+     * этого порядка: проход идёт по порядку и пересчитывает только
+     * помеченные узлы, изменение выхода узла помечает зависящих от него.
+     *
+     * Множества - плотные строки по words слов uint32_t на узел. Операции
+     * над строками векторные (AVX2 или SSE2 при сборке с ними, иначе
+     * по словам), поэтому тысячи переменных на десятки тысяч узлов -
+     * это линейные проходы по памяти без ветвлений на бит.
+     *
+     * in/out - в порядке исполнения при любом направлении: для обратной
+     * задачи out[n] = слияние in преемников, in[n] = gen | (out & ~kill).
+     */
+
+    typedef enum {
+        DATAFLOW_FORWARD,
+        DATAFLOW_BACKWARD
+    } DataflowDirection;
+
+    typedef enum {
+        DATAFLOW_UNION,             /* "на каком-нибудь пути" */
+        DATAFLOW_INTERSECT          /* "на всех путях" */
+    } DataflowMeet;
+
+    typedef struct {
+        const CFG* cfg;
+        const CFGFunction* fn;
+
+        int node_count;
+        int* nodes;                 /* позиция -> индекс в cfg->nodes (по возрастанию) */
+        int* node_pos;              /* id - fn->first_node -> позиция или -1 */
+        int* succ;                  /* succ[2p] / succ[2p + 1] - позиции преемников по
+                                       defaultNext / conditionalNext (-1 = нет) */
+        int entry;                  /* позиция входа */
+
+        /* CSR в позициях, без повторов */
+        int* succ_start;
+        int* succ_list;
+        int* pred_start;
+        int* pred_list;
+
+        int* rpo;                   /* позиции в обратном постпорядке */
+    } DataflowGraph;
+
+    typedef struct {
+        int iterations;             /* проходов по порядку обхода */
+        int visits;                 /* пересчётов узлов */
+        long long words;            /* слов множеств в слияниях и передаточных функциях */
+    } DataflowStats;
+
+    typedef struct {
+        DataflowDirection direction;
+        DataflowMeet meet;
+        int bits;                   /* размер универсума */
+        const uint32_t* gen;        /* node_count строк */
+        const uint32_t* kill;
+        const uint32_t* boundary;   /* in входа / out узлов без преемников; NULL - пусто */
+    } DataflowProblem;
+
+    typedef struct {
+        const DataflowGraph* graph;
+        int words;
+        uint32_t* in;               /* node_count строк по words */
+        uint32_t* out;
+        DataflowStats stats;
+    } Dataflow;
+
+    /* ========================= * Граф * ========================= */
+
+    /* Граф функции fn; нужен CSR рёбер и обходы (cfg_finalize), иначе NULL */
+    DataflowGraph* dataflow_graph_create(const CFG* cfg, const CFGFunction* fn);
+    void dataflow_graph_free(DataflowGraph* g);
+
+    /* ========================= * Решатель * ========================= */
+
+    int dataflow_words(int bits);
+
+    /* Неподвижная точка задачи p на графе g; NULL - нет памяти */
+    Dataflow* dataflow_solve(const DataflowGraph* g, const DataflowProblem* p);
+    void dataflow_free(Dataflow* df);
+
+    const uint32_t* dataflow_row(const uint32_t* sets, int words, int pos);
+
+    /* ========================= * Операции над множествами * ========================= */
+
+    int dataflow_test(const uint32_t* set, int bit);
+    void dataflow_set(uint32_t* set, int bit);
+    void dataflow_clear(uint32_t* set, int bit);
+
+    /* Все bits бит (хвост последнего слова - нули) */
+    void dataflow_fill(uint32_t* dst, int bits, int words);
+
+    void dataflow_or(uint32_t* dst, const uint32_t* a, int words);       /* dst |= a */
+    void dataflow_and(uint32_t* dst, const uint32_t* a, int words);      /* dst &= a */
+    void dataflow_andnot(uint32_t* dst, const uint32_t* a, int words);   /* dst &= ~a */
+
+    /* dst = gen | (in & ~kill); 1 - dst изменился */
+    int dataflow_transfer(uint32_t* dst, const uint32_t* gen, const uint32_t* in,
+        const uint32_t* kill, int words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+﻿#include "dse.h"
+#include "liveness.h"
+#include "codegen.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================
+ * Side effects
+ * ========================= */
+
+/* 1 - выражение можно не вычислять: нет вызовов, присваиваний и записей в память */
+static int dse_is_pure(const ASTNode* e) {
+    if (!e) return 1;
+    switch (e->type) {
+    case AST_CALL_EXPR:
+    case AST_ASSIGNMENT:
+    case AST_INDEXED_ASSIGNMENT:
+        return 0;
+    default:
+        break;
+    }
+    for (int i = 0; i < e->child_count; i++) {
+        if (!dse_is_pure(e->children[i])) return 0;
+    }
+    return 1;
+}
+
+/* =========================
+ * Instruction cost (templates of codegen.c)
+ * ========================= */
+
+static int dse_is_din(const Symbol* sym) {
+    return sym && sym->dtype && type_element(sym->dtype)->kind == TYPE_DIN;
+}
+
+/* MOVI r7 + SUB/ADD r7 + STS (din: ещё MOV/ADDI/STS для тега) */
+static int dse_store_cost(const Symbol* sym) {
+    return dse_is_din(sym) ? 6 : 3;
+}
+
+/* =========================
+ * Per-function pass
+ * ========================= */
+
+static void dse_function(CFG* cfg, const SymbolTable* st, const CFGFunction* fn, DSEStats* stats) {
+    int stores = 0, whole = 0, insns = 0, rounds = 0;
+    const char* name = fn->name ? fn->name : "?";
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        rounds++;
+
+        Liveness* lv = liveness_compute(cfg, st, fn);
+        if (!lv) return;
+        uint32_t* live = (uint32_t*)malloc((size_t)lv->words * sizeof(uint32_t));
+
+        for (int p = 0; p < lv->node_count; p++) {
+            CFGNode* node = cfg->nodes[lv->nodes[p]];
+            if ((node->type != CFG_BLOCK && node->type != CFG_CONDITION) || node->has_error) continue;
+
+            /* операторы блока с конца; условие перехода не трогаем */
+            int stmts = node->expr_tree_count - (node->type == CFG_CONDITION ? 1 : 0);
+            memcpy(live, liveness_row(lv, lv->live_out, p), (size_t)lv->words * sizeof(uint32_t));
+            for (int i = node->expr_tree_count - 1; i >= 0; i--) {
+                ASTNode* e = node->expr_trees[i];
+                int v = -1;
+                if (i < stmts && e && e->type == AST_ASSIGNMENT && e->child_count >= 2) {
+                    v = liveness_var_of_ident(lv, e->children[0]);
+                }
+                const Symbol* sym = (v >= 0) ? &st->symbols[lv->vars[v]] : NULL;
+                if (!sym || sym->is_array || sym->is_address_taken || sym->escapes || liveness_bit(live, v)) {
+                    liveness_step(lv, e, live, NULL);
+                    continue;
+                }
+
+                ASTNode* rhs = e->children[1];
+                if (dse_is_pure(rhs)) {
+                    /* присваивание целиком: оператор уходит из блока */
+                    memmove(node->expr_trees + i, node->expr_trees + i + 1,
+                        (size_t)(node->expr_tree_count - i - 1) * sizeof(ASTNode*));
+                    node->expr_tree_count--;
+                    insns += codegen_estimate_expr_cost(rhs) + dse_store_cost(sym);
+                    whole++;
+                }
+                else {
+                    /* правая часть нужна ради побочных эффектов */
+                    node->expr_trees[i] = rhs;
+                    insns += dse_store_cost(sym);
+                    liveness_step(lv, rhs, live, NULL);
+                }
+                stores++;
+                changed = 1;
+            }
+        }
+
+        free(live);
+        liveness_free(lv);
+    }
+
+    stats->functions++;
+    stats->stores_removed += stores;
+    stats->assignments_removed += whole;
+    stats->insns_removed += insns;
+
+    TRACE(TRACE_CFG, TRACE_INFO, "  %s: %d dead store(s), %d assignment(s) removed, ~%d instruction(s) eliminated (%d round(s))\n",
+        name, stores, whole, insns, rounds);
+}
+
+DSEStats dse_run(CFG* cfg, const SymbolTable* st) {
+    DSEStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!cfg || !st) return stats;
+
+    printf("[*] Eliminating dead stores...\n");
+
+    for (int f = 0; f < cfg->function_count; f++) {
+        dse_function(cfg, st, &cfg->functions[f], &stats);
+    }
+
+    return stats;
+}
+
+void dse_print_stats(const DSEStats* stats) {
+    if (!stats) return;
+    printf("[+] Dead store elimination: %d store(s) in %d function(s), %d assignment(s) dropped, ~%d instruction(s)\n",
+        stats->stores_removed, stats->functions, stats->assignments_removed, stats->insns_removed);
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+#ifndef DSE_H
+#define DSE_H
+
+#include "cfg.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Удаление мёртвых записей (после построения CFG, до раскладки кадров).
+     *
+     * По живости переменных (liveness.c, внутри блока - с конца по
+     * операторам) находит присваивания локальным скалярам, значение
+     * которых больше не читается:
+     *   - правая часть без побочных эффектов - оператор уходит из блока;
+     *   - иначе в блоке остаётся только правая часть (вызовы, записи в память),
+     *     а сама запись в переменную удаляется.
+     * Проход повторяется до неподвижной точки: удалённая правая часть могла
+     * быть последним чтением другой переменной.
+     *
+     * Число удалённых инструкций оценивается по тем же шаблонам, что
+     * использует codegen.c (загрузка со стека - 3 инструкции и т.д.).
+     */
+
+    typedef struct {
+        int functions;
+        int stores_removed;       /* записей в переменные */
+        int assignments_removed;  /* целиком удалённых присваиваний */
+        int insns_removed;        /* оценка удалённых инструкций */
+    } DSEStats;
+
+    DSEStats dse_run(CFG* cfg, const SymbolTable* st);
+    void dse_print_stats(const DSEStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,699 @@
+﻿#include "escape.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+/* =========================
+ * Bit sets over abstract objects
+ *
+ * Объекты - только переменные кадров анализируемых функций (символы
+ * их областей), а не вся таблица: при потоковой компиляции таблица растёт
+ * с программой, а анализ одной функции должен стоить как сама функция.
+ *
+ * Номера объектов (frame - номер переменной кадра, см. frame_object):
+ *   [0, frame_count)                       - слот переменной (её адрес)
+ *   [frame_count, +alloc_sites)            - место вызова new_arr
+ *   [frame_count + alloc_sites, +frame_count) - входящее значение параметра
+ * ========================= */
+
+typedef struct {
+    uint32_t* w;
+} ObjSet;
+
+typedef struct {
+    SymbolTable* st;
+    EscapeInfo* info;
+
+    int nobj;
+    int nwords;
+
+    int frame_count;
+    int* frame_symbols; /* переменная кадра -> индекс символа */
+    int* frame_of;      /* индекс символа - frame_lo -> переменная кадра или -1 */
+    int frame_lo;
+    int frame_span;
+
+    int sym_base;
+    int alloc_base;
+    int param_base;
+
+    ObjSet* pts;        /* по переменной кадра: что может в ней лежать */
+    int* alloc_func;    /* функция-владелец места new_arr */
+    int* alloc_line;
+    int* alloc_escapes;
+
+    /* состояние текущей функции */
+    int func;           /* индекс в info->funcs */
+    int scope_id;
+    int next_site;
+    ObjSet mem;         /* всё, что записано через указатели/элементы массивов */
+    ObjSet esc;         /* убегающие объекты */
+    int changed;
+} EscCtx;
+
+static int os_words(const EscCtx* c) { return c->nwords; }
+
+static ObjSet os_new(const EscCtx* c) {
+    ObjSet s;
+    s.w = (uint32_t*)calloc((size_t)(os_words(c) ? os_words(c) : 1), sizeof(uint32_t));
+    return s;
+}
+
+static void os_free(ObjSet* s) {
+    free(s->w);
+    s->w = NULL;
+}
+
+static void os_add(ObjSet* s, int bit) {
+    s->w[bit >> 5] |= (uint32_t)1u << (bit & 31);
+}
+
+static int os_has(const ObjSet* s, int bit) {
+    return (s->w[bit >> 5] >> (bit & 31)) & 1u;
+}
+
+/* dst |= src, 1 если dst изменился */
+static int os_union(const EscCtx* c, ObjSet* dst, const ObjSet* src) {
+    int changed = 0;
+    for (int i = 0; i < c->nwords; i++) {
+        uint32_t n = dst->w[i] | src->w[i];
+        if (n != dst->w[i]) {
+            dst->w[i] = n;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+static int os_empty(const EscCtx* c, const ObjSet* s) {
+    for (int i = 0; i < c->nwords; i++) {
+        if (s->w[i]) return 0;
+    }
+    return 1;
+}
+
+static int os_intersects(const EscCtx* c, const ObjSet* a, const ObjSet* b) {
+    for (int i = 0; i < c->nwords; i++) {
+        if (a->w[i] & b->w[i]) return 1;
+    }
+    return 0;
+}
+
+/* =========================
+ * Helpers
+ * ========================= */
+
+static char* esc_strdup(const char* s) {
+    if (!s) return NULL;
+    size_t n = strlen(s) + 1;
+    char* p = (char*)malloc(n);
+    if (p) memcpy(p, s, n);
+    return p;
+}
+
+static int is_static_array(const Symbol* sym) {
+    return sym && sym->is_array && sym->array_size > 0;
+}
+
+static int is_frame_symbol(const Symbol* sym) {
+    return sym && (sym->type == SYM_LOCAL || sym->type == SYM_PARAMETER);
+}
+
+/* Номер переменной кадра анализируемой функции; -1 - не объект */
+static int frame_object(const EscCtx* c, const Symbol* sym) {
+    if (!is_frame_symbol(sym)) return -1;
+    int i = (int)(sym - c->st->symbols) - c->frame_lo;
+    return (i >= 0 && i < c->frame_span) ? c->frame_of[i] : -1;
+}
+
+static int find_func(const EscapeInfo* info, const char* name) {
+    if (!info || !name) return -1;
+    for (int i = 0; i < info->func_count; i++) {
+        if (strcmp(info->funcs[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static const char* call_name(const ASTNode* call) {
+    if (!call) return NULL;
+    if (call->child_count > 0 && call->children[0] && call->children[0]->value) {
+        return call->children[0]->value;
+    }
+    return call->value;
+}
+
+static const ASTNode* call_args(const ASTNode* call) {
+    return (call && call->child_count > 1) ? call->children[1] : NULL;
+}
+
+/* Привязка идентификатора из semantic_analyze (по имени - только без неё) */
+static Symbol* resolve(EscCtx* c, const ASTNode* ident) {
+    return symbol_table_resolve(c->st, ident, c->scope_id);
+}
+
+/* Объекты в `s` убегают */
+static void mark_escape(EscCtx* c, const ObjSet* s) {
+    if (os_union(c, &c->esc, s)) c->changed = 1;
+}
+
+/* =========================
+ * Expressions
+ * ========================= */
+
+static ObjSet eval_expr(EscCtx* c, const ASTNode* e);
+
+/* Адрес lvalue: &x, &a[i], аргумент read_din/write_din */
+static ObjSet eval_address(EscCtx* c, const ASTNode* lv) {
+    if (lv && lv->type == AST_IDENTIFIER && lv->value) {
+        ObjSet r = os_new(c);
+        Symbol* sym = resolve(c, lv);
+        int obj = frame_object(c, sym);
+        if (obj >= 0) {
+            if (!sym->is_address_taken) {
+                sym->is_address_taken = 1;
+                c->changed = 1;
+            }
+            os_add(&r, c->sym_base + obj);
+        }
+        return r;
+    }
+
+    if (lv && (lv->type == AST_INDEX_EXPR || lv->type == AST_ARRAY_ACCESS) && lv->child_count > 0) {
+        /* &a[i] указывает внутрь массива a */
+        for (int i = 1; i < lv->child_count; i++) {
+            ObjSet t = eval_expr(c, lv->children[i]);
+            os_free(&t);
+        }
+        return eval_expr(c, lv->children[0]);
+    }
+
+    return eval_expr(c, lv);
+}
+
+static ObjSet eval_call(EscCtx* c, const ASTNode* e) {
+    ObjSet result = os_new(c);
+    const char* fname = call_name(e);
+    const ASTNode* args = call_args(e);
+    int argc = args ? args->child_count : 0;
+
+    if (fname && strcmp(fname, "new_arr") == 0) {
+        for (int i = 0; i < argc; i++) {
+            ObjSet t = eval_expr(c, args->children[i]);
+            os_free(&t);
+        }
+        int site = c->next_site++;
+        if (site < c->info->alloc_sites) {
+            c->alloc_func[site] = c->func;
+            c->alloc_line[site] = e->line_number;
+            os_add(&result, c->alloc_base + site);
+        }
+        return result;
+    }
+
+    if (fname && (strcmp(fname, "read_din") == 0 || strcmp(fname, "write_din") == 0)) {
+        /* ABI: рантайм получает указатель на ячейку и не сохраняет его */
+        for (int i = 0; i < argc; i++) {
+            ObjSet t = eval_address(c, args->children[i]);
+            os_free(&t);
+        }
+        return result;
+    }
+
+    int callee = find_func(c->info, fname);
+    const EscapeSummary* sum = (callee >= 0) ? &c->info->funcs[callee] : NULL;
+
+    for (int i = 0; i < argc; i++) {
+        ObjSet a = eval_expr(c, args->children[i]);
+        if (!sum || i >= sum->param_count || sum->param_escapes[i]) {
+            mark_escape(c, &a);
+        }
+        if (sum && i < sum->param_count && sum->param_to_return[i]) {
+            os_union(c, &result, &a);
+        }
+        os_free(&a);
+    }
+    return result;
+}
+
+static ObjSet eval_assignment(EscCtx* c, const ASTNode* e) {
+    const ASTNode* lhs = (e->child_count > 0) ? e->children[0] : NULL;
+    const ASTNode* rhs = (e->child_count > 1) ? e->children[1] : NULL;
+
+    ObjSet v = eval_expr(c, rhs);
+
+    if (lhs && lhs->type == AST_IDENTIFIER && lhs->value) {
+        Symbol* sym = resolve(c, lhs);
+        if (sym && sym->type == SYM_GLOBAL) {
+            mark_escape(c, &v);
+        }
+        else if (frame_object(c, sym) >= 0) {
+            if (os_union(c, &c->pts[frame_object(c, sym)], &v)) c->changed = 1;
+        }
+        return v;
+    }
+
+    /* запись через указатель: a[i] := v, *p := v */
+    ObjSet target = os_new(c);
+    if (lhs && (lhs->type == AST_INDEX_EXPR || lhs->type == AST_ARRAY_ACCESS)) {
+        os_free(&target);
+        target = eval_address(c, lhs);
+    }
+    else if (lhs && lhs->type == AST_DEREF && lhs->child_count > 0) {
+        os_free(&target);
+        target = eval_expr(c, lhs->children[0]);
+    }
+
+    /* цель - чужая память (входящий указатель или убегающий объект) */
+    int foreign = 0;
+    for (int i = c->param_base; i < c->nobj && !foreign; i++) {
+        if (os_has(&target, i)) foreign = 1;
+    }
+    if (!foreign && os_intersects(c, &target, &c->esc)) foreign = 1;
+
+    if (foreign) mark_escape(c, &v);
+    else if (os_union(c, &c->mem, &v)) c->changed = 1;
+
+    os_free(&target);
+    return v;
+}
+
+static ObjSet eval_expr(EscCtx* c, const ASTNode* e) {
+    if (!e) return os_new(c);
+
+    switch (e->type) {
+    case AST_IDENTIFIER: {
+        ObjSet r = os_new(c);
+        Symbol* sym = resolve(c, e);
+        int idx = frame_object(c, sym);
+        if (idx < 0) return r;
+        if (is_static_array(sym)) {
+            /* имя статического массива - адрес его хранилища */
+            os_add(&r, c->sym_base + idx);
+        }
+        else {
+            os_union(c, &r, &c->pts[idx]);
+        }
+        return r;
+    }
+
+    case AST_ADDR_OF:
+        return eval_address(c, (e->child_count > 0) ? e->children[0] : NULL);
+
+    case AST_DEREF:
+    case AST_INDEX_EXPR:
+    case AST_ARRAY_ACCESS: {
+        /* загрузка из памяти: всё, что туда когда-либо писали */
+        for (int i = 0; i < e->child_count; i++) {
+            ObjSet t = eval_expr(c, e->children[i]);
+            os_free(&t);
+        }
+        ObjSet r = os_new(c);
+        os_union(c, &r, &c->mem);
+        return r;
+    }
+
+    case AST_CALL_EXPR:
+        return eval_call(c, e);
+
+    case AST_ASSIGNMENT:
+    case AST_INDEXED_ASSIGNMENT:
+        return eval_assignment(c, e);
+
+    default: {
+        /* арифметика над указателями сохраняет объект */
+        ObjSet r = os_new(c);
+        for (int i = 0; i < e->child_count; i++) {
+            ObjSet t = eval_expr(c, e->children[i]);
+            os_union(c, &r, &t);
+            os_free(&t);
+        }
+        return r;
+    }
+    }
+}
+
+static int is_expression_node(const ASTNode* n) {
+    switch (n->type) {
+    case AST_BINARY_EXPR:
+    case AST_UNARY_EXPR:
+    case AST_CALL_EXPR:
+    case AST_INDEX_EXPR:
+    case AST_IDENTIFIER:
+    case AST_ASSIGNMENT:
+    case AST_INDEXED_ASSIGNMENT:
+    case AST_ARITHMETIC_EXPR:
+    case AST_ADDR_OF:
+    case AST_DEREF:
+    case AST_ARRAY_ACCESS:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void walk_statement(EscCtx* c, const ASTNode* n) {
+    if (!n) return;
+    if (n->type == AST_VAR_DECLARATION || n->type == AST_VAR_DECL_LIST) return;
+
+    if (is_expression_node(n)) {
+        ObjSet t = eval_expr(c, n);
+        os_free(&t);
+        return;
+    }
+
+    for (int i = 0; i < n->child_count; i++) {
+        walk_statement(c, n->children[i]);
+    }
+}
+
+/* =========================
+ * Per-function driver
+ * ========================= */
+
+static int count_alloc_sites(const ASTNode* n) {
+    if (!n) return 0;
+    int count = 0;
+    if (n->type == AST_CALL_EXPR) {
+        const char* fname = call_name(n);
+        if (fname && strcmp(fname, "new_arr") == 0) count++;
+    }
+    for (int i = 0; i < n->child_count; i++) {
+        count += count_alloc_sites(n->children[i]);
+    }
+    return count;
+}
+
+/* Объекты, достижимые из убегающих, тоже убегают */
+static void close_escapes(EscCtx* c) {
+    int grew = 1;
+    while (grew) {
+        grew = 0;
+        for (int i = 0; i < c->frame_count; i++) {
+            if (!os_has(&c->esc, c->sym_base + i)) continue;
+            if (os_union(c, &c->esc, &c->pts[i])) grew = 1;
+        }
+        if (!os_empty(c, &c->esc) && os_union(c, &c->esc, &c->mem)) grew = 1;
+    }
+}
+
+/* Один проход по функции; 1, если сводка изменилась */
+static int analyze_function(EscCtx* c, const ASTNode* func_def, int func, int first_site) {
+    EscapeSummary* sum = &c->info->funcs[func];
+    const ASTNode* body = (func_def->child_count > 1) ? func_def->children[1] : NULL;
+
+    c->func = func;
+    c->scope_id = sum->scope_id;
+    c->mem = os_new(c);
+    c->esc = os_new(c);
+
+    do {
+        c->changed = 0;
+        c->next_site = first_site;
+        walk_statement(c, body);
+    } while (c->changed);
+
+    close_escapes(c);
+
+    /* возвращаемое значение уходит к вызывающему: для параметров это
+       param_to_return, для объектов кадра - побег */
+    Symbol* ret = symbol_table_return_symbol(c->st, sum->name, sum->scope_id);
+    ObjSet returned = os_new(c);
+    int ri = frame_object(c, ret);
+    if (ri >= 0) {
+        if (is_static_array(ret)) os_add(&returned, c->sym_base + ri);
+        else os_union(c, &returned, &c->pts[ri]);
+    }
+
+    /* параметры и объекты кадра функции - символы её области */
+    const Scope* scope = symbol_table_scope(c->st, sum->scope_id);
+    int scope_symbols = scope ? scope->symbol_count : 0;
+
+    int summary_changed = 0;
+    int pi = 0;
+    for (int k = 0; k < scope_symbols && pi < sum->param_count; k++) {
+        Symbol* sym = &c->st->symbols[scope->symbols[k]];
+        if (sym->type != SYM_PARAMETER) continue;
+        int i = frame_object(c, sym);
+        if (i < 0) continue;
+
+        int in_bit = c->param_base + i;
+        int escapes = os_has(&c->esc, in_bit);
+        int to_return = os_has(&returned, in_bit);
+
+        /* флаги только растут - гарантия неподвижной точки */
+        if (escapes && !sum->param_escapes[pi]) { sum->param_escapes[pi] = 1; summary_changed = 1; }
+        if (to_return && !sum->param_to_return[pi]) { sum->param_to_return[pi] = 1; summary_changed = 1; }
+        pi++;
+    }
+
+    os_union(c, &c->esc, &returned);
+    close_escapes(c);
+
+    for (int k = 0; k < scope_symbols; k++) {
+        Symbol* sym = &c->st->symbols[scope->symbols[k]];
+        int i = frame_object(c, sym);
+        if (i < 0) continue;
+
+        int esc = os_has(&c->esc, c->sym_base + i);
+        if (sym->is_array && sym->array_size == 0) {
+            /* динамический массив убегает вместе со своим new_arr */
+            for (int s = 0; s < c->info->alloc_sites && !esc; s++) {
+                if (os_has(&c->pts[i], c->alloc_base + s) && os_has(&c->esc, c->alloc_base + s)) esc = 1;
+            }
+        }
+        if (esc && !sym->escapes) {
+            sym->escapes = 1;
+            summary_changed = 1;
+        }
+        if (os_has(&returned, c->sym_base + i) && !sum->returns_local_address) {
+            sum->returns_local_address = 1;
+            summary_changed = 1;
+        }
+    }
+
+    /* места new_arr этой функции */
+    for (int s = 0; s < c->info->alloc_sites; s++) {
+        if (c->alloc_func[s] == func && os_has(&c->esc, c->alloc_base + s) && !c->alloc_escapes[s]) {
+            c->alloc_escapes[s] = 1;
+            summary_changed = 1;
+        }
+    }
+
+    os_free(&returned);
+    os_free(&c->mem);
+    os_free(&c->esc);
+    return summary_changed;
+}
+
+/* Переменные кадров: символы областей [id, last_id] каждой функции из info */
+static void collect_frames(EscCtx* c) {
+    const SymbolTable* st = c->st;
+    int cap = 16;
+    c->frame_symbols = (int*)malloc((size_t)cap * sizeof(int));
+    int lo = INT_MAX, hi = -1;
+
+    for (int f = 0; f < c->info->func_count && c->frame_symbols; f++) {
+        const Scope* fs = symbol_table_scope(st, c->info->funcs[f].scope_id);
+        if (!fs || fs->type == SCOPE_GLOBAL) continue;
+        for (int id = fs->id; id <= fs->last_id; id++) {
+            const Scope* scope = symbol_table_scope(st, id);
+            for (int k = 0; scope && k < scope->symbol_count; k++) {
+                int i = scope->symbols[k];
+                if (!is_frame_symbol(&st->symbols[i])) continue;
+                if (c->frame_count >= cap) {
+                    cap *= 2;
+                    int* p = (int*)realloc(c->frame_symbols, (size_t)cap * sizeof(int));
+                    if (!p) break;
+                    c->frame_symbols = p;
+                }
+                c->frame_symbols[c->frame_count++] = i;
+                if (i < lo) lo = i;
+                if (i > hi) hi = i;
+            }
+        }
+    }
+
+    c->frame_lo = (hi >= 0) ? lo : 0;
+    c->frame_span = (hi >= 0) ? hi - lo + 1 : 0;
+    c->frame_of = (int*)malloc((size_t)(c->frame_span > 0 ? c->frame_span : 1) * sizeof(int));
+    if (!c->frame_of) {
+        c->frame_count = 0;
+        c->frame_span = 0;
+        return;
+    }
+    for (int i = 0; i < c->frame_span; i++) c->frame_of[i] = -1;
+    for (int v = 0; v < c->frame_count; v++) c->frame_of[c->frame_symbols[v] - c->frame_lo] = v;
+}
+
+/* =========================
+ * Public API
+ * ========================= */
+
+EscapeInfo* escape_analyze(ASTNode* root, SymbolTable* st) {
+    if (!root || !st) return NULL;
+
+    printf("[*] Running escape analysis...\n");
+
+    EscapeInfo* info = (EscapeInfo*)calloc(1, sizeof(EscapeInfo));
+    if (!info) return NULL;
+
+    /* сводки по определённым функциям (не по forward-объявлениям) */
+    int cap = root->child_count > 0 ? root->child_count : 1;
+    info->funcs = (EscapeSummary*)calloc((size_t)cap, sizeof(EscapeSummary));
+    int* first_site = (int*)calloc((size_t)cap, sizeof(int));
+    const ASTNode** defs = (const ASTNode**)calloc((size_t)cap, sizeof(ASTNode*));
+    int* def_func = (int*)calloc((size_t)cap, sizeof(int));
+    int def_count = 0;
+
+    for (int i = 0; i < root->child_count; i++) {
+        const ASTNode* fd = root->children[i];
+        if (!fd || fd->type != AST_FUNCTION_DEF || fd->child_count < 2) continue;
+        const ASTNode* sig = fd->children[0];
+        if (!sig || sig->type != AST_FUNCTION_SIGNATURE || !sig->value) continue;
+
+        int f = find_func(info, sig->value);
+        if (f < 0) {
+            Scope* scope = symbol_table_find_function_scope(st, sig->value);
+            f = info->func_count++;
+            EscapeSummary* sum = &info->funcs[f];
+            sum->name = esc_strdup(sig->value);
+            sum->scope_id = scope ? scope->id : 1;
+
+            Scope* func_scope = symbol_table_scope(st, sum->scope_id);
+            for (int k = 0; func_scope && k < func_scope->symbol_count; k++) {
+                if (st->symbols[func_scope->symbols[k]].type == SYM_PARAMETER) sum->param_count++;
+            }
+            sum->param_escapes = (int*)calloc((size_t)(sum->param_count + 1), sizeof(int));
+            sum->param_to_return = (int*)calloc((size_t)(sum->param_count + 1), sizeof(int));
+        }
+
+        defs[def_count] = fd;
+        def_func[def_count] = f;
+        first_site[def_count] = info->alloc_sites;
+        info->alloc_sites += count_alloc_sites(fd->children[1]);
+        def_count++;
+    }
+
+    EscCtx c;
+    memset(&c, 0, sizeof(c));
+    c.st = st;
+    c.info = info;
+    collect_frames(&c);
+    c.sym_base = 0;
+    c.alloc_base = c.frame_count;
+    c.param_base = c.frame_count + info->alloc_sites;
+    c.nobj = 2 * c.frame_count + info->alloc_sites;
+    c.nwords = (c.nobj + 31) / 32;
+    c.pts = (ObjSet*)calloc((size_t)(c.frame_count > 0 ? c.frame_count : 1), sizeof(ObjSet));
+    c.alloc_func = (int*)calloc((size_t)(info->alloc_sites + 1), sizeof(int));
+    c.alloc_line = (int*)calloc((size_t)(info->alloc_sites + 1), sizeof(int));
+    c.alloc_escapes = (int*)calloc((size_t)(info->alloc_sites + 1), sizeof(int));
+
+    for (int i = 0; i < c.frame_count; i++) {
+        c.pts[i] = os_new(&c);
+        /* параметр изначально содержит значение вызывающего */
+        if (st->symbols[c.frame_symbols[i]].type == SYM_PARAMETER) os_add(&c.pts[i], c.param_base + i);
+    }
+
+    /* неподвижная точка по графу вызовов: сводки только растут */
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        info->iterations++;
+        for (int d = 0; d < def_count; d++) {
+            if (analyze_function(&c, defs[d], def_func[d], first_site[d])) changed = 1;
+        }
+    }
+
+    for (int i = 0; i < c.frame_count; i++) {
+        const Symbol* sym = &st->symbols[c.frame_symbols[i]];
+        if (sym->is_address_taken) info->address_taken++;
+        if (sym->escapes) info->escaping_locals++;
+    }
+
+    for (int s = 0; s < info->alloc_sites; s++) {
+        if (!c.alloc_escapes[s]) continue;
+        int line = c.alloc_line[s];
+        info->escaping_allocs++;
+        /* кучи в рантайме нет: new_arr всегда выделяет в стеке кадра */
+        TRACE(TRACE_SEMANTIC, TRACE_WARN, "  [WARNING] new_arr in '%s' (line %d) escapes its frame; it is still allocated on the stack\n",
+            info->funcs[c.alloc_func[s]].name, line);
+    }
+
+    for (int f = 0; f < info->func_count; f++) {
+        if (info->funcs[f].returns_local_address) {
+            TRACE(TRACE_SEMANTIC, TRACE_WARN, "  [WARNING] Function '%s' may return the address of its own stack frame\n",
+                info->funcs[f].name);
+        }
+    }
+
+    st->escape_analyzed = 1;
+
+    for (int i = 0; i < c.frame_count; i++) os_free(&c.pts[i]);
+    free(c.pts);
+    free(c.frame_symbols);
+    free(c.frame_of);
+    free(c.alloc_func);
+    free(c.alloc_line);
+    free(c.alloc_escapes);
+    free(first_site);
+    free(defs);
+    free(def_func);
+
+    printf("[+] Escape analysis complete (%d iteration(s))\n", info->iterations);
+    return info;
+}
+
+const EscapeSummary* escape_find_summary(const EscapeInfo* info, const char* func_name) {
+    int f = find_func(info, func_name);
+    return (f >= 0) ? &info->funcs[f] : NULL;
+}
+
+void escape_print_summary(const EscapeInfo* info, const SymbolTable* st) {
+    if (!info) return;
+
+    printf("\n════════════════════════════════════════════════════════════\n");
+    printf("ESCAPE ANALYSIS:\n");
+    printf("════════════════════════════════════════════════════════════\n");
+
+    for (int f = 0; f < info->func_count; f++) {
+        const EscapeSummary* sum = &info->funcs[f];
+        printf("  %s (scope %d):", sum->name, sum->scope_id);
+        if (sum->param_count == 0) printf(" no params");
+        for (int i = 0; i < sum->param_count; i++) {
+            printf(" p%d=%s%s", i,
+                sum->param_escapes[i] ? "escapes" : "local",
+                sum->param_to_return[i] ? "+returned" : "");
+        }
+        printf("\n");
+
+        const Scope* scope = symbol_table_scope(st, sum->scope_id);
+        if (!scope) continue;
+        for (int k = 0; k < scope->symbol_count; k++) {
+            const Symbol* sym = &st->symbols[scope->symbols[k]];
+            if (sym->type != SYM_LOCAL && sym->type != SYM_PARAMETER) continue;
+            printf("    %-12s %s%s\n", sym->name,
+                sym->escapes ? "escapes" : "frame-local",
+                sym->is_address_taken ? ", address taken" : "");
+        }
+    }
+
+    printf("  new_arr sites: %d (escaping: %d)\n", info->alloc_sites, info->escaping_allocs);
+    printf("  Address-taken locals: %d, escaping locals: %d\n",
+        info->address_taken, info->escaping_locals);
+}
+
+void escape_free(EscapeInfo* info) {
+    if (!info) return;
+    for (int f = 0; f < info->func_count; f++) {
+        free(info->funcs[f].name);
+        free(info->funcs[f].param_escapes);
+        free(info->funcs[f].param_to_return);
+    }
+    free(info->funcs);
+    free(info);
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+#ifndef ESCAPE_H
+#define ESCAPE_H
+
+#include "ast.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Escape analysis (после semantic_analyze, до построения CFG).
+     *
+     * Потоко-нечувствительный points-to анализ по AST каждой функции:
+     *   - объекты: слоты локальных переменных/параметров, места вызова new_arr,
+     *     и "входящие" значения параметров;
+     *   - источники адресов: AST_ADDR_OF, имя статического массива,
+     *     аргументы read_din/write_din (ABI передаёт указатель), new_arr(n);
+     *   - объект убегает, если попадает в глобальную переменную, в возвращаемое
+     *     значение, в неизвестную функцию или в параметр, который убегает у вызываемой.
+     *
+     * Межпроцедурная часть - сводки по функциям (param_escapes / param_to_return),
+     * пересчитываемые до неподвижной точки по графу вызовов.
+     *
+     * Результат записывается в Symbol.is_address_taken / Symbol.escapes,
+     * после чего выставляется st->escape_analyzed.
+     */
+
+    typedef struct {
+        char* name;               /* имя функции */
+        int scope_id;             /* область видимости функции */
+        int param_count;
+        int* param_escapes;       /* [i] = 1: аргумент i переживает вызов */
+        int* param_to_return;     /* [i] = 1: аргумент i может вернуться */
+        int returns_local_address;/* возвращает адрес собственного кадра */
+    } EscapeSummary;
+
+    typedef struct {
+        EscapeSummary* funcs;
+        int func_count;
+
+        int alloc_sites;          /* всего вызовов new_arr */
+        int escaping_allocs;      /* из них убегают */
+        int address_taken;        /* локальных с взятым адресом */
+        int escaping_locals;      /* локальных, переживающих кадр */
+        int iterations;           /* проходов до неподвижной точки */
+    } EscapeInfo;
+
+    /* Анализ программы (root = AST_PROGRAM). NULL при ошибке. */
+    EscapeInfo* escape_analyze(ASTNode* root, SymbolTable* st);
+
+    /* Сводка по функции (NULL, если функции нет) */
+    const EscapeSummary* escape_find_summary(const EscapeInfo* info, const char* func_name);
+
+    void escape_print_summary(const EscapeInfo* info, const SymbolTable* st);
+    void escape_free(EscapeInfo* info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,185 @@
+﻿#include "framelayout.h"
+#include "liveness.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Размер элемента/скаляра (согласован с semantic.c и codegen.c) */
+static int fl_elem_size(const Symbol* sym) {
+    if (sym->is_array && sym->array_size == 0) return 4; /* ссылка на динамический массив */
+    return sym->dtype ? type_element(sym->dtype)->size : 4;
+}
+
+/* Объект не может делить слот ни с кем */
+static int fl_pinned(const Symbol* sym) {
+    return sym->is_array || sym->is_address_taken || sym->escapes;
+}
+
+typedef struct {
+    int size;      /* байт */
+    int align;     /* 4 или 8 */
+    int elem;      /* размер элемента (оффсет указывает на верхний элемент) */
+    int offset;    /* итоговый оффсет объектов слота */
+} Slot;
+
+static int fl_align_down(int v, int a) {
+    /* v <= 0 */
+    int r = v % a;
+    if (r != 0) v -= (a + r);
+    return v;
+}
+
+/* интерференция в одной точке: одновременно живы, либо запись при живой другой */
+static void fl_interfere(const int* loc, int nloc, unsigned char* interf,
+    const uint32_t* in, const uint32_t* out, const uint32_t* def) {
+    for (int a = 0; a < nloc; a++) {
+        int va = loc[a];
+        int a_in = liveness_bit(in, va), a_out = liveness_bit(out, va), a_def = liveness_bit(def, va);
+        if (!a_in && !a_out && !a_def) continue;
+        for (int b = a + 1; b < nloc; b++) {
+            int vb = loc[b];
+            if ((a_in && liveness_bit(in, vb)) ||
+                (a_out && liveness_bit(out, vb)) ||
+                (a_def && liveness_bit(out, vb)) ||
+                (liveness_bit(def, vb) && a_out)) {
+                interf[a * nloc + b] = interf[b * nloc + a] = 1;
+            }
+        }
+    }
+}
+
+static void fl_layout_function(const CFG* cfg, SymbolTable* st, const CFGFunction* fn, FrameLayoutStats* stats) {
+    Liveness* lv = liveness_compute(cfg, st, fn);
+    if (!lv) return;
+
+    Scope* func_scope = symbol_table_scope(st, lv->scope_id);
+    if (!func_scope || func_scope->type != SCOPE_FUNCTION) {
+        liveness_free(lv);
+        return;
+    }
+
+    /* локальные переменные в порядке объявления */
+    int nloc = 0;
+    int* loc = (int*)malloc((size_t)(lv->var_count > 0 ? lv->var_count : 1) * sizeof(int));
+    for (int v = 0; v < lv->var_count; v++) {
+        if (st->symbols[lv->vars[v]].type == SYM_LOCAL) loc[nloc++] = v;
+    }
+
+    /* интерференция на границах узлов и между операторами блока (с конца) */
+    unsigned char* interf = (unsigned char*)calloc((size_t)(nloc > 0 ? nloc * nloc : 1), 1);
+    size_t words = (size_t)lv->words;
+    uint32_t* live_after = (uint32_t*)malloc(3 * words * sizeof(uint32_t));
+    uint32_t* live_before = live_after + words;
+    uint32_t* def = live_before + words;
+    for (int p = 0; p < lv->node_count; p++) {
+        fl_interfere(loc, nloc, interf, liveness_row(lv, lv->live_in, p),
+            liveness_row(lv, lv->live_out, p), liveness_row(lv, lv->def, p));
+
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(cfg->nodes[lv->nodes[p]], &count);
+        if (count < 2) continue;
+        memcpy(live_after, liveness_row(lv, lv->live_out, p), words * sizeof(uint32_t));
+        for (int i = count - 1; i >= 0; i--) {
+            memcpy(live_before, live_after, words * sizeof(uint32_t));
+            liveness_step(lv, exprs[i], live_before, def);
+            fl_interfere(loc, nloc, interf, live_before, live_after, def);
+            memcpy(live_after, live_before, words * sizeof(uint32_t));
+        }
+    }
+    free(live_after);
+
+    /* раскраска: первый подходящий слот того же размера */
+    Slot* slots = (Slot*)calloc((size_t)(nloc > 0 ? nloc : 1), sizeof(Slot));
+    int* slot_of = (int*)malloc((size_t)(nloc > 0 ? nloc : 1) * sizeof(int));
+    int nslots = 0;
+    for (int a = 0; a < nloc; a++) {
+        const Symbol* sym = &st->symbols[lv->vars[loc[a]]];
+        int elem = fl_elem_size(sym);
+        int size = sym->size > 0 ? sym->size : elem;
+        int chosen = -1;
+
+        if (!fl_pinned(sym)) {
+            for (int s = 0; s < nslots && chosen < 0; s++) {
+                if (slots[s].size != size || slots[s].elem != elem) continue;
+                int ok = 1;
+                for (int b = 0; b < a && ok; b++) {
+                    if (slot_of[b] != s) continue;
+                    if (fl_pinned(&st->symbols[lv->vars[loc[b]]]) || interf[a * nloc + b]) ok = 0;
+                }
+                if (ok) chosen = s;
+            }
+        }
+
+        if (chosen < 0) {
+            chosen = nslots++;
+            slots[chosen].size = size;
+            slots[chosen].elem = elem;
+            slots[chosen].align = (elem == 8) ? 8 : 4;
+        }
+        else {
+            stats->shared++;
+        }
+        slot_of[a] = chosen;
+        stats->locals++;
+    }
+
+    /* размещение: сначала 8-байтовые слоты (выравнивание без дыр), затем остальные.
+       Объект занимает [offset + elem - size, offset + elem). */
+    int cursor = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int s = 0; s < nslots; s++) {
+            if ((slots[s].align == 8) != (pass == 0)) continue;
+            int low = fl_align_down(cursor - slots[s].size, slots[s].align);
+            slots[s].offset = low + slots[s].size - slots[s].elem;
+            cursor = low;
+        }
+    }
+
+    int before = -func_scope->local_offset;
+    for (int a = 0; a < nloc; a++) {
+        st->symbols[lv->vars[loc[a]]].offset = slots[slot_of[a]].offset;
+    }
+    /* тот же инвариант, что и в semantic.c: кадр = -local_offset */
+    func_scope->local_offset = cursor - 4;
+
+    stats->functions++;
+    stats->bytes_before += before;
+    stats->bytes_after += -func_scope->local_offset;
+
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "  %s: frame %d -> %d bytes (%d local(s), %d slot(s))\n",
+        lv->name, before, -func_scope->local_offset, nloc, nslots);
+
+    free(slots);
+    free(slot_of);
+    free(interf);
+    free(loc);
+    liveness_free(lv);
+}
+
+FrameLayoutStats frame_layout_run(const CFG* cfg, SymbolTable* st) {
+    FrameLayoutStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!cfg || !st) return stats;
+
+    printf("[*] Laying out stack frames...\n");
+
+    /* функция с несколькими узлами входа (forward-объявление) раскладывается один раз */
+    int* done_scopes = (int*)calloc((size_t)(st->scope_count + 2), sizeof(int));
+    for (int f = 0; f < cfg->function_count; f++) {
+        int scope_id = cfg->functions[f].scope_id;
+        if (scope_id <= 0 || scope_id > st->scope_count + 1 || done_scopes[scope_id]) continue;
+        done_scopes[scope_id] = 1;
+        fl_layout_function(cfg, st, &cfg->functions[f], &stats);
+    }
+    free(done_scopes);
+
+    return stats;
+}
+
+void frame_layout_print_stats(const FrameLayoutStats* stats) {
+    if (!stats) return;
+    printf("[+] Frame layout: %d function(s), %d local(s), %d shared a slot, %d -> %d bytes\n",
+        stats->functions, stats->locals, stats->shared, stats->bytes_before, stats->bytes_after);
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+#ifndef FRAMELAYOUT_H
+#define FRAMELAYOUT_H
+
+#include "cfg.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Раскладка кадров (после построения CFG, до codegen).
+     *
+     * semantic.c раздаёт локальным последовательные оффсеты, поэтому
+     * переменные с непересекающимися временами жизни никогда не делят слот.
+     * Этот проход строит граф интерференции по живости в CFG функции и
+     * раскрашивает локальные в общие слоты:
+     *   - массивы и переменные с взятым адресом получают собственный слот;
+     *   - делят слот только объекты одного размера;
+     *   - 8-байтовые объекты (din/long/ulong) выравниваются на 8 от fp.
+     *
+     * Пересчитываются Symbol.offset локальных и Scope.local_offset функции
+     * (по нему codegen считает размер кадра).
+     */
+
+    typedef struct {
+        int functions;        /* обработано функций */
+        int locals;           /* локальных переменных */
+        int shared;           /* из них попали в уже занятый слот */
+        int bytes_before;     /* сумма кадров до раскладки */
+        int bytes_after;      /* после */
+    } FrameLayoutStats;
+
+    FrameLayoutStats frame_layout_run(const CFG* cfg, SymbolTable* st);
+    void frame_layout_print_stats(const FrameLayoutStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,537 @@
+﻿#include "lexer.h"
+#include "compiler.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEXER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+struct Lexer {
+    struct CompilerContext* ctx;
+    int file;
+    const char* base;
+    const char* cur;
+    const char* end;
+
+    const char* tok;            /* последняя лексема - для yyget_text */
+    int tok_len;
+    char text[256];
+};
+
+Lexer* lexer_create(struct CompilerContext* ctx, int file) {
+    const SourceBuffer* src = ctx ? source_manager_buffer(ctx->sources, file) : NULL;
+    if (!src) return NULL;
+    Lexer* lx = (Lexer*)calloc(1, sizeof(Lexer));
+    if (!lx) return NULL;
+    lx->ctx = ctx;
+    lx->file = file;
+    lx->base = src->data;
+    lx->cur = src->data;
+    lx->end = src->data + src->size;
+    lx->tok = src->data;
+    return lx;
+}
+
+void lexer_free(Lexer* lx) {
+    free(lx);
+}
+
+/* =========================
+ * Классы символов
+ * ========================= */
+
+static int lex_is_digit(unsigned char c) {
+    return (unsigned)(c - '0') < 10u;
+}
+
+static int lex_is_ident_start(unsigned char c) {
+    return (unsigned)((c | 0x20) - 'a') < 26u || c == '_';
+}
+
+static int lex_is_ident_char(unsigned char c) {
+    return lex_is_ident_start(c) || lex_is_digit(c);
+}
+
+static int lex_is_hex_digit(unsigned char c) {
+    return lex_is_digit(c) || (unsigned)((c | 0x20) - 'a') < 6u;
+}
+
+#ifdef LEXER_SSE2
+static unsigned lex_ctz(unsigned m) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, m);
+    return (unsigned)i;
+#else
+    return (unsigned)__builtin_ctz(m);
+#endif
+}
+
+static int lex_popcount16(unsigned m) {
+    m = m - ((m >> 1) & 0x5555u);
+    m = (m & 0x3333u) + ((m >> 2) & 0x3333u);
+    m = (m + (m >> 4)) & 0x0F0Fu;
+    return (int)((m + (m >> 8)) & 0x1Fu);
+}
+#endif
+
+/* =========================
+ * Пропуск пробелов и комментариев
+ * ========================= */
+
+static void lex_skip_blanks(Lexer* lx) {
+    const char* p = lx->cur;
+    const char* end = lx->end;
+    int lines = 0;
+
+#ifdef LEXER_SSE2
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        __m128i n = _mm_cmpeq_epi8(v, nl);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, cr), n));
+        unsigned stop = ~(unsigned)_mm_movemask_epi8(ws) & 0xFFFFu;
+        unsigned nlm = (unsigned)_mm_movemask_epi8(n);
+        if (stop) {
+            unsigned k = lex_ctz(stop);
+            lines += lex_popcount16(nlm & ((1u << k) - 1u));
+            p += k;
+            lx->cur = p;
+            lx->ctx->line_num += lines;
+            return;
+        }
+        lines += lex_popcount16(nlm);
+        p += 16;
+    }
+#endif
+
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        if (*p == '\n') lines++;
+        p++;
+    }
+    lx->cur = p;
+    lx->ctx->line_num += lines;
+}
+
+/* "//" до конца строки; сам '\n' остаётся для lex_skip_blanks */
+static const char* lex_line_end(const char* p, const char* end) {
+#ifdef LEXER_SSE2
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+        if (m) return p + lex_ctz(m);
+        p += 16;
+    }
+#endif
+    const char* q = (const char*)memchr(p, '\n', (size_t)(end - p));
+    return q ? q : end;
+}
+
+/* тело блочного комментария (lx->cur - сразу после открывающих '/' '*');
+   незакрытый комментарий тянется до конца файла */
+static void lex_skip_block_comment(Lexer* lx) {
+    const char* p = lx->cur;
+    const char* end = lx->end;
+    int lines = 0;
+
+    for (;;) {
+#ifdef LEXER_SSE2
+        const __m128i star = _mm_set1_epi8('*');
+        const __m128i nl = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)p);
+            unsigned sm = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, star));
+            unsigned nlm = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+            if (sm) {
+                unsigned k = lex_ctz(sm);
+                lines += lex_popcount16(nlm & ((1u << k) - 1u));
+                p += k;
+                break;
+            }
+            lines += lex_popcount16(nlm);
+            p += 16;
+        }
+#endif
+        while (p < end && *p != '*') {
+            if (*p == '\n') lines++;
+            p++;
+        }
+        if (p >= end) break;
+        if (p + 1 < end && p[1] == '/') {
+            p += 2;
+            break;
+        }
+        p++;
+    }
+
+    lx->cur = p;
+    lx->ctx->line_num += lines;
+}
+
+/* =========================
+ * Идентификаторы и ключевые слова
+ * ========================= */
+
+static const char* lex_ident_end(const char* p, const char* end) {
+#ifdef LEXER_SSE2
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i a1 = _mm_set1_epi8('a' - 1), z1 = _mm_set1_epi8('z' + 1);
+    const __m128i d0 = _mm_set1_epi8('0' - 1), d9 = _mm_set1_epi8('9' + 1);
+    const __m128i us = _mm_set1_epi8('_');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        /* байты >= 0x80 при знаковом сравнении отрицательны - не буквы */
+        __m128i lower = _mm_or_si128(v, case_bit);
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, a1), _mm_cmplt_epi8(lower, z1));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, d0), _mm_cmplt_epi8(v, d9));
+        __m128i ok = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, us));
+        unsigned stop = ~(unsigned)_mm_movemask_epi8(ok) & 0xFFFFu;
+        if (stop) return p + lex_ctz(stop);
+        p += 16;
+    }
+#endif
+    while (p < end && lex_is_ident_char((unsigned char)*p)) p++;
+    return p;
+}
+
+typedef struct {
+    const char* word;
+    int len;
+    int token;
+} LexKeyword;
+
+/* h = (2*w[0] + 11*w[1] + w[len-1] + len) & 63 - без коллизий на этом наборе */
+static const LexKeyword lex_keywords[64] = {
+    [3] = { "int", 3, INT_TYPE },
+    [8] = { "long", 4, LONG_TYPE },
+    [12] = { "var", 3, VAR },
+    [14] = { "begin", 5, BEGIN_KW },
+    [15] = { "string", 6, STRING_TYPE },
+    [16] = { "while", 5, WHILE },
+    [18] = { "then", 4, THEN },
+    [21] = { "until", 5, UNTIL },
+    [23] = { "else", 4, ELSE },
+    [26] = { "break", 5, BREAK },
+    [27] = { "method", 6, METHOD },
+    [28] = { "if", 2, IF },
+    [32] = { "byte", 4, BYTE_TYPE },
+    [33] = { "false", 5, BOOL_LITERAL },
+    [37] = { "uint", 4, UINT_TYPE },
+    [38] = { "array", 5, ARRAY },
+    [40] = { "of", 2, OF },
+    [41] = { "float", 5, FLOAT_TYPE },
+    [43] = { "end", 3, END },
+    [52] = { "char", 4, CHAR_TYPE },
+    [53] = { "repeat", 6, REPEAT },
+    [55] = { "true", 4, BOOL_LITERAL },
+    [57] = { "bool", 4, BOOL_TYPE },
+    [58] = { "ulong", 5, ULONG_TYPE },
+    [60] = { "din", 3, DIN_TYPE },
+    [62] = { "do", 2, DO },
+};
+
+/* токен ключевого слова или 0 */
+static int lex_keyword(const char* s, int len) {
+    if (len < 2 || len > 6) return 0;
+    const unsigned char* u = (const unsigned char*)s;
+    unsigned h = (2u * u[0] + 11u * u[1] + u[len - 1] + (unsigned)len) & 63u;
+    const LexKeyword* k = &lex_keywords[h];
+    if (k->len != len || memcmp(k->word, s, (size_t)len) != 0) return 0;
+    return k->token;
+}
+
+/* =========================
+ * Лексемы
+ * ========================= */
+
+static int lex_emit(Lexer* lx, const char* start, const char* stop, int token) {
+    TRACE(TRACE_LEXER, TRACE_DEBUG, "  [LEX] %u: token %d '%.*s'\n",
+        (unsigned)(start - lx->base), token, (int)(stop - start), start);
+    lx->tok = start;
+    lx->tok_len = (int)(stop - start);
+    lx->cur = stop;
+    return token;
+}
+
+static SourceSpan lex_span(const Lexer* lx, const char* start, int len) {
+    SourceSpan span;
+    span.file = lx->file;
+    span.offset = (unsigned)(start - lx->base);
+    span.length = (unsigned)len;
+    return span;
+}
+
+static int lex_emit_slice(Lexer* lx, YYSTYPE* lval, const char* start, const char* stop, int token) {
+    lval->tok.text = start;
+    lval->tok.span = lex_span(lx, start, (int)(stop - start));
+    lval->tok.literal.kind = LIT_NONE;
+    lval->tok.literal.overflow = 0;
+    lval->tok.literal.value = 0;
+    return lex_emit(lx, start, stop, token);
+}
+
+/* =========================
+ * Значения литералов (один раз, при чтении лексемы)
+ * ========================= */
+
+/* Цифры [p, end) по основанию base; больше 32 бит - overflow */
+static void lex_decode_int(LiteralValue* lit, const char* p, const char* end, unsigned base) {
+    uint64_t v = 0;
+    lit->kind = LIT_INT;
+    for (; p < end; p++) {
+        unsigned c = (unsigned char)*p;
+        unsigned d = lex_is_digit(c) ? c - '0' : (c | 0x20) - 'a' + 10;
+        v = v * base + d;
+        if (v > 0xFFFFFFFFu) {
+            lit->overflow = 1;
+            v = 0xFFFFFFFFu;
+        }
+    }
+    lit->value = (int64_t)v;
+}
+
+/* Вещественное -> Q16.16; вне int32 - overflow */
+static void lex_decode_fixed(LiteralValue* lit, const char* p, const char* end) {
+    char buf[64];
+    size_t n = (size_t)(end - p);
+    char* text = n < sizeof(buf) ? buf : (char*)malloc(n + 1);
+    lit->kind = LIT_FIXED;
+    if (!text) {
+        lit->overflow = 1;
+        return;
+    }
+    memcpy(text, p, n);
+    text[n] = '\0';
+    double scaled = strtod(text, NULL) * 65536.0;
+    if (text != buf) free(text);
+
+    if (!(scaled > -2147483649.0 && scaled < 2147483648.0)) {
+        lit->overflow = 1;
+        lit->value = scaled < 0 ? INT32_MIN : INT32_MAX;
+        return;
+    }
+    long long q = llround(scaled);
+    if (q > INT32_MAX || q < INT32_MIN) {
+        lit->overflow = 1;
+        q = q > 0 ? INT32_MAX : INT32_MIN;
+    }
+    lit->value = q;
+}
+
+/* 'c' или '\c' (форма уже проверена lex_char_end) */
+static void lex_decode_char(LiteralValue* lit, const char* p) {
+    lit->kind = LIT_CHAR;
+    if (p[1] != '\\') {
+        lit->value = (unsigned char)p[1];
+        return;
+    }
+    switch (p[2]) {
+    case 'n': lit->value = 10; break;
+    case 'r': lit->value = 13; break;
+    case 't': lit->value = 9; break;
+    case '0': lit->value = 0; break;
+    default:  lit->value = (unsigned char)p[2]; break;
+    }
+}
+
+/* Числа с тем же выбором самого длинного совпадения, что у правил lexer.l:
+   HEX 0x.., BINARY 0b.., FLOAT (d+.d* | d*.d+)(e[+-]d+)? | d+e[+-]d+, INTEGER d+.
+   -1 - не число (одиночная точка) */
+static int lex_number(Lexer* lx, YYSTYPE* lval) {
+    const char* s = lx->cur;
+    const char* end = lx->end;
+
+    if (end - s >= 3 && s[0] == '0') {
+        unsigned char c1 = (unsigned char)(s[1] | 0x20);
+        if (c1 == 'x' && lex_is_hex_digit((unsigned char)s[2])) {
+            const char* p = s + 2;
+            while (p < end && lex_is_hex_digit((unsigned char)*p)) p++;
+            int t = lex_emit_slice(lx, lval, s, p, HEX_LITERAL);
+            lex_decode_int(&lval->tok.literal, s + 2, p, 16);
+            return t;
+        }
+        if (c1 == 'b' && (s[2] == '0' || s[2] == '1')) {
+            const char* p = s + 2;
+            while (p < end && (*p == '0' || *p == '1')) p++;
+            int t = lex_emit_slice(lx, lval, s, p, BITS_LITERAL);
+            lex_decode_int(&lval->tok.literal, s + 2, p, 2);
+            return t;
+        }
+    }
+
+    const char* d = s;
+    while (d < end && lex_is_digit((unsigned char)*d)) d++;
+
+    const char* q = d;
+    int is_float = 0;
+    if (q < end && *q == '.' && (d > s || (q + 1 < end && lex_is_digit((unsigned char)q[1])))) {
+        q++;
+        while (q < end && lex_is_digit((unsigned char)*q)) q++;
+        is_float = 1;
+    }
+    if (d == s && !is_float) return -1;
+
+    /* экспонента - только целиком */
+    if (q < end && (*q | 0x20) == 'e') {
+        const char* e = q + 1;
+        if (e < end && (*e == '+' || *e == '-')) e++;
+        if (e < end && lex_is_digit((unsigned char)*e)) {
+            while (e < end && lex_is_digit((unsigned char)*e)) e++;
+            q = e;
+            is_float = 1;
+        }
+    }
+
+    int t;
+    if (is_float) {
+        t = lex_emit_slice(lx, lval, s, q, FLOAT_LITERAL);
+        lex_decode_fixed(&lval->tok.literal, s, q);
+        return t;
+    }
+
+    /* десятичное; ведущие нули не делают его восьмеричным */
+    t = lex_emit_slice(lx, lval, s, d, INT_LITERAL);
+    lex_decode_int(&lval->tok.literal, s, d, 10);
+    return t;
+}
+
+/* "..." с escape-последовательностями, без перевода строки; NULL - не закрыт */
+static const char* lex_string_end(const char* p, const char* end) {
+    p++;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') return p + 1;
+        if (c == '\n') return NULL;
+        if (c == '\\') {
+            if (p + 1 >= end || p[1] == '\n') return NULL;
+            p += 2;
+            continue;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/* 'c' или '\c'; NULL - не символьный литерал */
+static const char* lex_char_end(const char* p, const char* end) {
+    if (end - p >= 4 && p[1] == '\\' && p[2] != '\n' && p[3] == '\'') return p + 4;
+    if (end - p >= 3 && p[1] != '\'' && p[1] != '\\' && p[1] != '\n' && p[2] == '\'') return p + 3;
+    return NULL;
+}
+
+static int lex_unknown(Lexer* lx, const char* p) {
+    SourceLocation loc = source_span_location(lx->ctx->sources, lex_span(lx, p, 1));
+    fprintf(stderr, "%s:%d:%d: Unknown character '%c'\n", loc.path, loc.line, loc.column, *p);
+    return lex_emit(lx, p, p + 1, (unsigned char)*p);
+}
+
+int yylex(YYSTYPE* yylval_param, yyscan_t scanner) {
+    Lexer* lx = (Lexer*)scanner;
+    const char* end = lx->end;
+    const char* p;
+
+    for (;;) {
+        lex_skip_blanks(lx);
+        p = lx->cur;
+        if (p >= end) return lex_emit(lx, p, p, 0);
+        if (p[0] == '/' && p + 1 < end && p[1] == '/') {
+            lx->cur = lex_line_end(p + 2, end);
+            continue;
+        }
+        if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+            lx->cur = p + 2;
+            lex_skip_block_comment(lx);
+            continue;
+        }
+        break;
+    }
+
+    unsigned char c = (unsigned char)*p;
+    char next = (p + 1 < end) ? p[1] : '\0';
+
+    if (lex_is_ident_start(c)) {
+        const char* q = lex_ident_end(p + 1, end);
+        int kw = lex_keyword(p, (int)(q - p));
+        if (kw == BOOL_LITERAL) {
+            int t = lex_emit_slice(lx, yylval_param, p, q, BOOL_LITERAL);
+            yylval_param->tok.literal.kind = LIT_BOOL;
+            yylval_param->tok.literal.value = (*p == 't');
+            return t;
+        }
+        if (kw) return lex_emit(lx, p, q, kw);
+        return lex_emit_slice(lx, yylval_param, p, q, IDENTIFIER);
+    }
+
+    if (lex_is_digit(c) || c == '.') {
+        int t = lex_number(lx, yylval_param);
+        if (t >= 0) return t;
+        return lex_unknown(lx, p);
+    }
+
+    switch (c) {
+    case ':': return next == '=' ? lex_emit(lx, p, p + 2, ASSIGN) : lex_emit(lx, p, p + 1, COLON);
+    case '=': return next == '=' ? lex_emit(lx, p, p + 2, EQ) : lex_unknown(lx, p);
+    case '!': return next == '=' ? lex_emit(lx, p, p + 2, NE) : lex_emit(lx, p, p + 1, NOT);
+    case '<': return next == '=' ? lex_emit(lx, p, p + 2, LE) : lex_emit(lx, p, p + 1, LT);
+    case '>': return next == '=' ? lex_emit(lx, p, p + 2, GE) : lex_emit(lx, p, p + 1, GT);
+    case '&': return next == '&' ? lex_emit(lx, p, p + 2, AND) : lex_unknown(lx, p);
+    case '|': return next == '|' ? lex_emit(lx, p, p + 2, OR) : lex_unknown(lx, p);
+
+    case '+': return lex_emit(lx, p, p + 1, PLUS);
+    case '-': return lex_emit(lx, p, p + 1, MINUS);
+    case '*': return lex_emit(lx, p, p + 1, MUL);
+    case '/': return lex_emit(lx, p, p + 1, DIV);
+    case '%': return lex_emit(lx, p, p + 1, MOD);
+
+    case '(': return lex_emit(lx, p, p + 1, LPAREN);
+    case ')': return lex_emit(lx, p, p + 1, RPAREN);
+    case '[': return lex_emit(lx, p, p + 1, LBRACKET);
+    case ']': return lex_emit(lx, p, p + 1, RBRACKET);
+    case ',': return lex_emit(lx, p, p + 1, COMMA);
+    case ';': return lex_emit(lx, p, p + 1, SEMICOLON);
+
+    case '"': {
+        const char* q = lex_string_end(p, end);
+        return q ? lex_emit_slice(lx, yylval_param, p, q, STRING_LITERAL) : lex_unknown(lx, p);
+    }
+    case '\'': {
+        const char* q = lex_char_end(p, end);
+        if (!q) return lex_unknown(lx, p);
+        int t = lex_emit_slice(lx, yylval_param, p, q, CHAR_LITERAL);
+        lex_decode_char(&yylval_param->tok.literal, p);
+        return t;
+    }
+
+    default:
+        return lex_unknown(lx, p);
+    }
+}
+
+char* yyget_text(yyscan_t scanner) {
+    Lexer* lx = (Lexer*)scanner;
+    size_t n = (size_t)lx->tok_len;
+    if (n > sizeof(lx->text) - 1) n = sizeof(lx->text) - 1;
+    if (n > 0) memcpy(lx->text, lx->tok, n);
+    lx->text[n] = '\0';
+    return lx->text;
+}
+
+SourceSpan lexer_token_span(yyscan_t scanner) {
+    Lexer* lx = (Lexer*)scanner;
+    return lex_span(lx, lx->tok, lx->tok_len);
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <stddef.h>
+#include "parser.tab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Рукописный реентерабельный сканер (вместо flex-сканера lexer.l).
+     *
+     * Работает по буферу файла из ctx->sources (source.h, обычно mmap),
+     * состояния - только указатель на текущий байт, номер строки пишется в
+     * ctx->line_num. Идентификаторы и литералы возвращаются как SourceToken:
+     * указатель в буфер и диапазон (файл, смещение, длина), без копии.
+     * Значение числового, символьного и логического литерала разбирается
+     * здесь же, один раз (SourceToken.literal).
+     *
+     * Пробелы, комментарии и хвосты идентификаторов пропускаются блоками
+     * по 16 байт (SSE2) при наличии, иначе побайтово. Ключевые слова
+     * распознаются совершенным хешем по первым двум, последнему символу
+     * и длине.
+     *
+     * Поток лексем совпадает с прежним lexer.l, кроме двух мест:
+     *   - '\r' - пробел, строки считаются только по '\n' (CRLF без двойного счёта);
+     *   - блочный комментарий закрывается первой же парой '*' '/' (в lexer.l
+     *     комментарий, где перед ней стояла ещё одна '*', не закрывался).
+     */
+
+    typedef struct Lexer Lexer;
+
+    /* Сканер файла file из ctx->sources */
+    Lexer* lexer_create(struct CompilerContext* ctx, int file);
+    void lexer_free(Lexer* lx);
+
+    /* Диапазон последней выданной лексемы (для сообщений об ошибках) */
+    SourceSpan lexer_token_span(yyscan_t scanner);
+
+    /* Интерфейс для bison (parser.y: %lex-param { yyscan_t scanner }) */
+    int yylex(YYSTYPE* yylval_param, yyscan_t scanner);
+    char* yyget_text(yyscan_t scanner);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+﻿#include "liveness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================
+ * Helpers
+ * ========================= */
+
+int liveness_bit(const uint32_t* set, int var) {
+    return dataflow_test(set, var);
+}
+
+static void lv_set(uint32_t* set, int var) {
+    dataflow_set(set, var);
+}
+
+const uint32_t* liveness_row(const Liveness* lv, const uint32_t* sets, int pos) {
+    return dataflow_row(sets, lv->words, pos);
+}
+
+int liveness_var_of_ident(const Liveness* lv, const ASTNode* ident) {
+    if (!lv || !ident || ident->type != AST_IDENTIFIER || !ident->value) return -1;
+    Symbol* sym = symbol_table_resolve(lv->st, ident, lv->scope_id);
+    if (!sym) return -1;
+    return lv->var_of_symbol[sym - lv->st->symbols];
+}
+
+/* =========================
+ * use/def of one expression (evaluation order as in codegen)
+ * ========================= */
+
+static void lv_read(const Liveness* lv, const ASTNode* e, uint32_t* use, const uint32_t* def) {
+    int v = liveness_var_of_ident(lv, e);
+    if (v >= 0 && !liveness_bit(def, v)) lv_set(use, v);
+}
+
+void liveness_expr_use_def(const Liveness* lv, const ASTNode* e, uint32_t* use, uint32_t* def) {
+    if (!e) return;
+
+    switch (e->type) {
+    case AST_IDENTIFIER:
+        lv_read(lv, e, use, def);
+        return;
+
+    case AST_CALL_EXPR: {
+        /* children[0] - имя функции, не переменная */
+        for (int i = 1; i < e->child_count; i++) {
+            liveness_expr_use_def(lv, e->children[i], use, def);
+        }
+        return;
+    }
+
+    case AST_ASSIGNMENT: {
+        const ASTNode* lhs = (e->child_count > 0) ? e->children[0] : NULL;
+        const ASTNode* rhs = (e->child_count > 1) ? e->children[1] : NULL;
+
+        if (lhs && lhs->type == AST_IDENTIFIER) {
+            liveness_expr_use_def(lv, rhs, use, def);
+            int v = liveness_var_of_ident(lv, lhs);
+            if (v >= 0) {
+                const Symbol* sym = &lv->st->symbols[lv->vars[v]];
+                /* только полная перезапись скаляра убивает значение */
+                if (!sym->is_array && !sym->is_address_taken) lv_set(def, v);
+                else lv_read(lv, lhs, use, def);
+            }
+            return;
+        }
+
+        /* a[i] := rhs: адрес элемента, затем значение */
+        liveness_expr_use_def(lv, lhs, use, def);
+        liveness_expr_use_def(lv, rhs, use, def);
+        return;
+    }
+
+    default:
+        for (int i = 0; i < e->child_count; i++) {
+            liveness_expr_use_def(lv, e->children[i], use, def);
+        }
+        return;
+    }
+}
+
+void liveness_step(const Liveness* lv, const ASTNode* e, uint32_t* live, uint32_t* def) {
+    uint32_t* use = lv->scratch;
+    uint32_t* kill = lv->scratch + lv->words;
+    memset(lv->scratch, 0, 2 * (size_t)lv->words * sizeof(uint32_t));
+    liveness_expr_use_def(lv, e, use, kill);
+    for (int w = 0; w < lv->words; w++) {
+        live[w] = use[w] | (live[w] & ~kill[w]);
+        if (def) def[w] = kill[w];
+    }
+}
+
+/* =========================
+ * Compute
+ * ========================= */
+
+Liveness* liveness_compute(const CFG* cfg, const SymbolTable* st, const CFGFunction* fn) {
+    if (!cfg || !st || !fn || !fn->entry || !cfg->edges_valid) return NULL;
+
+    Liveness* lv = (Liveness*)calloc(1, sizeof(Liveness));
+    if (!lv) return NULL;
+    lv->cfg = cfg;
+    lv->st = st;
+    snprintf(lv->name, sizeof(lv->name), "%s", fn->name ? fn->name : "?");
+    lv->scope_id = fn->scope_id;
+    lv->first_node = fn->first_node;
+
+    /* узлы функции: всё, что достижимо из входа (обход cfg_finalize) */
+    lv->graph = dataflow_graph_create(cfg, fn);
+    if (!lv->graph) {
+        liveness_free(lv);
+        return NULL;
+    }
+    lv->node_count = lv->graph->node_count;
+    lv->nodes = lv->graph->nodes;
+    lv->node_pos = lv->graph->node_pos;
+    lv->succ = lv->graph->succ;
+
+    /* переменные функции */
+    int nsyms = 0;
+    int* syms = symbol_table_scope_symbols(st, symbol_table_scope(st, lv->scope_id), &nsyms);
+    lv->var_of_symbol = (int*)malloc((size_t)(st->symbol_count > 0 ? st->symbol_count : 1) * sizeof(int));
+    lv->vars = (int*)malloc((size_t)(nsyms > 0 ? nsyms : 1) * sizeof(int));
+    for (int i = 0; i < st->symbol_count; i++) lv->var_of_symbol[i] = -1;
+    for (int j = 0; j < nsyms; j++) {
+        const Symbol* sym = &st->symbols[syms[j]];
+        if (sym->type != SYM_LOCAL && sym->type != SYM_PARAMETER) continue;
+        lv->var_of_symbol[syms[j]] = lv->var_count;
+        lv->vars[lv->var_count++] = syms[j];
+    }
+    free(syms);
+
+    lv->words = dataflow_words(lv->var_count);
+    size_t total = (size_t)(lv->node_count > 0 ? lv->node_count : 1) * (size_t)lv->words;
+    lv->use = (uint32_t*)calloc(total, sizeof(uint32_t));
+    lv->def = (uint32_t*)calloc(total, sizeof(uint32_t));
+    lv->scratch = (uint32_t*)calloc(2 * (size_t)lv->words, sizeof(uint32_t));
+
+    /* локальные use/def: операторы блока по порядку */
+    const Symbol* ret = symbol_table_return_symbol(st, lv->name, lv->scope_id);
+    for (int p = 0; p < lv->node_count; p++) {
+        const CFGNode* node = cfg->nodes[lv->nodes[p]];
+        uint32_t* use = lv->use + (size_t)p * lv->words;
+        uint32_t* def = lv->def + (size_t)p * lv->words;
+
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(node, &count);
+        for (int i = 0; i < count; i++) liveness_expr_use_def(lv, exprs[i], use, def);
+
+        if (node->type == CFG_END && ret) {
+            int v = lv->var_of_symbol[ret - st->symbols];
+            if (v >= 0) lv_set(use, v);
+        }
+    }
+
+    /* in = use | (out & ~def), out = U in(succ) */
+    DataflowProblem problem = { DATAFLOW_BACKWARD, DATAFLOW_UNION, lv->var_count, lv->use, lv->def, NULL };
+    lv->flow = dataflow_solve(lv->graph, &problem);
+    if (!lv->flow) {
+        liveness_free(lv);
+        return NULL;
+    }
+    lv->live_in = lv->flow->in;
+    lv->live_out = lv->flow->out;
+    lv->stats = lv->flow->stats;
+
+    return lv;
+}
+
+void liveness_free(Liveness* lv) {
+    if (!lv) return;
+    dataflow_free(lv->flow);
+    dataflow_graph_free(lv->graph);
+    free(lv->vars);
+    free(lv->var_of_symbol);
+    free(lv->use);
+    free(lv->def);
+    free(lv->scratch);
+    free(lv);
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include <stdint.h>
+#include "cfg.h"
+#include "dataflow.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Живость переменных по CFG одной функции (обратный поток данных).
+     *
+     * Отслеживаются локальные переменные и параметры функции (SYM_LOCAL /
+     * SYM_PARAMETER из области функции и вложенных в неё). Узел - базовый
+     * блок: его операторы (cfg_node_exprs) читают/пишут по порядку, как их
+     * вычисляет codegen, use/def узла - по всему блоку. Запись в
+     * скаляр убивает значение; запись в элемент массива - это использование
+     * массива. Узел CFG_END использует переменную возврата (её читает эпилог).
+     *
+     * Решает dataflow.c (обратная задача, объединение): use - gen, def -
+     * kill. Граф и множества принадлежат решателю, поля ниже - ссылки на
+     * них для удобства проходов.
+     */
+
+    typedef struct {
+        const CFG* cfg;
+        const SymbolTable* st;
+
+        char name[256];        /* имя функции */
+        int scope_id;          /* область функции */
+
+        DataflowGraph* graph;
+        Dataflow* flow;
+
+        int first_node;        /* начало диапазона узлов функции в cfg->nodes */
+        int node_count;        /* узлы функции (достижимые из входа) */
+        int* nodes;            /* позиция -> индекс в cfg->nodes (по возрастанию) */
+        int* node_pos;         /* индекс в cfg->nodes - first_node -> позиция или -1 */
+        int* succ;             /* succ[2p] / succ[2p + 1] - позиции преемников по
+                                  defaultNext / conditionalNext (-1 = нет) */
+
+        int var_count;
+        int* vars;             /* номер переменной -> индекс в st->symbols */
+        int* var_of_symbol;    /* индекс в st->symbols -> номер переменной или -1 */
+
+        int words;             /* слов uint32_t на одно множество */
+        uint32_t* use;         /* node_count * words */
+        uint32_t* def;
+        uint32_t* live_in;     /* flow->in */
+        uint32_t* live_out;    /* flow->out */
+        uint32_t* scratch;     /* 2 * words, для liveness_step */
+
+        DataflowStats stats;
+    } Liveness;
+
+    /* Живость для функции fn из cfg->functions; нужен CSR рёбер
+       (cfg_finalize), иначе NULL. Работа - по размеру функции */
+    Liveness* liveness_compute(const CFG* cfg, const SymbolTable* st, const CFGFunction* fn);
+    void liveness_free(Liveness* lv);
+
+    int liveness_bit(const uint32_t* set, int var);
+    const uint32_t* liveness_row(const Liveness* lv, const uint32_t* sets, int pos);
+
+    /* Номер переменной по узлу-идентификатору (-1, если не отслеживается) */
+    int liveness_var_of_ident(const Liveness* lv, const ASTNode* ident);
+
+    /* Записи-убийства и чтения в выражении (те же правила, что и для узлов) */
+    void liveness_expr_use_def(const Liveness* lv, const ASTNode* e, uint32_t* use, uint32_t* def);
+
+    /* Шаг назад через оператор e внутри блока: live (живые после e) -> живые
+       до e. def, если не NULL, получает записи-убийства e */
+    void liveness_step(const Liveness* lv, const ASTNode* e, uint32_t* live, uint32_t* def);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,15 +3,15 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include "ast.h"
+#include "astflat.h"
 #include "cfg.h"
 #include "semantic.h"
 #include "calltree.h"
 #include "codegen.h"
-
-extern int yyparse();
-extern FILE* yyin;
-extern ASTNode* root_ast;
-extern int line_num;
+#include "escape.h"
+#include "compiler.h"
+#include "project.h"
+#include "trace.h"
 
 int create_directory(const char* path) {
     if (path == NULL || path[0] == '\0') {
@@ -44,37 +44,44 @@ void build_output_path(const char* dir, const char* filename, char* result, int
     }
 }
 
-void dumpAST(ASTNode* node, int indent) {
-    if (!node) return;
+void dumpAST(const FlatAST* fa, ASTRef node, int indent) {
+    if (node == AST_NO_REF) return;
 
     for (int i = 0; i < indent; i++) printf("  ");
 
-    const char* type_name = getNodeTypeName(node->type);
+    const char* type_name = getNodeTypeName(flat_ast_kind(fa, node));
+    const char* value = flat_ast_value(fa, node);
 
-    if (node->value) {
-        printf("├─ %s: \"%s\"\n", type_name, node->value);
+    if (value) {
+        printf("├─ %s: \"%s\"\n", type_name, value);
     }
     else {
         printf("├─ %s\n", type_name);
     }
 
-    for (int i = 0; i < node->child_count; i++) {
-        dumpAST(node->children[i], indent + 1);
+    for (int i = 0; i < flat_ast_child_count(fa, node); i++) {
+        dumpAST(fa, flat_ast_child(fa, node, i), indent + 1);
     }
 }
 
-int count_and_print_ast_errors(ASTNode* node) {
+int count_and_print_ast_errors(const ASTNode* node, SourceManager* sources) {
     if (!node) return 0;
 
     int errors = 0;
-
     if (node->has_error && node->error_message) {
-        printf("  [Line ~%d] %s\n", node->line_number, node->error_message);
+        SourceSpan span = ast_span(node);
+        if (span.file != SOURCE_NO_FILE) {
+            SourceLocation loc = source_span_location(sources, span);
+            printf("  [%s:%d:%d] %s\n", loc.path, loc.line, loc.column, node->error_message);
+        }
+        else {
+            printf("  [Line ~%d] %s\n", node->line_number, node->error_message);
+        }
         errors++;
     }
 
     for (int i = 0; i < node->child_count; i++) {
-        errors += count_and_print_ast_errors(node->children[i]);
+        errors += count_and_print_ast_errors(node->children[i], sources);
     }
 
     return errors;
@@ -174,9 +181,9 @@ void print_symbol_table_details(SymbolTable* st) {
 
             /* Параметры */
             int param_count = 0;
-            for (int i = 0; i < st->symbol_count; i++) {
-                Symbol* sym = &st->symbols[i];
-                if (sym->scope_id == scope->id && sym->type == SYM_PARAMETER) {
+            for (int k = 0; k < scope->symbol_count; k++) {
+                Symbol* sym = &st->symbols[scope->symbols[k]];
+                if (sym->type == SYM_PARAMETER) {
                     param_count++;
                     printf("    PARAM %s", sym->name);
                     if (sym->data_type) printf(" : %s", sym->data_type);
@@ -189,9 +196,9 @@ void print_symbol_table_details(SymbolTable* st) {
 
             /* Локальные переменные */
             int local_count = 0;
-            for (int i = 0; i < st->symbol_count; i++) {
-                Symbol* sym = &st->symbols[i];
-                if (sym->scope_id == scope->id && sym->type == SYM_LOCAL) {
+            for (int k = 0; k < scope->symbol_count; k++) {
+                Symbol* sym = &st->symbols[scope->symbols[k]];
+                if (sym->type == SYM_LOCAL) {
                     local_count++;
                     printf("    LOCAL %s", sym->name);
                     if (sym->data_type) printf(" : %s", sym->data_type);
@@ -269,6 +276,104 @@ void print_symbol_table_details(SymbolTable* st) {
     printf("\n════════════════════════════════════════════════════════════\n");
 }
 
+/* ====================================================================
+ * МНОГОФАЙЛОВЫЙ РЕЖИМ (несколько входных файлов -> один asm)
+ * ==================================================================== */
+static int compile_project(const char** inputs, int input_count, int workers,
+    const char* output_dir, const char* asm_output) {
+    Project* proj = project_create();
+    if (workers > 0) proj->worker_count = workers;
+
+    for (int i = 0; i < input_count; i++) {
+        project_add_source(proj, inputs[i]);
+    }
+
+    int ok = project_parse_files(proj) && project_link_symbols(proj);
+    if (ok) {
+        project_build_cfgs(proj);
+        project_build_callgraph(proj);
+        project_optimize(proj);
+        project_export(proj, output_dir);
+
+        if (asm_output) {
+            char asm_file[512];
+            build_output_path(output_dir, asm_output, asm_file, sizeof(asm_file));
+            printf("[*] Generating assembly code for NOOBIK architecture...\n");
+
+            CodegenOptions opt = codegen_default_options();
+            opt.emit_comments = 1;
+            opt.emit_start_stub = 1;
+
+            if (project_emit_asm(proj, asm_file, opt)) {
+                printf("[+] Assembly generated: %s\n", asm_file);
+            }
+            else {
+                fprintf(stderr, "[ERROR] Code generation failed: %s\n", asm_file);
+                ok = 0;
+            }
+        }
+        project_print_summary(proj);
+    }
+    else {
+        fprintf(stderr, "\n[ERROR] %d error(s), compilation stopped\n", proj->error_count);
+    }
+
+    project_free(proj);
+    if (!ok) return 1;
+
+    printf("[+] Done!\n\n");
+    return 0;
+}
+
+/* ====================================================================
+ * ПОТОКОВЫЙ РЕЖИМ (-stream: asm по одной функции, без AST всей программы)
+ * ==================================================================== */
+static int compile_stream(const char* input_file, const char* output_dir, const char* asm_output) {
+    FILE* input = fopen(input_file, "r");
+    if (!input) {
+        fprintf(stderr, "[ERROR] Cannot open input file: %s\n", input_file);
+        return 1;
+    }
+
+    CompilerContext* ctx = compiler_context_create(input_file);
+    if (!ctx) {
+        fclose(input);
+        fprintf(stderr, "[ERROR] Cannot allocate compiler context\n");
+        return 1;
+    }
+
+    char asm_file[512];
+    build_output_path(output_dir, asm_output, asm_file, sizeof(asm_file));
+    printf("[*] Streaming %s -> %s\n", input_file, asm_file);
+
+    CodegenOptions opt = codegen_default_options();
+    opt.emit_comments = 1;
+    opt.emit_start_stub = 1;
+
+    int ok = compiler_compile_stream(ctx, input, asm_file, opt);
+    fclose(input);
+    compiler_context_free(ctx);
+
+    if (!ok) {
+        fprintf(stderr, "[ERROR] Streaming compilation failed: %s\n", asm_file);
+        return 1;
+    }
+
+    printf("[+] Assembly generated: %s\n", asm_file);
+    printf("[+] Done!\n\n");
+    return 0;
+}
+
+/* -trace-ring: буфер сохраняется при любом выходе из main */
+static const char* trace_ring_file = NULL;
+
+static void dump_trace_ring(void) {
+    if (!trace_ring_dump(trace_ring_file)) {
+        fprintf(stderr, "[ERROR] Cannot write trace ring: %s\n", trace_ring_file);
+    }
+    trace_shutdown();
+}
+
 int main(int argc, char* argv[]) {
     printf("\n");
     printf("╔════════════════════════════════════════════════════════════╗\n");
@@ -278,9 +383,13 @@ int main(int argc, char* argv[]) {
     printf("\n");
 
     const char* input_file = NULL;
+    const char** input_files = (const char**)malloc((size_t)argc * sizeof(char*));
+    int input_count = 0;
+    int workers = 0;
     const char* output_dir = NULL;
     const char* asm_output = NULL;
     int export_asm = 0;
+    int stream = 0;
 
     /* ====================================================================
      * ОБРАБОТКА АРГУМЕНТОВ КОМАНДНОЙ СТРОКИ
@@ -305,17 +414,59 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
         }
+        else if (strcmp(argv[i], "-j") == 0) {
+            if (i + 1 < argc) {
+                workers = atoi(argv[++i]);
+            }
+            else {
+                fprintf(stderr, "[ERROR] -j flag requires an argument\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-stream") == 0) {
+            stream = 1;
+        }
+        else if (strcmp(argv[i], "-trace") == 0) {
+            if (i + 1 < argc) {
+                if (!trace_configure(argv[++i])) {
+                    fprintf(stderr, "[ERROR] Invalid -trace spec: %s\n", argv[i]);
+                    return 1;
+                }
+            }
+            else {
+                fprintf(stderr, "[ERROR] -trace flag requires an argument\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-trace-ring") == 0) {
+            if (i + 1 < argc) {
+                trace_ring_file = argv[++i];
+            }
+            else {
+                fprintf(stderr, "[ERROR] -trace-ring flag requires an argument\n");
+                return 1;
+            }
+        }
         else {
             input_file = argv[i];
+            input_files[input_count++] = argv[i];
         }
     }
 
     if (!input_file) {
-        fprintf(stderr, "Usage: %s <input_file> [-o output_dir] [-asm asm_file]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <input_file>... [-o output_dir] [-asm asm_file] [-j workers] [-stream]\n", argv[0]);
+        fprintf(stderr, "       [-trace [subsystem=]level,...] [-trace-ring file]\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "Trace subsystems: lexer, semantic, cfg, codegen, all\n");
+        fprintf(stderr, "Trace levels: none, error, warn (default), info, debug\n");
         fprintf(stderr, "\n");
         fprintf(stderr, "Examples:\n");
         fprintf(stderr, "  %s test.txt\n", argv[0]);
         fprintf(stderr, "  %s test.txt -o output -asm output.asm\n", argv[0]);
+        fprintf(stderr, "  %s a.txt b.txt c.txt -o output -asm program.asm -j 8\n", argv[0]);
+        fprintf(stderr, "  %s big.txt -o output -asm big.asm -stream\n", argv[0]);
+        fprintf(stderr, "  %s test.txt -trace cfg=debug,codegen=info -trace-ring trace.bin\n", argv[0]);
+        free(input_files);
         return 1;
     }
 
@@ -323,6 +474,14 @@ int main(int argc, char* argv[]) {
         output_dir = ".";
     }
 
+    if (trace_ring_file) {
+        if (!trace_ring_enable()) {
+            fprintf(stderr, "[ERROR] Cannot allocate trace ring\n");
+            return 1;
+        }
+        atexit(dump_trace_ring);
+    }
+
     /* ====================================================================
      * СОЗДАНИЕ ВЫХОДНОЙ ДИРЕКТОРИИ
      * ==================================================================== */
@@ -336,54 +495,79 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (input_count > 1) {
+        int rc = compile_project(input_files, input_count, workers, output_dir, export_asm ? asm_output : NULL);
+        free(input_files);
+        return rc;
+    }
+    free(input_files);
+
+    if (stream) {
+        if (!export_asm) {
+            fprintf(stderr, "[ERROR] -stream requires -asm\n");
+            return 1;
+        }
+        return compile_stream(input_file, output_dir, asm_output);
+    }
+
     /* ====================================================================
      * ПАРСИНГ ВХОДНОГО ФАЙЛА
      * ==================================================================== */
-    FILE* input = fopen(input_file, "r");
-    if (!input) {
-        fprintf(stderr, "[ERROR] Cannot open input file: %s\n", input_file);
+    printf("[*] Reading input file: %s\n", input_file);
+    CompilerContext* ctx = compiler_context_create(input_file);
+    if (!ctx) {
+        fprintf(stderr, "[ERROR] Cannot allocate compiler context\n");
         return 1;
     }
 
-    printf("[*] Reading input file: %s\n", input_file);
-    yyin = input;
-    line_num = 1;
-
     printf("[*] Parsing...\n");
-    int parse_result = yyparse();
-    fclose(input);
-
-    if (parse_result != 0) {
-        fprintf(stderr, "\n[ERROR] Parse failed\n");
-        return 1;
-    }
+    int parse_ok = compiler_parse_file(ctx, input_file);
 
-    if (!root_ast) {
-        fprintf(stderr, "[ERROR] No AST generated\n");
+    if (!parse_ok) {
+        fprintf(stderr, ctx->root_ast ? "\n[ERROR] Parse failed\n" : "[ERROR] No AST generated\n");
+        compiler_context_free(ctx);
         return 1;
     }
 
-    printf("[+] Parse successful! (%d lines)\n\n", line_num);
+    ASTNode* root_ast = ctx->root_ast;
+    printf("[+] Parse successful! (%d lines)\n\n", ctx->line_num);
 
     /* ====================================================================
-     * СЕМАНТИЧЕСКИЙ АНАЛИЗ
+     * СЕМАНТИЧЕСКИЙ АНАЛИЗ + АНАЛИЗ УБЕГАНИЯ (адреса локальных, new_arr)
      * ==================================================================== */
     printf("[*] Running semantic analysis...\n");
-    SymbolTable* symbol_table = symbol_table_create();
-    semantic_analyze(root_ast, symbol_table);
+    Scheduler* sched = (workers != 1) ? scheduler_create(workers) : NULL;
+    ctx->scheduler = sched;
+    int analyzed = compiler_analyze(ctx);
+    ctx->scheduler = NULL;
+    scheduler_free(sched);
+    if (!analyzed) {
+        fprintf(stderr, "[ERROR] Semantic analysis failed\n");
+        compiler_context_free(ctx);
+        return 1;
+    }
+    SymbolTable* symbol_table = ctx->symbol_table;
+    EscapeInfo* escape_info = ctx->escape_info;
 
     /* ====================================================================
      * ВЫВОД ПОЛНОЙ ТАБЛИЦЫ СИМВОЛОВ
+     * (отчёты идут в stdout, -trace только включает их)
      * ==================================================================== */
-    printf("\n════════════════════════════════════════════════════════════\n");
-    printf("SYMBOL TABLE - FULL DUMP\n");
-    printf("════════════════════════════════════════════════════════════\n");
+    if (TRACE_ON(TRACE_SEMANTIC, TRACE_DEBUG)) {
+        printf("\n════════════════════════════════════════════════════════════\n");
+        printf("SYMBOL TABLE - FULL DUMP\n");
+        printf("════════════════════════════════════════════════════════════\n");
 
-    /* Компактный формат */
-    symbol_table_print(symbol_table);
+        /* Компактный формат */
+        symbol_table_print(symbol_table);
 
-    /* Подробный формат для отладки */
-    print_symbol_table_details(symbol_table);
+        /* Подробный формат для отладки */
+        print_symbol_table_details(symbol_table);
+    }
+
+    if (TRACE_ON(TRACE_SEMANTIC, TRACE_INFO)) {
+        escape_print_summary(escape_info, symbol_table);
+    }
 
     /* ====================================================================
      * ПРОВЕРКА ОШИБОК
@@ -395,7 +579,7 @@ int main(int argc, char* argv[]) {
     int total_errors = 0;
 
     printf("AST Errors:\n");
-    total_errors += count_and_print_ast_errors(root_ast);
+    total_errors += count_and_print_ast_errors(root_ast, ctx->sources);
 
     if (total_errors == 0) {
         printf("  No AST errors found.\n");
@@ -424,10 +608,15 @@ int main(int argc, char* argv[]) {
     /* ====================================================================
      * ВЫВОД AST
      * ==================================================================== */
-    printf("\nAST TREE:\n");
-    printf("════════════════════════════════════════════════════════════\n");
-    dumpAST(root_ast, 0);
-    printf("\n");
+    /* компактный снимок (astflat.h) строится только для дампа */
+    if (TRACE_ON(TRACE_LEXER, TRACE_DEBUG)) {
+        FlatAST* flat_ast = flat_ast_build(root_ast);
+        printf("\nAST TREE:\n");
+        printf("════════════════════════════════════════════════════════════\n");
+        if (flat_ast) dumpAST(flat_ast, flat_ast_root(flat_ast), 0);
+        printf("\n");
+        flat_ast_free(flat_ast);
+    }
 
     /* ====================================================================
      * ЭКСПОРТ AST В DOT ФОРМАТ
@@ -438,6 +627,7 @@ int main(int argc, char* argv[]) {
     FILE* ast_dot = fopen(ast_dot_file, "w");
     if (!ast_dot) {
         fprintf(stderr, "[ERROR] Cannot create AST DOT file\n");
+        compiler_context_free(ctx);
         return 1;
     }
     printASTDot(root_ast, ast_dot);
@@ -448,31 +638,33 @@ int main(int argc, char* argv[]) {
      * ПОСТРОЕНИЕ CFG
      * ==================================================================== */
     printf("\n[*] Setting up symbol table for CFG analysis...\n");
-    cfg_set_symbol_table(symbol_table);
 
     // Отладочная информация
-    printf("  [DEBUG] Symbol table has %d symbols and %d scopes\n",
-        symbol_table->symbol_count, symbol_table->scope_count);
-    printf("  [DEBUG] Scopes:\n");
-    for (int i = 0; i < symbol_table->scope_count; i++) {
-        Scope* scope = symbol_table->scopes[i];
-        printf("    Scope %d: %s '%s' (level: %d, parent: %d)\n",
-            scope->id,
-            scope->type == SCOPE_GLOBAL ? "GLOBAL" :
-            scope->type == SCOPE_FUNCTION ? "FUNCTION" : "BLOCK",
-            scope->name ? scope->name : "(unnamed)",
-            scope->level,
-            scope->parent ? scope->parent->id : -1);
+    if (TRACE_ON(TRACE_CFG, TRACE_DEBUG)) {
+        printf("  [DEBUG] Symbol table has %d symbols and %d scopes\n",
+            symbol_table->symbol_count, symbol_table->scope_count);
+        printf("  [DEBUG] Scopes:\n");
+        for (int i = 0; i < symbol_table->scope_count; i++) {
+            Scope* scope = symbol_table->scopes[i];
+            printf("    Scope %d: %s '%s' (level: %d, parent: %d)\n",
+                scope->id,
+                scope->type == SCOPE_GLOBAL ? "GLOBAL" :
+                scope->type == SCOPE_FUNCTION ? "FUNCTION" : "BLOCK",
+                scope->name ? scope->name : "(unnamed)",
+                scope->level,
+                scope->parent ? scope->parent->id : -1);
+        }
     }
 
     printf("[*] Generating Control Flow Graphs...\n");
-    CFG* cfg = cfg_create();
-    cfg_build_from_ast(cfg, root_ast);
+    if (!compiler_build_cfg(ctx)) {
+        fprintf(stderr, "[ERROR] CFG construction failed\n");
+        compiler_context_free(ctx);
+        return 1;
+    }
+    CFG* cfg = ctx->cfg;
 
     printf("[+] CFG generated with %d nodes\n", cfg->node_count);
-    printf("\n[*] Checking semantics in CFG expressions...\n");
-    cfg_check_semantics(cfg, symbol_table);
-    printf("[+] Semantic check complete\n");
 
     printf("\n════════════════════════════════════════════════════════════\n");
     printf("CFG ERROR SUMMARY:\n");
@@ -503,6 +695,12 @@ int main(int argc, char* argv[]) {
     }
     printf("════════════════════════════════════════════════════════════\n");
 
+    /* ====================================================================
+     * ОПТИМИЗАЦИИ ПО CFG
+     * ==================================================================== */
+    printf("\n");
+    compiler_optimize(ctx);
+
     /* ====================================================================
      * ЭКСПОРТ CFG В DOT ФОРМАТ
      * ==================================================================== */
@@ -541,10 +739,13 @@ int main(int argc, char* argv[]) {
         CodegenOptions opt = codegen_default_options();
         opt.emit_comments = 1;      // по желанию (комменты в asm)
         opt.emit_start_stub = 1;    // по желанию (_start -> CALL _func_main; HLT)
+        opt.workers = workers;      // -j: потоки генерации функций (asm от них не зависит)
 
-        int ok = codegen_generate_file(cfg, symbol_table, asm_file, opt);
+        int ok = compiler_emit_asm(ctx, asm_file, opt);
         if (!ok) {
             fprintf(stderr, "[ERROR] Code generation failed: %s\n", asm_file);
+            calltree_free(call_tree);
+            compiler_context_free(ctx);
             return 1;
         }
 
@@ -570,29 +771,31 @@ int main(int argc, char* argv[]) {
     }
 
     /* Дополнительная отладочная информация */
-    printf("\n[DEBUG INFO]\n");
-    printf("  Total symbols in table: %d\n", symbol_table->symbol_count);
-    printf("  Memory allocated for symbols: ~%ld bytes\n",
-        symbol_table->symbol_count * sizeof(Symbol));
-    printf("  Global data section size: %d bytes\n", symbol_table->global_offset);
-
-    /* Статистика по типам символов */
-    int globals = 0, locals = 0, params = 0, funcs = 0, consts = 0;
-    for (int i = 0; i < symbol_table->symbol_count; i++) {
-        switch (symbol_table->symbols[i].type) {
-        case SYM_GLOBAL: globals++; break;
-        case SYM_LOCAL: locals++; break;
-        case SYM_PARAMETER: params++; break;
-        case SYM_FUNCTION: funcs++; break;
-        case SYM_CONSTANT: consts++; break;
+    if (TRACE_ON(TRACE_SEMANTIC, TRACE_DEBUG)) {
+        printf("\n[DEBUG INFO]\n");
+        printf("  Total symbols in table: %d\n", symbol_table->symbol_count);
+        printf("  Memory allocated for symbols: ~%ld bytes\n",
+            symbol_table->symbol_count * sizeof(Symbol));
+        printf("  Global data section size: %d bytes\n", symbol_table->global_offset);
+
+        /* Статистика по типам символов */
+        int globals = 0, locals = 0, params = 0, funcs = 0, consts = 0;
+        for (int i = 0; i < symbol_table->symbol_count; i++) {
+            switch (symbol_table->symbols[i].type) {
+            case SYM_GLOBAL: globals++; break;
+            case SYM_LOCAL: locals++; break;
+            case SYM_PARAMETER: params++; break;
+            case SYM_FUNCTION: funcs++; break;
+            case SYM_CONSTANT: consts++; break;
+            }
         }
+        printf("  Symbol type breakdown:\n");
+        printf("    Global variables: %d\n", globals);
+        printf("    Local variables: %d\n", locals);
+        printf("    Parameters: %d\n", params);
+        printf("    Functions: %d\n", funcs);
+        printf("    Constants: %d\n", consts);
     }
-    printf("  Symbol type breakdown:\n");
-    printf("    Global variables: %d\n", globals);
-    printf("    Local variables: %d\n", locals);
-    printf("    Parameters: %d\n", params);
-    printf("    Functions: %d\n", funcs);
-    printf("    Constants: %d\n", consts);
 
     printf("\nTO VISUALIZE GRAPHS:\n");
     printf("  dot -Tpng %s -o ast_output.png\n", ast_dot_file);
@@ -605,10 +808,8 @@ int main(int argc, char* argv[]) {
      * ОЧИСТКА ПАМЯТИ
      * ==================================================================== */
     printf("[*] Cleaning up...\n");
-    cfg_free(cfg);
     calltree_free(call_tree);
-    freeAST(root_ast);
-    symbol_table_free(symbol_table);
+    compiler_context_free(ctx);
 
     printf("[+] Done!\n\n");
     return 0;
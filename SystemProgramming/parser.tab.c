@@ -1,2096 +0,0 @@
-/* A Bison parser, made by GNU Bison 3.8.2.  */
-
-/* Bison implementation for Yacc-like parsers in C
-
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
-   Inc.
-
-   This program is free software: you can redistribute it and/or modify
-   it under the terms of the GNU General Public License as published by
-   the Free Software Foundation, either version 3 of the License, or
-   (at your option) any later version.
-
-   This program is distributed in the hope that it will be useful,
-   but WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-   GNU General Public License for more details.
-
-   You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
-
-/* As a special exception, you may create a larger work that contains
-   part or all of the Bison parser skeleton and distribute that work
-   under terms of your choice, so long as that work isn't itself a
-   parser generator using the skeleton or a modified version thereof
-   as a parser skeleton.  Alternatively, if you modify or redistribute
-   the parser skeleton itself, you may (at your option) remove this
-   special exception, which will cause the skeleton and the resulting
-   Bison output files to be licensed under the GNU General Public
-   License without this special exception.
-
-   This special exception was added by the Free Software Foundation in
-   version 2.2 of Bison.  */
-
-/* C LALR(1) parser skeleton written by Richard Stallman, by
-   simplifying the original so-called "semantic" parser.  */
-
-/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
-   especially those whose name start with YY_ or yy_.  They are
-   private implementation details that can be changed or removed.  */
-
-/* All symbols defined below should begin with yy or YY, to avoid
-   infringing on user name space.  This should be done even for local
-   variables, as they might otherwise be expanded by user macros.
-   There are some unavoidable exceptions within include files to
-   define necessary library symbols; they are noted "INFRINGES ON
-   USER NAME SPACE" below.  */
-
-/* Identify Bison output, and Bison version.  */
-#define YYBISON 30802
-
-/* Bison version string.  */
-#define YYBISON_VERSION "3.8.2"
-
-/* Skeleton name.  */
-#define YYSKELETON_NAME "yacc.c"
-
-/* Pure parsers.  */
-#define YYPURE 0
-
-/* Push parsers.  */
-#define YYPUSH 0
-
-/* Pull parsers.  */
-#define YYPULL 1
-
-
-
-
-/* First part of user prologue.  */
-#line 1 "parser.y"
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "ast.h"
-
-int yylex();
-void yyerror(const char *s);
-
-extern char *yytext;
-extern int line_num;
-
-#line 84 "parser.tab.c"
-
-# ifndef YY_CAST
-#  ifdef __cplusplus
-#   define YY_CAST(Type, Val) static_cast<Type> (Val)
-#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
-#  else
-#   define YY_CAST(Type, Val) ((Type) (Val))
-#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
-#  endif
-# endif
-# ifndef YY_NULLPTR
-#  if defined __cplusplus
-#   if 201103L <= __cplusplus
-#    define YY_NULLPTR nullptr
-#   else
-#    define YY_NULLPTR 0
-#   endif
-#  else
-#   define YY_NULLPTR ((void*)0)
-#  endif
-# endif
-
-#include "parser.tab.h"
-/* Symbol kind.  */
-enum yysymbol_kind_t
-{
-  YYSYMBOL_YYEMPTY = -2,
-  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
-  YYSYMBOL_YYerror = 1,                    /* error  */
-  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
-  YYSYMBOL_IDENTIFIER = 3,                 /* IDENTIFIER  */
-  YYSYMBOL_INT_LITERAL = 4,                /* INT_LITERAL  */
-  YYSYMBOL_STRING_LITERAL = 5,             /* STRING_LITERAL  */
-  YYSYMBOL_CHAR_LITERAL = 6,               /* CHAR_LITERAL  */
-  YYSYMBOL_HEX_LITERAL = 7,                /* HEX_LITERAL  */
-  YYSYMBOL_BITS_LITERAL = 8,               /* BITS_LITERAL  */
-  YYSYMBOL_BOOL_LITERAL = 9,               /* BOOL_LITERAL  */
-  YYSYMBOL_METHOD = 10,                    /* METHOD  */
-  YYSYMBOL_VAR = 11,                       /* VAR  */
-  YYSYMBOL_BEGIN_KW = 12,                  /* BEGIN_KW  */
-  YYSYMBOL_END = 13,                       /* END  */
-  YYSYMBOL_IF = 14,                        /* IF  */
-  YYSYMBOL_THEN = 15,                      /* THEN  */
-  YYSYMBOL_ELSE = 16,                      /* ELSE  */
-  YYSYMBOL_WHILE = 17,                     /* WHILE  */
-  YYSYMBOL_DO = 18,                        /* DO  */
-  YYSYMBOL_REPEAT = 19,                    /* REPEAT  */
-  YYSYMBOL_UNTIL = 20,                     /* UNTIL  */
-  YYSYMBOL_BREAK = 21,                     /* BREAK  */
-  YYSYMBOL_BOOL_TYPE = 22,                 /* BOOL_TYPE  */
-  YYSYMBOL_BYTE_TYPE = 23,                 /* BYTE_TYPE  */
-  YYSYMBOL_INT_TYPE = 24,                  /* INT_TYPE  */
-  YYSYMBOL_UINT_TYPE = 25,                 /* UINT_TYPE  */
-  YYSYMBOL_LONG_TYPE = 26,                 /* LONG_TYPE  */
-  YYSYMBOL_ULONG_TYPE = 27,                /* ULONG_TYPE  */
-  YYSYMBOL_CHAR_TYPE = 28,                 /* CHAR_TYPE  */
-  YYSYMBOL_STRING_TYPE = 29,               /* STRING_TYPE  */
-  YYSYMBOL_ARRAY = 30,                     /* ARRAY  */
-  YYSYMBOL_OF = 31,                        /* OF  */
-  YYSYMBOL_ASSIGN = 32,                    /* ASSIGN  */
-  YYSYMBOL_EQ = 33,                        /* EQ  */
-  YYSYMBOL_NE = 34,                        /* NE  */
-  YYSYMBOL_LE = 35,                        /* LE  */
-  YYSYMBOL_GE = 36,                        /* GE  */
-  YYSYMBOL_LT = 37,                        /* LT  */
-  YYSYMBOL_GT = 38,                        /* GT  */
-  YYSYMBOL_AND = 39,                       /* AND  */
-  YYSYMBOL_OR = 40,                        /* OR  */
-  YYSYMBOL_NOT = 41,                       /* NOT  */
-  YYSYMBOL_PLUS = 42,                      /* PLUS  */
-  YYSYMBOL_MINUS = 43,                     /* MINUS  */
-  YYSYMBOL_MUL = 44,                       /* MUL  */
-  YYSYMBOL_DIV = 45,                       /* DIV  */
-  YYSYMBOL_MOD = 46,                       /* MOD  */
-  YYSYMBOL_LPAREN = 47,                    /* LPAREN  */
-  YYSYMBOL_RPAREN = 48,                    /* RPAREN  */
-  YYSYMBOL_LBRACKET = 49,                  /* LBRACKET  */
-  YYSYMBOL_RBRACKET = 50,                  /* RBRACKET  */
-  YYSYMBOL_COMMA = 51,                     /* COMMA  */
-  YYSYMBOL_COLON = 52,                     /* COLON  */
-  YYSYMBOL_SEMICOLON = 53,                 /* SEMICOLON  */
-  YYSYMBOL_UMINUS = 54,                    /* UMINUS  */
-  YYSYMBOL_YYACCEPT = 55,                  /* $accept  */
-  YYSYMBOL_source = 56,                    /* source  */
-  YYSYMBOL_sourceItem = 57,                /* sourceItem  */
-  YYSYMBOL_funcDef = 58,                   /* funcDef  */
-  YYSYMBOL_funcSignature = 59,             /* funcSignature  */
-  YYSYMBOL_argDefList = 60,                /* argDefList  */
-  YYSYMBOL_argDefListNonEmpty = 61,        /* argDefListNonEmpty  */
-  YYSYMBOL_argDef = 62,                    /* argDef  */
-  YYSYMBOL_typeRef = 63,                   /* typeRef  */
-  YYSYMBOL_commaList = 64,                 /* commaList  */
-  YYSYMBOL_commaListNonEmpty = 65,         /* commaListNonEmpty  */
-  YYSYMBOL_body = 66,                      /* body  */
-  YYSYMBOL_varDeclarations = 67,           /* varDeclarations  */
-  YYSYMBOL_identifierList = 68,            /* identifierList  */
-  YYSYMBOL_statementBlock = 69,            /* statementBlock  */
-  YYSYMBOL_statementList = 70,             /* statementList  */
-  YYSYMBOL_statement = 71,                 /* statement  */
-  YYSYMBOL_expr = 72,                      /* expr  */
-  YYSYMBOL_exprList = 73,                  /* exprList  */
-  YYSYMBOL_exprListNonEmpty = 74,          /* exprListNonEmpty  */
-  YYSYMBOL_binOp = 75,                     /* binOp  */
-  YYSYMBOL_unOp = 76                       /* unOp  */
-};
-typedef enum yysymbol_kind_t yysymbol_kind_t;
-
-
-
-
-#ifdef short
-# undef short
-#endif
-
-/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
-   <limits.h> and (if available) <stdint.h> are included
-   so that the code can choose integer types of a good width.  */
-
-#ifndef __PTRDIFF_MAX__
-# include <limits.h> /* INFRINGES ON USER NAME SPACE */
-# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
-#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
-#  define YY_STDINT_H
-# endif
-#endif
-
-/* Narrow types that promote to a signed type and that can represent a
-   signed or unsigned integer of at least N bits.  In tables they can
-   save space and decrease cache pressure.  Promoting to a signed type
-   helps avoid bugs in integer arithmetic.  */
-
-#ifdef __INT_LEAST8_MAX__
-typedef __INT_LEAST8_TYPE__ yytype_int8;
-#elif defined YY_STDINT_H
-typedef int_least8_t yytype_int8;
-#else
-typedef signed char yytype_int8;
-#endif
-
-#ifdef __INT_LEAST16_MAX__
-typedef __INT_LEAST16_TYPE__ yytype_int16;
-#elif defined YY_STDINT_H
-typedef int_least16_t yytype_int16;
-#else
-typedef short yytype_int16;
-#endif
-
-/* Work around bug in HP-UX 11.23, which defines these macros
-   incorrectly for preprocessor constants.  This workaround can likely
-   be removed in 2023, as HPE has promised support for HP-UX 11.23
-   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
-   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
-#ifdef __hpux
-# undef UINT_LEAST8_MAX
-# undef UINT_LEAST16_MAX
-# define UINT_LEAST8_MAX 255
-# define UINT_LEAST16_MAX 65535
-#endif
-
-#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
-typedef __UINT_LEAST8_TYPE__ yytype_uint8;
-#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
-       && UINT_LEAST8_MAX <= INT_MAX)
-typedef uint_least8_t yytype_uint8;
-#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
-typedef unsigned char yytype_uint8;
-#else
-typedef short yytype_uint8;
-#endif
-
-#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
-typedef __UINT_LEAST16_TYPE__ yytype_uint16;
-#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
-       && UINT_LEAST16_MAX <= INT_MAX)
-typedef uint_least16_t yytype_uint16;
-#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
-typedef unsigned short yytype_uint16;
-#else
-typedef int yytype_uint16;
-#endif
-
-#ifndef YYPTRDIFF_T
-# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
-#  define YYPTRDIFF_T __PTRDIFF_TYPE__
-#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
-# elif defined PTRDIFF_MAX
-#  ifndef ptrdiff_t
-#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#  endif
-#  define YYPTRDIFF_T ptrdiff_t
-#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
-# else
-#  define YYPTRDIFF_T long
-#  define YYPTRDIFF_MAXIMUM LONG_MAX
-# endif
-#endif
-
-#ifndef YYSIZE_T
-# ifdef __SIZE_TYPE__
-#  define YYSIZE_T __SIZE_TYPE__
-# elif defined size_t
-#  define YYSIZE_T size_t
-# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
-#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#  define YYSIZE_T size_t
-# else
-#  define YYSIZE_T unsigned
-# endif
-#endif
-
-#define YYSIZE_MAXIMUM                                  \
-  YY_CAST (YYPTRDIFF_T,                                 \
-           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
-            ? YYPTRDIFF_MAXIMUM                         \
-            : YY_CAST (YYSIZE_T, -1)))
-
-#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
-
-
-/* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
-
-/* State numbers in computations.  */
-typedef int yy_state_fast_t;
-
-#ifndef YY_
-# if defined YYENABLE_NLS && YYENABLE_NLS
-#  if ENABLE_NLS
-#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
-#  endif
-# endif
-# ifndef YY_
-#  define YY_(Msgid) Msgid
-# endif
-#endif
-
-
-#ifndef YY_ATTRIBUTE_PURE
-# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
-#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
-# else
-#  define YY_ATTRIBUTE_PURE
-# endif
-#endif
-
-#ifndef YY_ATTRIBUTE_UNUSED
-# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
-#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
-# else
-#  define YY_ATTRIBUTE_UNUSED
-# endif
-#endif
-
-/* Suppress unused-variable warnings by "using" E.  */
-#if ! defined lint || defined __GNUC__
-# define YY_USE(E) ((void) (E))
-#else
-# define YY_USE(E) /* empty */
-#endif
-
-/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
-# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
-#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
-    _Pragma ("GCC diagnostic push")                                     \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
-# else
-#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
-    _Pragma ("GCC diagnostic push")                                     \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
-    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# endif
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
-    _Pragma ("GCC diagnostic pop")
-#else
-# define YY_INITIAL_VALUE(Value) Value
-#endif
-#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END
-#endif
-#ifndef YY_INITIAL_VALUE
-# define YY_INITIAL_VALUE(Value) /* Nothing. */
-#endif
-
-#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
-# define YY_IGNORE_USELESS_CAST_BEGIN                          \
-    _Pragma ("GCC diagnostic push")                            \
-    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
-# define YY_IGNORE_USELESS_CAST_END            \
-    _Pragma ("GCC diagnostic pop")
-#endif
-#ifndef YY_IGNORE_USELESS_CAST_BEGIN
-# define YY_IGNORE_USELESS_CAST_BEGIN
-# define YY_IGNORE_USELESS_CAST_END
-#endif
-
-
-#define YY_ASSERT(E) ((void) (0 && (E)))
-
-#if !defined yyoverflow
-
-/* The parser invokes alloca or malloc; define the necessary symbols.  */
-
-# ifdef YYSTACK_USE_ALLOCA
-#  if YYSTACK_USE_ALLOCA
-#   ifdef __GNUC__
-#    define YYSTACK_ALLOC __builtin_alloca
-#   elif defined __BUILTIN_VA_ARG_INCR
-#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
-#   elif defined _AIX
-#    define YYSTACK_ALLOC __alloca
-#   elif defined _MSC_VER
-#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
-#    define alloca _alloca
-#   else
-#    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
-#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
-#     ifndef EXIT_SUCCESS
-#      define EXIT_SUCCESS 0
-#     endif
-#    endif
-#   endif
-#  endif
-# endif
-
-# ifdef YYSTACK_ALLOC
-   /* Pacify GCC's 'empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
-#  ifndef YYSTACK_ALLOC_MAXIMUM
-    /* The OS might guarantee only one guard page at the bottom of the stack,
-       and a page size can be as small as 4096 bytes.  So we cannot safely
-       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
-       to allow for a few compiler-allocated temporary stack slots.  */
-#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
-#  endif
-# else
-#  define YYSTACK_ALLOC YYMALLOC
-#  define YYSTACK_FREE YYFREE
-#  ifndef YYSTACK_ALLOC_MAXIMUM
-#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
-#  endif
-#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
-       && ! ((defined YYMALLOC || defined malloc) \
-             && (defined YYFREE || defined free)))
-#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef EXIT_SUCCESS
-#    define EXIT_SUCCESS 0
-#   endif
-#  endif
-#  ifndef YYMALLOC
-#   define YYMALLOC malloc
-#   if ! defined malloc && ! defined EXIT_SUCCESS
-void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
-#   endif
-#  endif
-#  ifndef YYFREE
-#   define YYFREE free
-#   if ! defined free && ! defined EXIT_SUCCESS
-void free (void *); /* INFRINGES ON USER NAME SPACE */
-#   endif
-#  endif
-# endif
-#endif /* !defined yyoverflow */
-
-#if (! defined yyoverflow \
-     && (! defined __cplusplus \
-         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
-
-/* A type that is properly aligned for any stack member.  */
-union yyalloc
-{
-  yy_state_t yyss_alloc;
-  YYSTYPE yyvs_alloc;
-};
-
-/* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
-
-/* The size of an array large to enough to hold all stacks, each with
-   N elements.  */
-# define YYSTACK_BYTES(N) \
-     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
-      + YYSTACK_GAP_MAXIMUM)
-
-# define YYCOPY_NEEDED 1
-
-/* Relocate STACK from its old location to the new one.  The
-   local variables YYSIZE and YYSTACKSIZE give the old and new number of
-   elements in the stack, and YYPTR gives the new location of the
-   stack.  Advance YYPTR to a properly aligned location for the next
-   stack.  */
-# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
-    do                                                                  \
-      {                                                                 \
-        YYPTRDIFF_T yynewbytes;                                         \
-        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
-        Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
-      }                                                                 \
-    while (0)
-
-#endif
-
-#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
-/* Copy COUNT objects from SRC to DST.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
-#  else
-#   define YYCOPY(Dst, Src, Count)              \
-      do                                        \
-        {                                       \
-          YYPTRDIFF_T yyi;                      \
-          for (yyi = 0; yyi < (Count); yyi++)   \
-            (Dst)[yyi] = (Src)[yyi];            \
-        }                                       \
-      while (0)
-#  endif
-# endif
-#endif /* !YYCOPY_NEEDED */
-
-/* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  2
-/* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   271
-
-/* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  55
-/* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  22
-/* YYNRULES -- Number of rules.  */
-#define YYNRULES  79
-/* YYNSTATES -- Number of states.  */
-#define YYNSTATES  121
-
-/* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   309
-
-
-/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
-   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
-   : YYSYMBOL_YYUNDEF)
-
-/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex.  */
-static const yytype_int8 yytranslate[] =
-{
-       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
-       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
-      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
-      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    51,    52,    53,    54
-};
-
-#if YYDEBUG
-/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_int16 yyrline[] =
-{
-       0,    59,    59,    63,    70,    74,    79,    86,    91,   100,
-     101,   105,   106,   116,   120,   128,   129,   130,   131,   132,
-     133,   134,   135,   136,   140,   148,   149,   153,   154,   160,
-     165,   171,   172,   183,   196,   200,   207,   214,   215,   225,
-     230,   236,   237,   242,   247,   252,   255,   262,   266,   269,
-     272,   277,   282,   286,   291,   295,   299,   303,   307,   314,
-     315,   319,   320,   326,   327,   328,   329,   330,   331,   332,
-     333,   334,   335,   336,   337,   338,   339,   343,   344,   345
-};
-#endif
-
-/** Accessing symbol of state STATE.  */
-#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
-
-#if YYDEBUG || 0
-/* The user-facing name of the symbol whose (internal) number is
-   YYSYMBOL.  No bounds checking.  */
-static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
-
-/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
-   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
-static const char *const yytname[] =
-{
-  "\"end of file\"", "error", "\"invalid token\"", "IDENTIFIER",
-  "INT_LITERAL", "STRING_LITERAL", "CHAR_LITERAL", "HEX_LITERAL",
-  "BITS_LITERAL", "BOOL_LITERAL", "METHOD", "VAR", "BEGIN_KW", "END", "IF",
-  "THEN", "ELSE", "WHILE", "DO", "REPEAT", "UNTIL", "BREAK", "BOOL_TYPE",
-  "BYTE_TYPE", "INT_TYPE", "UINT_TYPE", "LONG_TYPE", "ULONG_TYPE",
-  "CHAR_TYPE", "STRING_TYPE", "ARRAY", "OF", "ASSIGN", "EQ", "NE", "LE",
-  "GE", "LT", "GT", "AND", "OR", "NOT", "PLUS", "MINUS", "MUL", "DIV",
-  "MOD", "LPAREN", "RPAREN", "LBRACKET", "RBRACKET", "COMMA", "COLON",
-  "SEMICOLON", "UMINUS", "$accept", "source", "sourceItem", "funcDef",
-  "funcSignature", "argDefList", "argDefListNonEmpty", "argDef", "typeRef",
-  "commaList", "commaListNonEmpty", "body", "varDeclarations",
-  "identifierList", "statementBlock", "statementList", "statement", "expr",
-  "exprList", "exprListNonEmpty", "binOp", "unOp", YY_NULLPTR
-};
-
-static const char *
-yysymbol_name (yysymbol_kind_t yysymbol)
-{
-  return yytname[yysymbol];
-}
-#endif
-
-#define YYPACT_NINF (-55)
-
-#define yypact_value_is_default(Yyn) \
-  ((Yyn) == YYPACT_NINF)
-
-#define YYTABLE_NINF (-1)
-
-#define yytable_value_is_error(Yyn) \
-  0
-
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-static const yytype_int16 yypact[] =
-{
-     -55,    26,   -55,     4,   -55,   -55,   -20,    -8,    34,   -55,
-     -55,   -55,    10,   -55,   -23,   -10,   -12,   -55,    11,    37,
-     -55,    69,    -9,    34,   -55,   -55,   -55,   -55,   -55,   -55,
-     -55,    -7,    81,    81,    62,    -6,   -55,   -55,   -55,    81,
-     -55,   -55,   138,    81,   -55,   -18,   -55,   -55,   -55,   -55,
-     -55,   -55,   -55,   -55,   -55,    -5,   -55,    69,   -55,   -55,
-      97,   120,   -11,   -55,   204,   -55,   -55,   -55,   -55,   -55,
-     -55,   -55,   -55,   -55,   -55,   -55,   -55,   -55,   -55,    81,
-      81,   -55,    81,   -36,    38,    69,   -55,    -1,   -55,    62,
-      62,    81,    81,   -55,   222,     9,     8,    12,   222,   -55,
-      20,   -55,    13,    24,    61,   -55,   160,   182,   -55,    81,
-     -55,   -55,    51,   -55,    62,   -55,   -55,   222,    69,   -55,
-     -55
-};
-
-/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-   Performed when YYTABLE does not specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_int8 yydefact[] =
-{
-       2,     0,     1,     0,     3,     4,     0,    31,     9,    37,
-       6,     5,     0,    30,    13,     0,    10,    11,     0,     0,
-      29,     0,     7,     0,    52,    53,    54,    55,    56,    57,
-      58,     0,     0,     0,     0,     0,    77,    79,    78,     0,
-      41,    38,     0,     0,    34,     0,    23,    15,    16,    17,
-      18,    19,    20,    21,    22,     0,    14,     0,    12,    36,
-       0,     0,     0,    45,     0,    63,    69,    70,    72,    74,
-      71,    73,    75,    76,    64,    65,    66,    67,    68,    59,
-      59,    46,     0,    48,     0,     0,    33,    25,     8,     0,
-       0,     0,     0,    49,    61,     0,    60,     0,    47,    35,
-       0,    27,     0,    26,    39,    42,     0,     0,    50,     0,
-      51,    32,     0,    28,     0,    43,    44,    62,     0,    40,
-      24
-};
-
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
-{
-     -55,   -55,   -55,   -55,   -55,   -55,   -55,    19,   -54,   -55,
-     -55,   -55,   -55,   -55,    -2,   -55,   -34,   -31,    21,   -55,
-     -55,   -55
-};
-
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-{
-       0,     1,     4,     5,     7,    15,    16,    17,    56,   102,
-     103,    11,    12,    45,    40,    18,    41,    42,    95,    96,
-      82,    43
-};
-
-/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule whose
-   number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
-{
-      62,    60,    61,    88,     9,    13,    91,     6,    64,    92,
-      20,    79,    83,    80,    24,    25,    26,    27,    28,    29,
-      30,    19,     9,     9,    31,    32,     2,     8,    33,    21,
-      34,   100,    35,    84,    85,    86,     3,    14,    22,    23,
-      44,    99,    58,    57,    87,    10,    59,    63,    94,    94,
-     101,    98,    36,    37,    38,   104,   105,   108,    39,   109,
-     106,   107,   110,   112,   120,    24,    25,    26,    27,    28,
-      29,    30,    46,   111,     9,   113,    32,   114,   117,    33,
-     119,    34,   118,    35,    24,    25,    26,    27,    28,    29,
-      30,    47,    48,    49,    50,    51,    52,    53,    54,    55,
-       0,    97,     0,    36,    37,    38,     0,     0,     0,    39,
-       0,     0,    89,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,    36,    37,    38,     0,     0,     0,    39,    65,
-      66,    67,    68,    69,    70,    71,    72,    73,    90,    74,
-      75,    76,    77,    78,    79,     0,    80,     0,     0,     0,
-       0,     0,    65,    66,    67,    68,    69,    70,    71,    72,
-      73,     0,    74,    75,    76,    77,    78,    79,     0,    80,
-      65,    66,    67,    68,    69,    70,    71,    72,    73,     0,
-      74,    75,    76,    77,    78,    79,     0,    80,     0,     0,
-       0,    81,    65,    66,    67,    68,    69,    70,    71,    72,
-      73,     0,    74,    75,    76,    77,    78,    79,     0,    80,
-       0,     0,     0,   115,    65,    66,    67,    68,    69,    70,
-      71,    72,    73,     0,    74,    75,    76,    77,    78,    79,
-       0,    80,     0,     0,     0,   116,    65,    66,    67,    68,
-      69,    70,    71,    72,    73,     0,    74,    75,    76,    77,
-      78,    79,    93,    80,    65,    66,    67,    68,    69,    70,
-      71,    72,    73,     0,    74,    75,    76,    77,    78,    79,
-       0,    80
-};
-
-static const yytype_int8 yycheck[] =
-{
-      34,    32,    33,    57,    12,     7,    17,     3,    39,    20,
-      12,    47,    43,    49,     3,     4,     5,     6,     7,     8,
-       9,    11,    12,    12,    13,    14,     0,    47,    17,    52,
-      19,    85,    21,    51,    52,    53,    10,     3,    48,    51,
-       3,     3,    23,    52,    49,    53,    53,    53,    79,    80,
-      51,    82,    41,    42,    43,    89,    90,    48,    47,    51,
-      91,    92,    50,    50,   118,     3,     4,     5,     6,     7,
-       8,     9,     3,    53,    12,    51,    14,    16,   109,    17,
-     114,    19,    31,    21,     3,     4,     5,     6,     7,     8,
-       9,    22,    23,    24,    25,    26,    27,    28,    29,    30,
-      -1,    80,    -1,    41,    42,    43,    -1,    -1,    -1,    47,
-      -1,    -1,    15,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    41,    42,    43,    -1,    -1,    -1,    47,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    18,    42,
-      43,    44,    45,    46,    47,    -1,    49,    -1,    -1,    -1,
-      -1,    -1,    32,    33,    34,    35,    36,    37,    38,    39,
-      40,    -1,    42,    43,    44,    45,    46,    47,    -1,    49,
-      32,    33,    34,    35,    36,    37,    38,    39,    40,    -1,
-      42,    43,    44,    45,    46,    47,    -1,    49,    -1,    -1,
-      -1,    53,    32,    33,    34,    35,    36,    37,    38,    39,
-      40,    -1,    42,    43,    44,    45,    46,    47,    -1,    49,
-      -1,    -1,    -1,    53,    32,    33,    34,    35,    36,    37,
-      38,    39,    40,    -1,    42,    43,    44,    45,    46,    47,
-      -1,    49,    -1,    -1,    -1,    53,    32,    33,    34,    35,
-      36,    37,    38,    39,    40,    -1,    42,    43,    44,    45,
-      46,    47,    48,    49,    32,    33,    34,    35,    36,    37,
-      38,    39,    40,    -1,    42,    43,    44,    45,    46,    47,
-      -1,    49
-};
-
-/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
-   state STATE-NUM.  */
-static const yytype_int8 yystos[] =
-{
-       0,    56,     0,    10,    57,    58,     3,    59,    47,    12,
-      53,    66,    67,    69,     3,    60,    61,    62,    70,    11,
-      69,    52,    48,    51,     3,     4,     5,     6,     7,     8,
-       9,    13,    14,    17,    19,    21,    41,    42,    43,    47,
-      69,    71,    72,    76,     3,    68,     3,    22,    23,    24,
-      25,    26,    27,    28,    29,    30,    63,    52,    62,    53,
-      72,    72,    71,    53,    72,    32,    33,    34,    35,    36,
-      37,    38,    39,    40,    42,    43,    44,    45,    46,    47,
-      49,    53,    75,    72,    51,    52,    53,    49,    63,    15,
-      18,    17,    20,    48,    72,    73,    74,    73,    72,     3,
-      63,    51,    64,    65,    71,    71,    72,    72,    48,    51,
-      50,    53,    50,    51,    16,    53,    53,    72,    31,    71,
-      63
-};
-
-/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
-static const yytype_int8 yyr1[] =
-{
-       0,    55,    56,    56,    57,    58,    58,    59,    59,    60,
-      60,    61,    61,    62,    62,    63,    63,    63,    63,    63,
-      63,    63,    63,    63,    63,    64,    64,    65,    65,    66,
-      66,    67,    67,    67,    68,    68,    69,    70,    70,    71,
-      71,    71,    71,    71,    71,    71,    71,    72,    72,    72,
-      72,    72,    72,    72,    72,    72,    72,    72,    72,    73,
-      73,    74,    74,    75,    75,    75,    75,    75,    75,    75,
-      75,    75,    75,    75,    75,    75,    75,    76,    76,    76
-};
-
-/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
-static const yytype_int8 yyr2[] =
-{
-       0,     2,     0,     2,     1,     3,     3,     4,     6,     0,
-       1,     1,     3,     1,     3,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     6,     0,     1,     1,     2,     2,
-       1,     0,     6,     4,     1,     3,     4,     0,     2,     4,
-       6,     1,     4,     5,     5,     2,     2,     3,     2,     3,
-       4,     4,     1,     1,     1,     1,     1,     1,     1,     0,
-       1,     1,     3,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1
-};
-
-
-enum { YYENOMEM = -2 };
-
-#define yyerrok         (yyerrstatus = 0)
-#define yyclearin       (yychar = YYEMPTY)
-
-#define YYACCEPT        goto yyacceptlab
-#define YYABORT         goto yyabortlab
-#define YYERROR         goto yyerrorlab
-#define YYNOMEM         goto yyexhaustedlab
-
-
-#define YYRECOVERING()  (!!yyerrstatus)
-
-#define YYBACKUP(Token, Value)                                    \
-  do                                                              \
-    if (yychar == YYEMPTY)                                        \
-      {                                                           \
-        yychar = (Token);                                         \
-        yylval = (Value);                                         \
-        YYPOPSTACK (yylen);                                       \
-        yystate = *yyssp;                                         \
-        goto yybackup;                                            \
-      }                                                           \
-    else                                                          \
-      {                                                           \
-        yyerror (YY_("syntax error: cannot back up")); \
-        YYERROR;                                                  \
-      }                                                           \
-  while (0)
-
-/* Backward compatibility with an undocumented macro.
-   Use YYerror or YYUNDEF. */
-#define YYERRCODE YYUNDEF
-
-
-/* Enable debugging if requested.  */
-#if YYDEBUG
-
-# ifndef YYFPRINTF
-#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
-#  define YYFPRINTF fprintf
-# endif
-
-# define YYDPRINTF(Args)                        \
-do {                                            \
-  if (yydebug)                                  \
-    YYFPRINTF Args;                             \
-} while (0)
-
-
-
-
-# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
-do {                                                                      \
-  if (yydebug)                                                            \
-    {                                                                     \
-      YYFPRINTF (stderr, "%s ", Title);                                   \
-      yy_symbol_print (stderr,                                            \
-                  Kind, Value); \
-      YYFPRINTF (stderr, "\n");                                           \
-    }                                                                     \
-} while (0)
-
-
-/*-----------------------------------.
-| Print this symbol's value on YYO.  |
-`-----------------------------------*/
-
-static void
-yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
-{
-  FILE *yyoutput = yyo;
-  YY_USE (yyoutput);
-  if (!yyvaluep)
-    return;
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YY_USE (yykind);
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-}
-
-
-/*---------------------------.
-| Print this symbol on YYO.  |
-`---------------------------*/
-
-static void
-yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
-{
-  YYFPRINTF (yyo, "%s %s (",
-             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
-
-  yy_symbol_value_print (yyo, yykind, yyvaluep);
-  YYFPRINTF (yyo, ")");
-}
-
-/*------------------------------------------------------------------.
-| yy_stack_print -- Print the state stack from its BOTTOM up to its |
-| TOP (included).                                                   |
-`------------------------------------------------------------------*/
-
-static void
-yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
-{
-  YYFPRINTF (stderr, "Stack now");
-  for (; yybottom <= yytop; yybottom++)
-    {
-      int yybot = *yybottom;
-      YYFPRINTF (stderr, " %d", yybot);
-    }
-  YYFPRINTF (stderr, "\n");
-}
-
-# define YY_STACK_PRINT(Bottom, Top)                            \
-do {                                                            \
-  if (yydebug)                                                  \
-    yy_stack_print ((Bottom), (Top));                           \
-} while (0)
-
-
-/*------------------------------------------------.
-| Report that the YYRULE is going to be reduced.  |
-`------------------------------------------------*/
-
-static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
-                 int yyrule)
-{
-  int yylno = yyrline[yyrule];
-  int yynrhs = yyr2[yyrule];
-  int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
-             yyrule - 1, yylno);
-  /* The symbols being reduced.  */
-  for (yyi = 0; yyi < yynrhs; yyi++)
-    {
-      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr,
-                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
-                       &yyvsp[(yyi + 1) - (yynrhs)]);
-      YYFPRINTF (stderr, "\n");
-    }
-}
-
-# define YY_REDUCE_PRINT(Rule)          \
-do {                                    \
-  if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
-} while (0)
-
-/* Nonzero means print parse trace.  It is left uninitialized so that
-   multiple parsers can coexist.  */
-int yydebug;
-#else /* !YYDEBUG */
-# define YYDPRINTF(Args) ((void) 0)
-# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
-# define YY_STACK_PRINT(Bottom, Top)
-# define YY_REDUCE_PRINT(Rule)
-#endif /* !YYDEBUG */
-
-
-/* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef YYINITDEPTH
-# define YYINITDEPTH 200
-#endif
-
-/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
-   if the built-in stack extension method is used).
-
-   Do not make this value too large; the results are undefined if
-   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
-   evaluated with infinite-precision integer arithmetic.  */
-
-#ifndef YYMAXDEPTH
-# define YYMAXDEPTH 10000
-#endif
-
-
-
-
-
-
-/*-----------------------------------------------.
-| Release the memory associated to this symbol.  |
-`-----------------------------------------------*/
-
-static void
-yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
-{
-  YY_USE (yyvaluep);
-  if (!yymsg)
-    yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
-
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YY_USE (yykind);
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-}
-
-
-/* Lookahead token kind.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
-
-
-
-
-/*----------.
-| yyparse.  |
-`----------*/
-
-int
-yyparse (void)
-{
-    yy_state_fast_t yystate = 0;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus = 0;
-
-    /* Refer to the stacks through separate pointers, to allow yyoverflow
-       to reallocate them elsewhere.  */
-
-    /* Their size.  */
-    YYPTRDIFF_T yystacksize = YYINITDEPTH;
-
-    /* The state stack: array, bottom, top.  */
-    yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss = yyssa;
-    yy_state_t *yyssp = yyss;
-
-    /* The semantic value stack: array, bottom, top.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs = yyvsa;
-    YYSTYPE *yyvsp = yyvs;
-
-  int yyn;
-  /* The return value of yyparse.  */
-  int yyresult;
-  /* Lookahead symbol kind.  */
-  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
-  /* The variables used to return semantic value and location from the
-     action routines.  */
-  YYSTYPE yyval;
-
-
-
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
-
-  /* The number of symbols on the RHS of the reduced rule.
-     Keep to zero when no symbol should be popped.  */
-  int yylen = 0;
-
-  YYDPRINTF ((stderr, "Starting parse\n"));
-
-  yychar = YYEMPTY; /* Cause a token to be read.  */
-
-  goto yysetstate;
-
-
-/*------------------------------------------------------------.
-| yynewstate -- push a new state, which is found in yystate.  |
-`------------------------------------------------------------*/
-yynewstate:
-  /* In all cases, when you get here, the value and location stacks
-     have just been pushed.  So pushing a state here evens the stacks.  */
-  yyssp++;
-
-
-/*--------------------------------------------------------------------.
-| yysetstate -- set current state (the top of the stack) to yystate.  |
-`--------------------------------------------------------------------*/
-yysetstate:
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
-  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
-  YY_IGNORE_USELESS_CAST_BEGIN
-  *yyssp = YY_CAST (yy_state_t, yystate);
-  YY_IGNORE_USELESS_CAST_END
-  YY_STACK_PRINT (yyss, yyssp);
-
-  if (yyss + yystacksize - 1 <= yyssp)
-#if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    YYNOMEM;
-#else
-    {
-      /* Get the current used size of the three stacks, in elements.  */
-      YYPTRDIFF_T yysize = yyssp - yyss + 1;
-
-# if defined yyoverflow
-      {
-        /* Give user a chance to reallocate the stack.  Use copies of
-           these so that the &'s don't force the real ones into
-           memory.  */
-        yy_state_t *yyss1 = yyss;
-        YYSTYPE *yyvs1 = yyvs;
-
-        /* Each stack pointer address is followed by the size of the
-           data in use in that stack, in bytes.  This used to be a
-           conditional around just the two extra args, but that might
-           be undefined if yyoverflow is a macro.  */
-        yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * YYSIZEOF (*yyssp),
-                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
-                    &yystacksize);
-        yyss = yyss1;
-        yyvs = yyvs1;
-      }
-# else /* defined YYSTACK_RELOCATE */
-      /* Extend the stack our own way.  */
-      if (YYMAXDEPTH <= yystacksize)
-        YYNOMEM;
-      yystacksize *= 2;
-      if (YYMAXDEPTH < yystacksize)
-        yystacksize = YYMAXDEPTH;
-
-      {
-        yy_state_t *yyss1 = yyss;
-        union yyalloc *yyptr =
-          YY_CAST (union yyalloc *,
-                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
-        if (! yyptr)
-          YYNOMEM;
-        YYSTACK_RELOCATE (yyss_alloc, yyss);
-        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
-#  undef YYSTACK_RELOCATE
-        if (yyss1 != yyssa)
-          YYSTACK_FREE (yyss1);
-      }
-# endif
-
-      yyssp = yyss + yysize - 1;
-      yyvsp = yyvs + yysize - 1;
-
-      YY_IGNORE_USELESS_CAST_BEGIN
-      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
-                  YY_CAST (long, yystacksize)));
-      YY_IGNORE_USELESS_CAST_END
-
-      if (yyss + yystacksize - 1 <= yyssp)
-        YYABORT;
-    }
-#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
-
-
-  if (yystate == YYFINAL)
-    YYACCEPT;
-
-  goto yybackup;
-
-
-/*-----------.
-| yybackup.  |
-`-----------*/
-yybackup:
-  /* Do appropriate processing given the current state.  Read a
-     lookahead token if we need one and don't already have one.  */
-
-  /* First try to decide what to do without reference to lookahead token.  */
-  yyn = yypact[yystate];
-  if (yypact_value_is_default (yyn))
-    goto yydefault;
-
-  /* Not known => get a lookahead token if don't already have one.  */
-
-  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
-  if (yychar == YYEMPTY)
-    {
-      YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex ();
-    }
-
-  if (yychar <= YYEOF)
-    {
-      yychar = YYEOF;
-      yytoken = YYSYMBOL_YYEOF;
-      YYDPRINTF ((stderr, "Now at end of input.\n"));
-    }
-  else if (yychar == YYerror)
-    {
-      /* The scanner already issued an error message, process directly
-         to error recovery.  But do not keep the error token as
-         lookahead, it is too special and may lead us to an endless
-         loop in error recovery. */
-      yychar = YYUNDEF;
-      yytoken = YYSYMBOL_YYerror;
-      goto yyerrlab1;
-    }
-  else
-    {
-      yytoken = YYTRANSLATE (yychar);
-      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
-    }
-
-  /* If the proper action on seeing token YYTOKEN is to reduce or to
-     detect an error, take that action.  */
-  yyn += yytoken;
-  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
-    goto yydefault;
-  yyn = yytable[yyn];
-  if (yyn <= 0)
-    {
-      if (yytable_value_is_error (yyn))
-        goto yyerrlab;
-      yyn = -yyn;
-      goto yyreduce;
-    }
-
-  /* Count tokens shifted since error; after three, turn off error
-     status.  */
-  if (yyerrstatus)
-    yyerrstatus--;
-
-  /* Shift the lookahead token.  */
-  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-  yystate = yyn;
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  *++yyvsp = yylval;
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-  goto yynewstate;
-
-
-/*-----------------------------------------------------------.
-| yydefault -- do the default action for the current state.  |
-`-----------------------------------------------------------*/
-yydefault:
-  yyn = yydefact[yystate];
-  if (yyn == 0)
-    goto yyerrlab;
-  goto yyreduce;
-
-
-/*-----------------------------.
-| yyreduce -- do a reduction.  |
-`-----------------------------*/
-yyreduce:
-  /* yyn is the number of a rule to reduce with.  */
-  yylen = yyr2[yyn];
-
-  /* If YYLEN is nonzero, implement the default value of the action:
-     '$$ = $1'.
-
-     Otherwise, the following line sets YYVAL to garbage.
-     This behavior is undocumented and Bison
-     users should not rely upon it.  Assigning to YYVAL
-     unconditionally makes the parser a bit smaller, and it avoids a
-     GCC warning that YYVAL may be used uninitialized.  */
-  yyval = yyvsp[1-yylen];
-
-
-  YY_REDUCE_PRINT (yyn);
-  switch (yyn)
-    {
-  case 2: /* source: %empty  */
-#line 59 "parser.y"
-    { 
-        (yyval.node) = createASTNode(AST_PROGRAM, "Program", line_num);
-        root_ast = (yyval.node);
-    }
-#line 1267 "parser.tab.c"
-    break;
-
-  case 3: /* source: source sourceItem  */
-#line 63 "parser.y"
-                        {
-        (yyval.node) = addChild((yyvsp[-1].node), (yyvsp[0].node));
-        root_ast = (yyval.node);
-    }
-#line 1276 "parser.tab.c"
-    break;
-
-  case 4: /* sourceItem: funcDef  */
-#line 70 "parser.y"
-            { (yyval.node) = (yyvsp[0].node); }
-#line 1282 "parser.tab.c"
-    break;
-
-  case 5: /* funcDef: METHOD funcSignature body  */
-#line 74 "parser.y"
-                              {
-        (yyval.node) = createASTNode(AST_FUNCTION_DEF, "function", line_num);
-        addChild((yyval.node), (yyvsp[-1].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1292 "parser.tab.c"
-    break;
-
-  case 6: /* funcDef: METHOD funcSignature SEMICOLON  */
-#line 79 "parser.y"
-                                     {
-        (yyval.node) = createASTNode(AST_FUNCTION_DEF, "declaration", line_num);
-        addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1301 "parser.tab.c"
-    break;
-
-  case 7: /* funcSignature: IDENTIFIER LPAREN argDefList RPAREN  */
-#line 86 "parser.y"
-                                        {
-        (yyval.node) = createASTNode(AST_FUNCTION_SIGNATURE, (yyvsp[-3].str), line_num);
-        addChild((yyval.node), (yyvsp[-1].node));
-        free((yyvsp[-3].str));
-    }
-#line 1311 "parser.tab.c"
-    break;
-
-  case 8: /* funcSignature: IDENTIFIER LPAREN argDefList RPAREN COLON typeRef  */
-#line 91 "parser.y"
-                                                        {
-        (yyval.node) = createASTNode(AST_FUNCTION_SIGNATURE, (yyvsp[-5].str), line_num);
-        addChild((yyval.node), (yyvsp[-3].node));
-        addChild((yyval.node), (yyvsp[0].node));
-        free((yyvsp[-5].str));
-    }
-#line 1322 "parser.tab.c"
-    break;
-
-  case 9: /* argDefList: %empty  */
-#line 100 "parser.y"
-    { (yyval.node) = NULL; }
-#line 1328 "parser.tab.c"
-    break;
-
-  case 10: /* argDefList: argDefListNonEmpty  */
-#line 101 "parser.y"
-                         { (yyval.node) = (yyvsp[0].node); }
-#line 1334 "parser.tab.c"
-    break;
-
-  case 11: /* argDefListNonEmpty: argDef  */
-#line 105 "parser.y"
-           { (yyval.node) = (yyvsp[0].node); }
-#line 1340 "parser.tab.c"
-    break;
-
-  case 12: /* argDefListNonEmpty: argDefListNonEmpty COMMA argDef  */
-#line 106 "parser.y"
-                                      {
-        if ((yyvsp[-2].node) == NULL) {
-            (yyval.node) = (yyvsp[0].node);
-        } else {
-            (yyval.node) = addChild((yyvsp[-2].node), (yyvsp[0].node));
-        }
-    }
-#line 1352 "parser.tab.c"
-    break;
-
-  case 13: /* argDef: IDENTIFIER  */
-#line 116 "parser.y"
-               {
-        (yyval.node) = createASTNode(AST_ARG_DEF, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1361 "parser.tab.c"
-    break;
-
-  case 14: /* argDef: IDENTIFIER COLON typeRef  */
-#line 120 "parser.y"
-                               {
-        (yyval.node) = createASTNode(AST_ARG_DEF, (yyvsp[-2].str), line_num);
-        addChild((yyval.node), (yyvsp[0].node));
-        free((yyvsp[-2].str));
-    }
-#line 1371 "parser.tab.c"
-    break;
-
-  case 15: /* typeRef: BOOL_TYPE  */
-#line 128 "parser.y"
-              { (yyval.node) = createASTNode(AST_TYPE_REF, "bool", line_num); }
-#line 1377 "parser.tab.c"
-    break;
-
-  case 16: /* typeRef: BYTE_TYPE  */
-#line 129 "parser.y"
-                { (yyval.node) = createASTNode(AST_TYPE_REF, "byte", line_num); }
-#line 1383 "parser.tab.c"
-    break;
-
-  case 17: /* typeRef: INT_TYPE  */
-#line 130 "parser.y"
-               { (yyval.node) = createASTNode(AST_TYPE_REF, "int", line_num); }
-#line 1389 "parser.tab.c"
-    break;
-
-  case 18: /* typeRef: UINT_TYPE  */
-#line 131 "parser.y"
-                { (yyval.node) = createASTNode(AST_TYPE_REF, "uint", line_num); }
-#line 1395 "parser.tab.c"
-    break;
-
-  case 19: /* typeRef: LONG_TYPE  */
-#line 132 "parser.y"
-                { (yyval.node) = createASTNode(AST_TYPE_REF, "long", line_num); }
-#line 1401 "parser.tab.c"
-    break;
-
-  case 20: /* typeRef: ULONG_TYPE  */
-#line 133 "parser.y"
-                 { (yyval.node) = createASTNode(AST_TYPE_REF, "ulong", line_num); }
-#line 1407 "parser.tab.c"
-    break;
-
-  case 21: /* typeRef: CHAR_TYPE  */
-#line 134 "parser.y"
-                { (yyval.node) = createASTNode(AST_TYPE_REF, "char", line_num); }
-#line 1413 "parser.tab.c"
-    break;
-
-  case 22: /* typeRef: STRING_TYPE  */
-#line 135 "parser.y"
-                  { (yyval.node) = createASTNode(AST_TYPE_REF, "string", line_num); }
-#line 1419 "parser.tab.c"
-    break;
-
-  case 23: /* typeRef: IDENTIFIER  */
-#line 136 "parser.y"
-                 { 
-        (yyval.node) = createASTNode(AST_TYPE_REF, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1428 "parser.tab.c"
-    break;
-
-  case 24: /* typeRef: ARRAY LBRACKET commaList RBRACKET OF typeRef  */
-#line 140 "parser.y"
-                                                   {
-        (yyval.node) = createASTNode(AST_TYPE_REF, "array", line_num);
-        if ((yyvsp[-3].node)) addChild((yyval.node), (yyvsp[-3].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1438 "parser.tab.c"
-    break;
-
-  case 25: /* commaList: %empty  */
-#line 148 "parser.y"
-    { (yyval.node) = NULL; }
-#line 1444 "parser.tab.c"
-    break;
-
-  case 26: /* commaList: commaListNonEmpty  */
-#line 149 "parser.y"
-                        { (yyval.node) = (yyvsp[0].node); }
-#line 1450 "parser.tab.c"
-    break;
-
-  case 27: /* commaListNonEmpty: COMMA  */
-#line 153 "parser.y"
-          { (yyval.node) = createASTNode(AST_LITERAL, ",", line_num); }
-#line 1456 "parser.tab.c"
-    break;
-
-  case 28: /* commaListNonEmpty: commaListNonEmpty COMMA  */
-#line 154 "parser.y"
-                              {
-        (yyval.node) = addChild((yyvsp[-1].node), createASTNode(AST_LITERAL, ",", line_num));
-    }
-#line 1464 "parser.tab.c"
-    break;
-
-  case 29: /* body: varDeclarations statementBlock  */
-#line 160 "parser.y"
-                                   {
-        (yyval.node) = createASTNode(AST_STATEMENT_BLOCK, "body", line_num);
-        if ((yyvsp[-1].node)) addChild((yyval.node), (yyvsp[-1].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1474 "parser.tab.c"
-    break;
-
-  case 30: /* body: statementBlock  */
-#line 165 "parser.y"
-                     {
-        (yyval.node) = (yyvsp[0].node);
-    }
-#line 1482 "parser.tab.c"
-    break;
-
-  case 31: /* varDeclarations: %empty  */
-#line 171 "parser.y"
-    { (yyval.node) = NULL; }
-#line 1488 "parser.tab.c"
-    break;
-
-  case 32: /* varDeclarations: varDeclarations VAR identifierList COLON typeRef SEMICOLON  */
-#line 172 "parser.y"
-                                                                 {
-        ASTNode* varDecl = createASTNode(AST_VAR_DECLARATION, "var", line_num);
-        addChild(varDecl, (yyvsp[-3].node));
-        addChild(varDecl, (yyvsp[-1].node));
-
-        if ((yyvsp[-5].node) == NULL) {
-            (yyval.node) = varDecl;
-        } else {
-            (yyval.node) = addChild((yyvsp[-5].node), varDecl);
-        }
-    }
-#line 1504 "parser.tab.c"
-    break;
-
-  case 33: /* varDeclarations: varDeclarations VAR identifierList SEMICOLON  */
-#line 183 "parser.y"
-                                                   {
-        ASTNode* varDecl = createASTNode(AST_VAR_DECLARATION, "var", line_num);
-        addChild(varDecl, (yyvsp[-1].node));
-
-        if ((yyvsp[-3].node) == NULL) {
-            (yyval.node) = varDecl;
-        } else {
-            (yyval.node) = addChild((yyvsp[-3].node), varDecl);
-        }
-    }
-#line 1519 "parser.tab.c"
-    break;
-
-  case 34: /* identifierList: IDENTIFIER  */
-#line 196 "parser.y"
-               { 
-        (yyval.node) = createASTNode(AST_IDENTIFIER, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1528 "parser.tab.c"
-    break;
-
-  case 35: /* identifierList: identifierList COMMA IDENTIFIER  */
-#line 200 "parser.y"
-                                      {
-        (yyval.node) = addChild((yyvsp[-2].node), createASTNode(AST_IDENTIFIER, (yyvsp[0].str), line_num));
-        free((yyvsp[0].str));
-    }
-#line 1537 "parser.tab.c"
-    break;
-
-  case 36: /* statementBlock: BEGIN_KW statementList END SEMICOLON  */
-#line 207 "parser.y"
-                                         {
-        (yyval.node) = createASTNode(AST_STATEMENT_BLOCK, "begin", line_num);
-        if ((yyvsp[-2].node)) addChild((yyval.node), (yyvsp[-2].node));
-    }
-#line 1546 "parser.tab.c"
-    break;
-
-  case 37: /* statementList: %empty  */
-#line 214 "parser.y"
-    { (yyval.node) = NULL; }
-#line 1552 "parser.tab.c"
-    break;
-
-  case 38: /* statementList: statementList statement  */
-#line 215 "parser.y"
-                              {
-        if ((yyvsp[-1].node) == NULL) {
-            (yyval.node) = (yyvsp[0].node);
-        } else {
-            (yyval.node) = addChild((yyvsp[-1].node), (yyvsp[0].node));
-        }
-    }
-#line 1564 "parser.tab.c"
-    break;
-
-  case 39: /* statement: IF expr THEN statement  */
-#line 225 "parser.y"
-                           {
-        (yyval.node) = createASTNode(AST_IF_STATEMENT, "if", line_num);
-        addChild((yyval.node), (yyvsp[-2].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1574 "parser.tab.c"
-    break;
-
-  case 40: /* statement: IF expr THEN statement ELSE statement  */
-#line 230 "parser.y"
-                                            {
-        (yyval.node) = createASTNode(AST_IF_STATEMENT, "if-else", line_num);
-        addChild((yyval.node), (yyvsp[-4].node));
-        addChild((yyval.node), (yyvsp[-2].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1585 "parser.tab.c"
-    break;
-
-  case 41: /* statement: statementBlock  */
-#line 236 "parser.y"
-                     { (yyval.node) = (yyvsp[0].node); }
-#line 1591 "parser.tab.c"
-    break;
-
-  case 42: /* statement: WHILE expr DO statement  */
-#line 237 "parser.y"
-                              {
-        (yyval.node) = createASTNode(AST_WHILE_STATEMENT, "while", line_num);
-        addChild((yyval.node), (yyvsp[-2].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1601 "parser.tab.c"
-    break;
-
-  case 43: /* statement: REPEAT statement WHILE expr SEMICOLON  */
-#line 242 "parser.y"
-                                            {
-        (yyval.node) = createASTNode(AST_REPEAT_STATEMENT, "repeat-while", line_num);
-        addChild((yyval.node), (yyvsp[-3].node));
-        addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1611 "parser.tab.c"
-    break;
-
-  case 44: /* statement: REPEAT statement UNTIL expr SEMICOLON  */
-#line 247 "parser.y"
-                                            {
-        (yyval.node) = createASTNode(AST_REPEAT_STATEMENT, "repeat-until", line_num);
-        addChild((yyval.node), (yyvsp[-3].node));
-        addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1621 "parser.tab.c"
-    break;
-
-  case 45: /* statement: BREAK SEMICOLON  */
-#line 252 "parser.y"
-                      { 
-        (yyval.node) = createASTNode(AST_BREAK_STATEMENT, "break", line_num);
-    }
-#line 1629 "parser.tab.c"
-    break;
-
-  case 46: /* statement: expr SEMICOLON  */
-#line 255 "parser.y"
-                     {
-        (yyval.node) = createASTNode(AST_EXPR_STATEMENT, "expression", line_num);
-        addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1638 "parser.tab.c"
-    break;
-
-  case 47: /* expr: expr binOp expr  */
-#line 262 "parser.y"
-                    {
-        (yyval.node) = addChild((yyvsp[-1].node), (yyvsp[-2].node));
-        addChild((yyval.node), (yyvsp[0].node));
-    }
-#line 1647 "parser.tab.c"
-    break;
-
-  case 48: /* expr: unOp expr  */
-#line 266 "parser.y"
-                             {
-        (yyval.node) = addChild((yyvsp[-1].node), (yyvsp[0].node));
-    }
-#line 1655 "parser.tab.c"
-    break;
-
-  case 49: /* expr: LPAREN expr RPAREN  */
-#line 269 "parser.y"
-                         {
-        (yyval.node) = (yyvsp[-1].node);
-    }
-#line 1663 "parser.tab.c"
-    break;
-
-  case 50: /* expr: expr LPAREN exprList RPAREN  */
-#line 272 "parser.y"
-                                  {
-        (yyval.node) = createASTNode(AST_CALL_EXPR, "call", line_num);
-        addChild((yyval.node), (yyvsp[-3].node));
-        if ((yyvsp[-1].node)) addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1673 "parser.tab.c"
-    break;
-
-  case 51: /* expr: expr LBRACKET exprList RBRACKET  */
-#line 277 "parser.y"
-                                      {
-        (yyval.node) = createASTNode(AST_INDEX_EXPR, "index", line_num);
-        addChild((yyval.node), (yyvsp[-3].node));
-        if ((yyvsp[-1].node)) addChild((yyval.node), (yyvsp[-1].node));
-    }
-#line 1683 "parser.tab.c"
-    break;
-
-  case 52: /* expr: IDENTIFIER  */
-#line 282 "parser.y"
-                 { 
-        (yyval.node) = createASTNode(AST_IDENTIFIER, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1692 "parser.tab.c"
-    break;
-
-  case 53: /* expr: INT_LITERAL  */
-#line 286 "parser.y"
-                  {
-        char buf[32];
-        sprintf(buf, "%d", (yyvsp[0].num));
-        (yyval.node) = createASTNode(AST_LITERAL, buf, line_num);
-    }
-#line 1702 "parser.tab.c"
-    break;
-
-  case 54: /* expr: STRING_LITERAL  */
-#line 291 "parser.y"
-                     { 
-        (yyval.node) = createASTNode(AST_LITERAL, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1711 "parser.tab.c"
-    break;
-
-  case 55: /* expr: CHAR_LITERAL  */
-#line 295 "parser.y"
-                   { 
-        (yyval.node) = createASTNode(AST_LITERAL, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1720 "parser.tab.c"
-    break;
-
-  case 56: /* expr: HEX_LITERAL  */
-#line 299 "parser.y"
-                  { 
-        (yyval.node) = createASTNode(AST_LITERAL, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1729 "parser.tab.c"
-    break;
-
-  case 57: /* expr: BITS_LITERAL  */
-#line 303 "parser.y"
-                   { 
-        (yyval.node) = createASTNode(AST_LITERAL, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1738 "parser.tab.c"
-    break;
-
-  case 58: /* expr: BOOL_LITERAL  */
-#line 307 "parser.y"
-                   { 
-        (yyval.node) = createASTNode(AST_LITERAL, (yyvsp[0].str), line_num);
-        free((yyvsp[0].str));
-    }
-#line 1747 "parser.tab.c"
-    break;
-
-  case 59: /* exprList: %empty  */
-#line 314 "parser.y"
-    { (yyval.node) = NULL; }
-#line 1753 "parser.tab.c"
-    break;
-
-  case 60: /* exprList: exprListNonEmpty  */
-#line 315 "parser.y"
-                       { (yyval.node) = (yyvsp[0].node); }
-#line 1759 "parser.tab.c"
-    break;
-
-  case 61: /* exprListNonEmpty: expr  */
-#line 319 "parser.y"
-         { (yyval.node) = (yyvsp[0].node); }
-#line 1765 "parser.tab.c"
-    break;
-
-  case 62: /* exprListNonEmpty: exprListNonEmpty COMMA expr  */
-#line 320 "parser.y"
-                                  {
-        (yyval.node) = addChild((yyvsp[-2].node), (yyvsp[0].node));
-    }
-#line 1773 "parser.tab.c"
-    break;
-
-  case 63: /* binOp: ASSIGN  */
-#line 326 "parser.y"
-           { (yyval.node) = createASTNode(AST_BINARY_EXPR, ":=", line_num); }
-#line 1779 "parser.tab.c"
-    break;
-
-  case 64: /* binOp: PLUS  */
-#line 327 "parser.y"
-           { (yyval.node) = createASTNode(AST_BINARY_EXPR, "+", line_num); }
-#line 1785 "parser.tab.c"
-    break;
-
-  case 65: /* binOp: MINUS  */
-#line 328 "parser.y"
-            { (yyval.node) = createASTNode(AST_BINARY_EXPR, "-", line_num); }
-#line 1791 "parser.tab.c"
-    break;
-
-  case 66: /* binOp: MUL  */
-#line 329 "parser.y"
-          { (yyval.node) = createASTNode(AST_BINARY_EXPR, "*", line_num); }
-#line 1797 "parser.tab.c"
-    break;
-
-  case 67: /* binOp: DIV  */
-#line 330 "parser.y"
-          { (yyval.node) = createASTNode(AST_BINARY_EXPR, "/", line_num); }
-#line 1803 "parser.tab.c"
-    break;
-
-  case 68: /* binOp: MOD  */
-#line 331 "parser.y"
-          { (yyval.node) = createASTNode(AST_BINARY_EXPR, "%", line_num); }
-#line 1809 "parser.tab.c"
-    break;
-
-  case 69: /* binOp: EQ  */
-#line 332 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, "==", line_num); }
-#line 1815 "parser.tab.c"
-    break;
-
-  case 70: /* binOp: NE  */
-#line 333 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, "!=", line_num); }
-#line 1821 "parser.tab.c"
-    break;
-
-  case 71: /* binOp: LT  */
-#line 334 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, "<", line_num); }
-#line 1827 "parser.tab.c"
-    break;
-
-  case 72: /* binOp: LE  */
-#line 335 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, "<=", line_num); }
-#line 1833 "parser.tab.c"
-    break;
-
-  case 73: /* binOp: GT  */
-#line 336 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, ">", line_num); }
-#line 1839 "parser.tab.c"
-    break;
-
-  case 74: /* binOp: GE  */
-#line 337 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, ">=", line_num); }
-#line 1845 "parser.tab.c"
-    break;
-
-  case 75: /* binOp: AND  */
-#line 338 "parser.y"
-          { (yyval.node) = createASTNode(AST_BINARY_EXPR, "&&", line_num); }
-#line 1851 "parser.tab.c"
-    break;
-
-  case 76: /* binOp: OR  */
-#line 339 "parser.y"
-         { (yyval.node) = createASTNode(AST_BINARY_EXPR, "||", line_num); }
-#line 1857 "parser.tab.c"
-    break;
-
-  case 77: /* unOp: NOT  */
-#line 343 "parser.y"
-        { (yyval.node) = createASTNode(AST_UNARY_EXPR, "!", line_num); }
-#line 1863 "parser.tab.c"
-    break;
-
-  case 78: /* unOp: MINUS  */
-#line 344 "parser.y"
-            { (yyval.node) = createASTNode(AST_UNARY_EXPR, "-", line_num); }
-#line 1869 "parser.tab.c"
-    break;
-
-  case 79: /* unOp: PLUS  */
-#line 345 "parser.y"
-           { (yyval.node) = createASTNode(AST_UNARY_EXPR, "+", line_num); }
-#line 1875 "parser.tab.c"
-    break;
-
-
-#line 1879 "parser.tab.c"
-
-      default: break;
-    }
-  /* User semantic actions sometimes alter yychar, and that requires
-     that yytoken be updated with the new translation.  We take the
-     approach of translating immediately before every use of yytoken.
-     One alternative is translating here after every semantic action,
-     but that translation would be missed if the semantic action invokes
-     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
-     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
-     incorrect destructor might then be invoked immediately.  In the
-     case of YYERROR or YYBACKUP, subsequent parser actions might lead
-     to an incorrect destructor call or verbose syntax error message
-     before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
-
-  YYPOPSTACK (yylen);
-  yylen = 0;
-
-  *++yyvsp = yyval;
-
-  /* Now 'shift' the result of the reduction.  Determine what state
-     that goes to, based on the state we popped back to and the rule
-     number reduced by.  */
-  {
-    const int yylhs = yyr1[yyn] - YYNTOKENS;
-    const int yyi = yypgoto[yylhs] + *yyssp;
-    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
-               ? yytable[yyi]
-               : yydefgoto[yylhs]);
-  }
-
-  goto yynewstate;
-
-
-/*--------------------------------------.
-| yyerrlab -- here on detecting error.  |
-`--------------------------------------*/
-yyerrlab:
-  /* Make sure we have latest lookahead translation.  See comments at
-     user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
-  /* If not already recovering from an error, report this error.  */
-  if (!yyerrstatus)
-    {
-      ++yynerrs;
-      yyerror (YY_("syntax error"));
-    }
-
-  if (yyerrstatus == 3)
-    {
-      /* If just tried and failed to reuse lookahead token after an
-         error, discard it.  */
-
-      if (yychar <= YYEOF)
-        {
-          /* Return failure if at end of input.  */
-          if (yychar == YYEOF)
-            YYABORT;
-        }
-      else
-        {
-          yydestruct ("Error: discarding",
-                      yytoken, &yylval);
-          yychar = YYEMPTY;
-        }
-    }
-
-  /* Else will try to reuse lookahead token after shifting the error
-     token.  */
-  goto yyerrlab1;
-
-
-/*---------------------------------------------------.
-| yyerrorlab -- error raised explicitly by YYERROR.  |
-`---------------------------------------------------*/
-yyerrorlab:
-  /* Pacify compilers when the user code never invokes YYERROR and the
-     label yyerrorlab therefore never appears in user code.  */
-  if (0)
-    YYERROR;
-  ++yynerrs;
-
-  /* Do not reclaim the symbols of the rule whose action triggered
-     this YYERROR.  */
-  YYPOPSTACK (yylen);
-  yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
-  yystate = *yyssp;
-  goto yyerrlab1;
-
-
-/*-------------------------------------------------------------.
-| yyerrlab1 -- common code for both syntax error and YYERROR.  |
-`-------------------------------------------------------------*/
-yyerrlab1:
-  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
-
-  /* Pop stack until we find a state that shifts the error token.  */
-  for (;;)
-    {
-      yyn = yypact[yystate];
-      if (!yypact_value_is_default (yyn))
-        {
-          yyn += YYSYMBOL_YYerror;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
-            {
-              yyn = yytable[yyn];
-              if (0 < yyn)
-                break;
-            }
-        }
-
-      /* Pop the current state because it cannot handle the error token.  */
-      if (yyssp == yyss)
-        YYABORT;
-
-
-      yydestruct ("Error: popping",
-                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
-      YYPOPSTACK (1);
-      yystate = *yyssp;
-      YY_STACK_PRINT (yyss, yyssp);
-    }
-
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  *++yyvsp = yylval;
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-
-
-  /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
-
-  yystate = yyn;
-  goto yynewstate;
-
-
-/*-------------------------------------.
-| yyacceptlab -- YYACCEPT comes here.  |
-`-------------------------------------*/
-yyacceptlab:
-  yyresult = 0;
-  goto yyreturnlab;
-
-
-/*-----------------------------------.
-| yyabortlab -- YYABORT comes here.  |
-`-----------------------------------*/
-yyabortlab:
-  yyresult = 1;
-  goto yyreturnlab;
-
-
-/*-----------------------------------------------------------.
-| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
-`-----------------------------------------------------------*/
-yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
-  yyresult = 2;
-  goto yyreturnlab;
-
-
-/*----------------------------------------------------------.
-| yyreturnlab -- parsing is finished, clean up and return.  |
-`----------------------------------------------------------*/
-yyreturnlab:
-  if (yychar != YYEMPTY)
-    {
-      /* Make sure we have latest lookahead translation.  See comments at
-         user semantic actions for why this is necessary.  */
-      yytoken = YYTRANSLATE (yychar);
-      yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval);
-    }
-  /* Do not reclaim the symbols of the rule whose action triggered
-     this YYABORT or YYACCEPT.  */
-  YYPOPSTACK (yylen);
-  YY_STACK_PRINT (yyss, yyssp);
-  while (yyssp != yyss)
-    {
-      yydestruct ("Cleanup: popping",
-                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
-      YYPOPSTACK (1);
-    }
-#ifndef yyoverflow
-  if (yyss != yyssa)
-    YYSTACK_FREE (yyss);
-#endif
-
-  return yyresult;
-}
-
-#line 348 "parser.y"
-
-
-void yyerror(const char *s) {
-    fprintf(stderr, "Parse error: (%s) at token '%s' line %d\n", s, yytext, line_num);
-}
-
-int main() {
-    int result = yyparse();
-    if (result == 0) {
-        printf("Parsing successful\n");
-        if (root_ast) {
-            FILE* dotFile = fopen("ast.dot", "w");
-            if (dotFile) {
-                printASTDot(root_ast, dotFile);
-                fclose(dotFile);
-                printf("AST saved to ast.dot\n");
-                printf("To view: dot -Tpng ast.dot -o ast.png\n");
-            }
-            freeAST(root_ast);
-        }
-    } else {
-        printf("Parsing failed\n");
-    }
-    return result;
-}
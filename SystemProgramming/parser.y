@@ -1,33 +1,40 @@
-%{
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+%code requires {
 #include "ast.h"
 
-int yylex();
-void yyerror(const char *s);
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
 
-extern char *yytext;
+struct CompilerContext;
+}
 
-int line_num = 1;
-ASTNode* root_ast = NULL;
+%code {
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "lexer.h"
+void yyerror(yyscan_t scanner, struct CompilerContext* ctx, const char* s);
+}
 
-%}
+%define api.pure full
+%lex-param { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { struct CompilerContext* ctx }
 
 %union {
-    char *str;
-    int num;
+    SourceToken tok;
     struct ASTNode *node;
 }
 
-%token <str> IDENTIFIER
-%token <num> INT_LITERAL
-%token <str> FLOAT_LITERAL
-%token <str> STRING_LITERAL
-%token <str> CHAR_LITERAL
-%token <str> HEX_LITERAL
-%token <str> BITS_LITERAL
-%token <str> BOOL_LITERAL
+%token <tok> IDENTIFIER
+%token <tok> INT_LITERAL
+%token <tok> FLOAT_LITERAL
+%token <tok> STRING_LITERAL
+%token <tok> CHAR_LITERAL
+%token <tok> HEX_LITERAL
+%token <tok> BITS_LITERAL
+%token <tok> BOOL_LITERAL
 
 %token METHOD VAR BEGIN_KW END IF THEN ELSE WHILE DO REPEAT UNTIL BREAK
 %token BOOL_TYPE BYTE_TYPE INT_TYPE UINT_TYPE LONG_TYPE ULONG_TYPE FLOAT_TYPE DIN_TYPE CHAR_TYPE STRING_TYPE
@@ -62,12 +69,19 @@ ASTNode* root_ast = NULL;
 
 source:
     { 
-        $$ = createASTNode(AST_PROGRAM, "Program", line_num);
-        root_ast = $$;
+        $$ = createASTNode(AST_PROGRAM, "Program", ctx->line_num);
+        ctx->root_ast = $$;
     }
     | source sourceItem {
-        $$ = addChild($1, $2);
-        root_ast = $$;
+        if (ctx->stream) {
+            /* потоковый режим: функция сразу уходит в конвейер (compiler.c) */
+            compiler_stream_function(ctx, $2);
+            $$ = $1;
+        }
+        else {
+            $$ = addChild($1, $2);
+        }
+        ctx->root_ast = $$;
     }
     ;
 
@@ -77,27 +91,25 @@ sourceItem:
 
 funcDef:
     METHOD funcSignature body {
-        $$ = createASTNode(AST_FUNCTION_DEF, "function", line_num);
+        $$ = createASTNode(AST_FUNCTION_DEF, "function", ctx->line_num);
         addChild($$, $2);
         addChild($$, $3);
     }
     | METHOD funcSignature SEMICOLON {
-        $$ = createASTNode(AST_FUNCTION_DEF, "declaration", line_num);
+        $$ = createASTNode(AST_FUNCTION_DEF, "declaration", ctx->line_num);
         addChild($$, $2);
     }
     ;
 
 funcSignature:
     IDENTIFIER LPAREN argDefList RPAREN {
-        $$ = createASTNode(AST_FUNCTION_SIGNATURE, $1, line_num);
+        $$ = createASTNodeToken(AST_FUNCTION_SIGNATURE, $1, ctx->line_num);
         addChild($$, $3);
-        free($1);
     }
     | IDENTIFIER LPAREN argDefList RPAREN COLON typeRef {
-        $$ = createASTNode(AST_FUNCTION_SIGNATURE, $1, line_num);
+        $$ = createASTNodeToken(AST_FUNCTION_SIGNATURE, $1, ctx->line_num);
         addChild($$, $3);
         addChild($$, $6);
-        free($1);
     }
     ;
 
@@ -125,7 +137,7 @@ argDefListNonEmpty:
      *     ArgDef(t)
      */
     argDef {
-        $$ = createASTNode(AST_STATEMENT_LIST, "params", line_num);
+        $$ = createASTNode(AST_STATEMENT_LIST, "params", ctx->line_num);
         addChild($$, $1);
     }
     | argDefListNonEmpty COMMA argDef {
@@ -135,55 +147,50 @@ argDefListNonEmpty:
 
 argDef:
     IDENTIFIER {
-        $$ = createASTNode(AST_ARG_DEF, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_ARG_DEF, $1, ctx->line_num);
     }
     | IDENTIFIER COLON typeRef {
-        $$ = createASTNode(AST_ARG_DEF, $1, line_num);
+        $$ = createASTNodeToken(AST_ARG_DEF, $1, ctx->line_num);
         addChild($$, $3);
-        free($1);
     }
     ;
 
 typeRef:
-    BOOL_TYPE { $$ = createASTNode(AST_TYPE_REF, "bool", line_num); }
-    | BYTE_TYPE { $$ = createASTNode(AST_TYPE_REF, "byte", line_num); }
-    | INT_TYPE { $$ = createASTNode(AST_TYPE_REF, "int", line_num); }
-    | UINT_TYPE { $$ = createASTNode(AST_TYPE_REF, "uint", line_num); }
-    | LONG_TYPE { $$ = createASTNode(AST_TYPE_REF, "long", line_num); }
-    | ULONG_TYPE { $$ = createASTNode(AST_TYPE_REF, "ulong", line_num); }
-    | FLOAT_TYPE { $$ = createASTNode(AST_TYPE_REF, "float", line_num); }
-    | DIN_TYPE { $$ = createASTNode(AST_TYPE_REF, "din", line_num); }
-    | CHAR_TYPE { $$ = createASTNode(AST_TYPE_REF, "char", line_num); }
-    | STRING_TYPE { $$ = createASTNode(AST_TYPE_REF, "string", line_num); }
+    BOOL_TYPE { $$ = createASTNode(AST_TYPE_REF, "bool", ctx->line_num); }
+    | BYTE_TYPE { $$ = createASTNode(AST_TYPE_REF, "byte", ctx->line_num); }
+    | INT_TYPE { $$ = createASTNode(AST_TYPE_REF, "int", ctx->line_num); }
+    | UINT_TYPE { $$ = createASTNode(AST_TYPE_REF, "uint", ctx->line_num); }
+    | LONG_TYPE { $$ = createASTNode(AST_TYPE_REF, "long", ctx->line_num); }
+    | ULONG_TYPE { $$ = createASTNode(AST_TYPE_REF, "ulong", ctx->line_num); }
+    | FLOAT_TYPE { $$ = createASTNode(AST_TYPE_REF, "float", ctx->line_num); }
+    | DIN_TYPE { $$ = createASTNode(AST_TYPE_REF, "din", ctx->line_num); }
+    | CHAR_TYPE { $$ = createASTNode(AST_TYPE_REF, "char", ctx->line_num); }
+    | STRING_TYPE { $$ = createASTNode(AST_TYPE_REF, "string", ctx->line_num); }
     | IDENTIFIER {
-        $$ = createASTNode(AST_TYPE_REF, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_TYPE_REF, $1, ctx->line_num);
     }
 
     /* array[10] of T  — статический размер */
     | ARRAY LBRACKET INT_LITERAL RBRACKET OF typeRef {
-        $$ = createASTNode(AST_TYPE_REF, "array", line_num);
-        char buf[32];
-        sprintf(buf, "%d", $3);
-        ASTNode* sz = createASTNode(AST_LITERAL, buf, line_num);
+        $$ = createASTNode(AST_TYPE_REF, "array", ctx->line_num);
+        ASTNode* sz = createASTNodeToken(AST_LITERAL, $3, ctx->line_num);
         addChild($$, sz);
         addChild($$, $6);
     }
 
     /* array[x] of T — размер выражен идентификатором (обычно dynamic) */
     | ARRAY LBRACKET IDENTIFIER RBRACKET OF typeRef {
-        $$ = createASTNode(AST_TYPE_REF, "array", line_num);
-        ASTNode* sz = createASTNode(AST_IDENTIFIER, $3, line_num);
+        $$ = createASTNode(AST_TYPE_REF, "array", ctx->line_num);
+        ASTNode* sz = createASTNodeToken(AST_IDENTIFIER, $3, ctx->line_num);
         addChild($$, sz);
         addChild($$, $6);
-        free($3);
     }
 
     /* array[] of T — явный динамический массив */
     | ARRAY LBRACKET RBRACKET OF typeRef {
-        $$ = createASTNode(AST_TYPE_REF, "array", line_num);
-        ASTNode* sz = createASTNode(AST_LITERAL, "0", line_num); /* 0 => dynamic */
+        $$ = createASTNode(AST_TYPE_REF, "array", ctx->line_num);
+        ASTNode* sz = createASTNode(AST_LITERAL, NULL, ctx->line_num);
+        ast_set_int_literal(sz, 0); /* 0 => dynamic */
         addChild($$, sz);
         addChild($$, $5);
     }
@@ -192,7 +199,7 @@ typeRef:
 /* ��������� 1: �������� body - ������� ������ ���� ������ ���������� */
 body:
     varDeclarations BEGIN_KW statementList END SEMICOLON {
-        $$ = createASTNode(AST_STATEMENT_BLOCK, "body", line_num);
+        $$ = createASTNode(AST_STATEMENT_BLOCK, "body", ctx->line_num);
         if ($1) {
             /* ��������� ���������� ���������� ��� ����� ���� */
             addChild($$, $1);
@@ -208,7 +215,7 @@ body:
 varDeclarations:
     { $$ = NULL; }
     | varDeclarations VAR identifierList optionalType SEMICOLON {
-        ASTNode* varDecl = createASTNode(AST_VAR_DECLARATION, "var", line_num);
+        ASTNode* varDecl = createASTNode(AST_VAR_DECLARATION, "var", ctx->line_num);
         addChild(varDecl, $3);  /* identifierList */
         if ($4) {  /* optionalType, ���� ���� */
             addChild(varDecl, $4);
@@ -216,7 +223,7 @@ varDeclarations:
 
         if ($1 == NULL) {
             /* ������� ���� ������ ��� ���� ���������� */
-            $$ = createASTNode(AST_STATEMENT_LIST, "var_declarations", line_num);
+            $$ = createASTNode(AST_STATEMENT_LIST, "var_declarations", ctx->line_num);
             addChild($$, varDecl);
         } else {
             /* ��������� ����� ���������� � ������������ ������ */
@@ -232,25 +239,23 @@ optionalType:
 
 identifierList:
     IDENTIFIER { 
-        $$ = createASTNode(AST_IDENTIFIER, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_IDENTIFIER, $1, ctx->line_num);
     }
     | identifierList COMMA IDENTIFIER {
-        $$ = addChild($1, createASTNode(AST_IDENTIFIER, $3, line_num));
-        free($3);
+        $$ = addChild($1, createASTNodeToken(AST_IDENTIFIER, $3, ctx->line_num));
     }
     ;
 
 /* ��������� 3: �������� statementBlock - ������ ��� ����� begin-end */
 statementBlock:
     BEGIN_KW statementList END {
-        $$ = createASTNode(AST_STATEMENT_BLOCK, "begin", line_num);
+        $$ = createASTNode(AST_STATEMENT_BLOCK, "begin", ctx->line_num);
         if ($2) {
             addChild($$, $2);
         }
     }
     | BEGIN_KW statementList END SEMICOLON {
-        $$ = createASTNode(AST_STATEMENT_BLOCK, "begin", line_num);
+        $$ = createASTNode(AST_STATEMENT_BLOCK, "begin", ctx->line_num);
         if ($2) {
             addChild($$, $2);
         }
@@ -263,12 +268,12 @@ statementList:
         $$ = NULL; 
     }
     | statement {
-        $$ = createASTNode(AST_STATEMENT_LIST, "statements", line_num);
+        $$ = createASTNode(AST_STATEMENT_LIST, "statements", ctx->line_num);
         addChild($$, $1);
     }
     | statementList statement {
         if ($1 == NULL) {
-            $$ = createASTNode(AST_STATEMENT_LIST, "statements", line_num);
+            $$ = createASTNode(AST_STATEMENT_LIST, "statements", ctx->line_num);
             addChild($$, $2);
         } else {
             $$ = addChild($1, $2);
@@ -278,37 +283,37 @@ statementList:
 
 statement:
     IF expr THEN statement {
-        $$ = createASTNode(AST_IF_STATEMENT, "if", line_num);
+        $$ = createASTNode(AST_IF_STATEMENT, "if", ctx->line_num);
         addChild($$, $2);
         addChild($$, $4);
     }
     | IF expr THEN statement ELSE statement {
-        $$ = createASTNode(AST_IF_STATEMENT, "if-else", line_num);
+        $$ = createASTNode(AST_IF_STATEMENT, "if-else", ctx->line_num);
         addChild($$, $2);
         addChild($$, $4);
         addChild($$, $6);
     }
     | statementBlock { $$ = $1; }
     | WHILE expr DO statement {
-        $$ = createASTNode(AST_WHILE_STATEMENT, "while", line_num);
+        $$ = createASTNode(AST_WHILE_STATEMENT, "while", ctx->line_num);
         addChild($$, $2);
         addChild($$, $4);
     }
     | REPEAT statement UNTIL expr SEMICOLON {
-        $$ = createASTNode(AST_REPEAT_STATEMENT, "repeat-until", line_num);
+        $$ = createASTNode(AST_REPEAT_STATEMENT, "repeat-until", ctx->line_num);
         addChild($$, $2);
         addChild($$, $4);
     }
     | REPEAT statement WHILE expr SEMICOLON {
-        $$ = createASTNode(AST_REPEAT_STATEMENT, "repeat-while", line_num);
+        $$ = createASTNode(AST_REPEAT_STATEMENT, "repeat-while", ctx->line_num);
         addChild($$, $2);
         addChild($$, $4);
     }
     | BREAK SEMICOLON { 
-        $$ = createASTNode(AST_BREAK_STATEMENT, "break", line_num);
+        $$ = createASTNode(AST_BREAK_STATEMENT, "break", ctx->line_num);
     }
     | expr SEMICOLON {
-        $$ = createASTNode(AST_EXPR_STATEMENT, "expression", line_num);
+        $$ = createASTNode(AST_EXPR_STATEMENT, "expression", ctx->line_num);
         addChild($$, $1);
     }
     ;
@@ -318,7 +323,7 @@ statement:
 expr:
     logic_expr { $$ = $1; }
     | logic_expr ASSIGN expr {
-        $$ = createASTNode(AST_ASSIGNMENT, ":=", line_num);
+        $$ = createASTNode(AST_ASSIGNMENT, ":=", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
@@ -327,12 +332,12 @@ expr:
 logic_expr:
     comp_expr { $$ = $1; }
     | logic_expr OR comp_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "||", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "||", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | logic_expr AND comp_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "&&", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "&&", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
@@ -341,32 +346,32 @@ logic_expr:
 comp_expr:
     add_expr { $$ = $1; }
     | comp_expr EQ add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "==", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "==", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | comp_expr NE add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "!=", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "!=", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | comp_expr LT add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "<", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "<", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | comp_expr LE add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "<=", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "<=", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | comp_expr GT add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, ">", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, ">", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | comp_expr GE add_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, ">=", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, ">=", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
@@ -375,12 +380,12 @@ comp_expr:
 add_expr:
     mul_expr { $$ = $1; }
     | add_expr PLUS mul_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "+", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "+", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | add_expr MINUS mul_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "-", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "-", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
@@ -389,17 +394,17 @@ add_expr:
 mul_expr:
     unary_expr { $$ = $1; }
     | mul_expr MUL unary_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "*", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "*", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | mul_expr DIV unary_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "/", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "/", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
     | mul_expr MOD unary_expr {
-        $$ = createASTNode(AST_BINARY_EXPR, "%", line_num);
+        $$ = createASTNode(AST_BINARY_EXPR, "%", ctx->line_num);
         addChild($$, $1);
         addChild($$, $3);
     }
@@ -408,15 +413,15 @@ mul_expr:
 unary_expr:
     postfix_expr { $$ = $1; }
     | NOT unary_expr {
-        $$ = createASTNode(AST_UNARY_EXPR, "!", line_num);
+        $$ = createASTNode(AST_UNARY_EXPR, "!", ctx->line_num);
         addChild($$, $2);
     }
     | MINUS unary_expr %prec UMINUS {
-        $$ = createASTNode(AST_UNARY_EXPR, "-", line_num);
+        $$ = createASTNode(AST_UNARY_EXPR, "-", ctx->line_num);
         addChild($$, $2);
     }
     | PLUS unary_expr %prec UMINUS {
-        $$ = createASTNode(AST_UNARY_EXPR, "+", line_num);
+        $$ = createASTNode(AST_UNARY_EXPR, "+", ctx->line_num);
         addChild($$, $2);
     }
     ;
@@ -429,17 +434,17 @@ postfix_expr:
             func_name = $1->value;
         }
     
-        $$ = createASTNode(AST_CALL_EXPR, func_name, line_num);
+        $$ = createASTNode(AST_CALL_EXPR, func_name, ctx->line_num);
         addChild($$, $1);
         if ($3) {
             addChild($$, $3);
         } else {
-            ASTNode* empty_args = createASTNode(AST_STATEMENT_LIST, "args", line_num);
+            ASTNode* empty_args = createASTNode(AST_STATEMENT_LIST, "args", ctx->line_num);
             addChild($$, empty_args);
         }
     }
     | postfix_expr LBRACKET exprList RBRACKET {
-        $$ = createASTNode(AST_INDEX_EXPR, "index", line_num);
+        $$ = createASTNode(AST_INDEX_EXPR, "index", ctx->line_num);
         addChild($$, $1);
         if ($3) addChild($$, $3);
     }
@@ -447,37 +452,28 @@ postfix_expr:
 
 primary_expr:
     IDENTIFIER { 
-        $$ = createASTNode(AST_IDENTIFIER, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_IDENTIFIER, $1, ctx->line_num);
     }
     | INT_LITERAL {
-        char buf[32];
-        sprintf(buf, "%d", $1);
-        $$ = createASTNode(AST_LITERAL, buf, line_num);
+        $$ = createASTNodeToken(AST_LITERAL, $1, ctx->line_num);
     }
     | FLOAT_LITERAL {
-        $$ = createASTNode(AST_FLOAT_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_FLOAT_LITERAL, $1, ctx->line_num);
     }
     | STRING_LITERAL { 
-        $$ = createASTNode(AST_STRING_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_STRING_LITERAL, $1, ctx->line_num);
     }
     | CHAR_LITERAL { 
-        $$ = createASTNode(AST_CHAR_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_CHAR_LITERAL, $1, ctx->line_num);
     }
     | HEX_LITERAL { 
-        $$ = createASTNode(AST_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_LITERAL, $1, ctx->line_num);
     }
     | BITS_LITERAL { 
-        $$ = createASTNode(AST_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_LITERAL, $1, ctx->line_num);
     }
     | BOOL_LITERAL { 
-        $$ = createASTNode(AST_BOOL_LITERAL, $1, line_num);
-        free($1);
+        $$ = createASTNodeToken(AST_BOOL_LITERAL, $1, ctx->line_num);
     }
     | LPAREN expr RPAREN {
         $$ = $2;
@@ -491,7 +487,7 @@ exprList:
 
 exprListNonEmpty:
     expr { 
-        ASTNode* list = createASTNode(AST_STATEMENT_LIST, "args", line_num);
+        ASTNode* list = createASTNode(AST_STATEMENT_LIST, "args", ctx->line_num);
         addChild(list, $1);
         $$ = list;
     }
@@ -503,6 +499,9 @@ exprListNonEmpty:
 
 %%
 
-void yyerror(const char *s) {
-    fprintf(stderr, "Parse error: (%s) at token '%s' line %d\n", s, yytext, line_num);
+void yyerror(yyscan_t scanner, struct CompilerContext* ctx, const char *s) {
+    ctx->parse_failed = 1;
+    SourceLocation loc = source_span_location(ctx->sources, lexer_token_span(scanner));
+    fprintf(stderr, "%s:%d:%d: Parse error: (%s) at token '%s'\n",
+        loc.path, loc.line, loc.column, s, yyget_text(scanner));
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 ﻿#include "project.h"
+#include "thread.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -18,12 +19,14 @@ Project* project_create(void) {
     proj->callgraph = callgraph_create();
     proj->global_symbols = symbol_table_create();
 
+    proj->worker_count = thread_cpu_count();
+    proj->scheduler = NULL;
+    proj->error_count = 0;
+
     return proj;
 }
 
-void project_add_file(Project* proj, const char* filename, const char* filepath, ASTNode* ast) {
-    if (!proj || !filename || !ast) return;
-
+static SourceFile* project_new_file(Project* proj, const char* filename, const char* filepath) {
     if (proj->file_count >= proj->max_files) {
         proj->max_files *= 2;
         proj->files = (SourceFile*)realloc(proj->files, proj->max_files * sizeof(SourceFile));
@@ -41,8 +44,192 @@ void project_add_file(Project* proj, const char* filename, const char* filepath,
         file->filepath[0] = '\0';
     }
 
-    file->ast = ast;
+    file->ast = NULL;
+    file->ctx = compiler_context_create(filename);
+    file->parsed = 0;
     proj->file_count++;
+    return file;
+}
+
+static Scheduler* project_scheduler(Project* proj) {
+    if (!proj->scheduler) {
+        proj->scheduler = scheduler_create(proj->worker_count);
+    }
+    return proj->scheduler;
+}
+
+/* Уже разобранный файл: AST переходит во владение проекта */
+void project_add_file(Project* proj, const char* filename, const char* filepath, ASTNode* ast) {
+    if (!proj || !filename || !ast) return;
+
+    SourceFile* file = project_new_file(proj, filename, filepath);
+    file->ast = ast;
+    file->ctx->root_ast = ast;
+    file->parsed = 1;
+}
+
+/* Файл для разбора в project_parse_files */
+void project_add_source(Project* proj, const char* filepath) {
+    if (!proj || !filepath) return;
+
+    const char* filename = filepath;
+    for (const char* p = filepath; *p; p++) {
+        if (*p == '/' || *p == '\\') filename = p + 1;
+    }
+    project_new_file(proj, filename, filepath);
+}
+
+/* =========================
+ * Parsing + semantic analysis (по файлу на задачу)
+ * ========================= */
+
+static void parse_file_task(void* arg, int index) {
+    Project* proj = (Project*)arg;
+    SourceFile* file = &proj->files[index];
+    CompilerContext* ctx = file->ctx;
+    if (!ctx) return;
+
+    if (!file->parsed) {
+        file->parsed = compiler_parse_file(ctx, file->filepath);
+        if (!file->parsed) {
+            fprintf(stderr, "[ERROR] Parse failed: %s\n", file->filepath);
+            return;
+        }
+        file->ast = ctx->root_ast;
+    }
+
+    compiler_analyze(ctx);
+}
+
+int project_parse_files(Project* proj) {
+    if (!proj) return 0;
+
+    Scheduler* sched = project_scheduler(proj);
+    printf("[*] Parsing %d file(s) on %d worker(s)...\n", proj->file_count, scheduler_worker_count(sched));
+    scheduler_parallel_for(sched, proj->file_count, parse_file_task, proj);
+
+    int failed = 0;
+    for (int i = 0; i < proj->file_count; i++) {
+        SourceFile* file = &proj->files[i];
+        if (!file->parsed || !file->ctx || !file->ctx->symbol_table) {
+            failed++;
+            continue;
+        }
+        if (file->ctx->symbol_table->error_count > 0) {
+            printf("  %s: %d semantic error(s)\n", file->filename, file->ctx->symbol_table->error_count);
+        }
+    }
+    proj->error_count += failed;
+
+    printf("[+] Parsed %d of %d file(s)\n", proj->file_count - failed, proj->file_count);
+    return failed == 0;
+}
+
+/* =========================
+ * Linking of global symbols
+ * ========================= */
+
+static int is_function_definition(const ASTNode* func_def) {
+    if (!func_def || func_def->type != AST_FUNCTION_DEF) return 0;
+    if (func_def->value && strcmp(func_def->value, "declaration") == 0) return 0;
+    return func_def->child_count >= 2;
+}
+
+static const char* function_def_name(const ASTNode* func_def) {
+    if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
+        return func_def->children[0]->value;
+    }
+    return NULL;
+}
+
+static void link_error(Project* proj, const char* fmt, const char* name, const char* file) {
+    char msg[512];
+    snprintf(msg, sizeof(msg), fmt, name, file);
+    fprintf(stderr, "[LINK] %s\n", msg);
+    symbol_table_add_error(proj->global_symbols, msg);
+    proj->error_count++;
+}
+
+int project_link_symbols(Project* proj) {
+    if (!proj) return 0;
+
+    printf("[*] Linking global symbols...\n");
+    SymbolTable* gst = proj->global_symbols;
+    int errors_before = proj->error_count;
+
+    /* 1. определения функций - в порядке файлов */
+    for (int f = 0; f < proj->file_count; f++) {
+        SourceFile* file = &proj->files[f];
+        if (!file->parsed || !file->ctx->symbol_table) continue;
+        SymbolTable* st = file->ctx->symbol_table;
+
+        for (int i = 0; i < file->ast->child_count; i++) {
+            ASTNode* func_def = file->ast->children[i];
+            const char* name = is_function_definition(func_def) ? function_def_name(func_def) : NULL;
+            if (!name) continue;
+
+            Symbol* prev = symbol_table_lookup_global(gst, name);
+            if (prev && prev->type == SYM_FUNCTION) {
+                link_error(proj, "Multiple definition of function '%s' (%s)", name, file->filename);
+                continue;
+            }
+
+            Symbol* sym = symbol_table_lookup_global(st, name);
+            if (!sym || sym->type != SYM_FUNCTION) continue;
+            symbol_table_add_function(gst, name, sym->return_type, sym->param_count, sym->param_types);
+        }
+    }
+
+    /* 2. глобальные переменные: общее размещение, адреса переносятся в таблицы файлов */
+    for (int f = 0; f < proj->file_count; f++) {
+        SourceFile* file = &proj->files[f];
+        if (!file->parsed || !file->ctx->symbol_table) continue;
+        SymbolTable* st = file->ctx->symbol_table;
+
+        for (int i = 0; i < st->symbol_count; i++) {
+            Symbol* sym = &st->symbols[i];
+            if (sym->type != SYM_GLOBAL || !sym->scope || sym->scope->type != SCOPE_GLOBAL) continue;
+
+            if (symbol_table_lookup_global(gst, sym->name)) {
+                link_error(proj, "Multiple definition of global '%s' (%s)", sym->name, file->filename);
+                continue;
+            }
+            symbol_table_add_global(gst, sym->name, sym->data_type, sym->is_array, sym->array_size);
+
+            Symbol* merged = symbol_table_lookup_global(gst, sym->name);
+            if (merged) {
+                sym->offset = merged->offset;
+                sym->address = merged->address;
+            }
+        }
+    }
+
+    /* 3. объявления должны быть определены где-то в проекте */
+    for (int f = 0; f < proj->file_count; f++) {
+        SourceFile* file = &proj->files[f];
+        if (!file->parsed || !file->ctx->symbol_table) continue;
+
+        for (int i = 0; i < file->ast->child_count; i++) {
+            ASTNode* func_def = file->ast->children[i];
+            if (!func_def || func_def->type != AST_FUNCTION_DEF || is_function_definition(func_def)) continue;
+            const char* name = function_def_name(func_def);
+            if (!name) continue;
+
+            Symbol* def = symbol_table_lookup_global(gst, name);
+            Symbol* decl = symbol_table_lookup_global(file->ctx->symbol_table, name);
+            if (!def || def->type != SYM_FUNCTION) {
+                link_error(proj, "Undefined function '%s' (declared in %s)", name, file->filename);
+            }
+            else if (decl && decl->param_count != def->param_count) {
+                link_error(proj, "Declaration of '%s' does not match its definition (%s)", name, file->filename);
+            }
+        }
+    }
+
+    int errors = proj->error_count - errors_before;
+    printf("[+] Link: %d symbol(s), %d byte(s) of globals, %d error(s)\n",
+        gst->symbol_count, gst->global_offset, errors);
+    return errors == 0;
 }
 
 static char* get_file_basename(const char* filepath) {
@@ -67,23 +254,35 @@ static char* get_file_basename(const char* filepath) {
     return basename;
 }
 
+/* =========================
+ * Per-function CFGs
+ * ========================= */
+
+static void build_cfg_task(void* arg, int index) {
+    Project* proj = (Project*)arg;
+    FunctionInfo* func_info = &proj->functions[index];
+
+    CFG* cfg = cfg_create();
+    cfg_set_symbol_table(cfg, func_info->source_file->ctx->symbol_table);
+    cfg_build_function(cfg, func_info->func_def);
+    func_info->cfg = cfg;
+}
+
 void project_build_cfgs(Project* proj) {
     if (!proj) return;
 
+    /* список функций - последовательно, в порядке файлов и определений */
     for (int f = 0; f < proj->file_count; f++) {
         ASTNode* ast = proj->files[f].ast;
-        if (!ast || ast->type != AST_PROGRAM) continue;
+        if (!ast || ast->type != AST_PROGRAM || !proj->files[f].ctx->symbol_table) continue;
 
         for (int i = 0; i < ast->child_count; i++) {
             ASTNode* func_def = ast->children[i];
-            if (func_def->type != AST_FUNCTION_DEF) continue;
+            if (!is_function_definition(func_def)) continue;
 
             char func_name[256] = "unknown";
-            if (func_def->child_count > 0 &&
-                func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
-                if (func_def->children[0]->value) {
-                    snprintf(func_name, sizeof(func_name), "%s", func_def->children[0]->value);
-                }
+            if (function_def_name(func_def)) {
+                snprintf(func_name, sizeof(func_name), "%s", function_def_name(func_def));
             }
 
             if (proj->function_count >= proj->max_functions) {
@@ -92,56 +291,44 @@ void project_build_cfgs(Project* proj) {
                     proj->max_functions * sizeof(FunctionInfo));
             }
 
-            CFG* cfg = cfg_create();
-            cfg_build_from_ast(cfg, func_def);
-
             FunctionInfo* func_info = &proj->functions[proj->function_count];
             func_info->function_name = (char*)malloc(strlen(func_name) + 1);
             strcpy(func_info->function_name, func_name);
 
-            func_info->signature = (char*)malloc(256);
-            snprintf(func_info->signature, 256, "%s(...)", func_name);
+            /* имя + "(...)" + '\0' */
+            size_t signature_size = strlen(func_name) + 6;
+            func_info->signature = (char*)malloc(signature_size);
+            snprintf(func_info->signature, signature_size, "%s(...)", func_name);
 
-            func_info->cfg = cfg;
+            func_info->cfg = NULL;
             func_info->source_file = &proj->files[f];
-            func_info->line_number = 0;
+            func_info->line_number = func_def->line_number;
+            func_info->func_def = func_def;
+            func_info->asm_text = NULL;
+            func_info->asm_len = 0;
 
             proj->function_count++;
         }
     }
+
+    printf("[*] Building CFGs for %d function(s)...\n", proj->function_count);
+    scheduler_parallel_for(project_scheduler(proj), proj->function_count, build_cfg_task, proj);
+}
+
+/* Вызовы в дереве выражения; имя вызываемой функции - в value узла вызова */
+static void collect_calls(const ASTNode* node, const char* func_name, CallGraph* cg) {
+    if (!node) return;
+    if (node->type == AST_CALL_EXPR && node->value) callgraph_add_call(cg, func_name, node->value);
+    for (int i = 0; i < node->child_count; i++) collect_calls(node->children[i], func_name, cg);
 }
 
 static void extract_function_calls(CFG* cfg, const char* func_name, CallGraph* cg) {
     if (!cfg || !func_name || !cg) return;
 
     for (int i = 0; i < cfg->node_count; i++) {
-        CFGNode* node = cfg->nodes[i];
-
-        if (!node->label) continue;
-        const char* label = node->label;
-        int label_len = strlen(label);
-
-        for (int j = 0; j < label_len - 1; j++) {
-            if (label[j] == '(') {
-                int k = j - 1;
-                while (k >= 0 && label[k] == ' ') k--;
-
-                int end = k;
-                while (k >= 0 && (label[k] >= 'a' && label[k] <= 'z' ||
-                    label[k] >= 'A' && label[k] <= 'Z' ||
-                    label[k] >= '0' && label[k] <= '9' ||
-                    label[k] == '_')) {
-                    k--;
-                }
-
-                if (k < end && end - k < 256) {
-                    char called_func[256];
-                    strncpy(called_func, label + k + 1, end - k);
-                    called_func[end - k] = '\0';
-
-                    callgraph_add_call(cg, func_name, called_func);
-                }
-            }
+        const CFGNode* node = cfg->nodes[i];
+        for (int k = 0; k < node->expr_tree_count; k++) {
+            collect_calls(node->expr_trees[k], func_name, cg);
         }
     }
 }
@@ -155,6 +342,83 @@ void project_build_callgraph(Project* proj) {
     }
 }
 
+/* =========================
+ * Optimization (по функции на задачу)
+ * ========================= */
+
+static void optimize_function_task(void* arg, int index) {
+    Project* proj = (Project*)arg;
+    FunctionInfo* func = &proj->functions[index];
+    if (!func->cfg) return;
+    compiler_run_passes(func->cfg, func->source_file->ctx->symbol_table);
+}
+
+void project_optimize(Project* proj) {
+    if (!proj) return;
+
+    printf("[*] Optimizing %d function(s)...\n", proj->function_count);
+
+    /* Функции одного файла меняют его таблицу символов ($cseN из CSE) -
+       они выполняются по очереди; разные файлы идут параллельно. */
+    TaskGraph* g = task_graph_create();
+    int prev_task = -1;
+    for (int i = 0; i < proj->function_count; i++) {
+        int t = task_graph_add(g, optimize_function_task, proj, i);
+        if (i > 0 && proj->functions[i - 1].source_file == proj->functions[i].source_file) {
+            task_graph_depend(g, t, prev_task);
+        }
+        prev_task = t;
+    }
+    task_graph_run(g, project_scheduler(proj));
+    task_graph_free(g);
+}
+
+/* =========================
+ * Code generation + сборка одного asm
+ * ========================= */
+
+typedef struct {
+    Project* proj;
+    CodegenOptions opt;
+} EmitJob;
+
+static void emit_function_task(void* arg, int index) {
+    EmitJob* job = (EmitJob*)arg;
+    FunctionInfo* func = &job->proj->functions[index];
+    if (!func->cfg) return;
+
+    func->asm_text = codegen_generate_functions(func->cfg,
+        func->source_file->ctx->symbol_table, job->opt, &func->asm_len);
+}
+
+int project_emit_asm(Project* proj, const char* output_path, CodegenOptions opt) {
+    if (!proj || !output_path) return 0;
+
+    EmitJob job;
+    job.proj = proj;
+    job.opt = opt;
+    job.opt.workers = 1;    /* параллелим по функциям проекта, не внутри CFG */
+    scheduler_parallel_for(project_scheduler(proj), proj->function_count, emit_function_task, &job);
+
+    FILE* out = fopen(output_path, "wb");
+    if (!out) return 0;
+
+    int ok = codegen_write_prologue(out, opt);
+    for (int i = 0; i < proj->function_count && ok; i++) {
+        FunctionInfo* func = &proj->functions[i];
+        if (!func->asm_text) {
+            fprintf(stderr, "[ERROR] Code generation failed: %s()\n", func->function_name);
+            ok = 0;
+            break;
+        }
+        if (fwrite(func->asm_text, 1, func->asm_len, out) != func->asm_len) ok = 0;
+    }
+    if (ok) ok = codegen_write_epilogue(out);
+
+    fclose(out);
+    return ok;
+}
+
 void project_export(Project* proj, const char* output_dir) {
     if (!proj) return;
 
@@ -231,19 +495,21 @@ void project_free(Project* proj) {
     for (int i = 0; i < proj->file_count; i++) {
         free(proj->files[i].filename);
         free(proj->files[i].filepath);
-        freeAST(proj->files[i].ast);
+        compiler_context_free(proj->files[i].ctx);    /* владеет AST */
     }
     free(proj->files);
 
     for (int i = 0; i < proj->function_count; i++) {
         free(proj->functions[i].function_name);
         free(proj->functions[i].signature);
-        cfg_free(proj->functions[i].cfg);
+        free(proj->functions[i].asm_text);
+        if (proj->functions[i].cfg) cfg_free(proj->functions[i].cfg);
     }
     free(proj->functions);
 
     callgraph_free(proj->callgraph);
     symbol_table_free(proj->global_symbols);
+    scheduler_free(proj->scheduler);
 
     free(proj);
 }
@@ -5,11 +5,35 @@
 #include "cfg.h"
 #include "callgraph.h"
 #include "semantic.h"
+#include "codegen.h"
+#include "compiler.h"
+#include "sched.h"
+
+/*
+ * Многофайловая компиляция.
+ *
+ *   project_parse_files   - разбор + семантика каждого файла (параллельно,
+ *                           у файла свой CompilerContext и таблица символов)
+ *   project_link_symbols  - слияние глобальных символов в global_symbols
+ *                           в порядке файлов (детерминированно): функции,
+ *                           глобальные переменные (им назначаются общие адреса),
+ *                           проверка объявлений без определения
+ *   project_build_cfgs    - CFG каждой функции (параллельно по функциям)
+ *   project_optimize      - оптимизации по функциям; функции одного файла
+ *                           связаны зависимостями в графе задач (CSE заводит
+ *                           временные переменные в таблице символов файла)
+ *   project_emit_asm      - codegen функций параллельно, сборка одного asm
+ *                           в порядке файлов и функций
+ *
+ * Все стадии выполняются графами задач на общем планировщике (sched.h).
+ */
 
 typedef struct {
     char* filename;       
     char* filepath;      
     ASTNode* ast;
+    CompilerContext* ctx;       /* AST, таблица символов и escape-анализ файла */
+    int parsed;                 /* AST построен */
 } SourceFile;
 
 typedef struct {
@@ -18,6 +42,9 @@ typedef struct {
     CFG* cfg;
     SourceFile* source_file;
     int line_number;
+    ASTNode* func_def;
+    char* asm_text;             /* результат codegen (project_emit_asm) */
+    size_t asm_len;
 } FunctionInfo;
 
 typedef struct {
@@ -31,12 +58,21 @@ typedef struct {
 
     CallGraph* callgraph;
     SymbolTable* global_symbols;
+
+    int worker_count;           /* потоков планировщика (по умолчанию - число CPU) */
+    Scheduler* scheduler;       /* создаётся при первой параллельной стадии */
+    int error_count;            /* ошибки разбора и связывания */
 } Project;
 
 Project* project_create(void);
 void project_add_file(Project* proj, const char* filename, const char* filepath, ASTNode* ast);
+void project_add_source(Project* proj, const char* filepath);
+int project_parse_files(Project* proj);
+int project_link_symbols(Project* proj);
 void project_build_cfgs(Project* proj);
 void project_build_callgraph(Project* proj);
+void project_optimize(Project* proj);
+int project_emit_asm(Project* proj, const char* output_path, CodegenOptions opt);
 void project_export(Project* proj, const char* output_dir);
 void project_print_summary(Project* proj);
 void project_free(Project* proj);
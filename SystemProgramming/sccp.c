@@ -0,0 +1,430 @@
+﻿#include "sccp.h"
+#include "liveness.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================
+ * Lattice
+ * ========================= */
+
+typedef enum {
+    SC_TOP = 0,      /* значение ещё не известно (узел не исполнялся) */
+    SC_CONST = 1,
+    SC_BOTTOM = 2    /* не константа */
+} SCKind;
+
+typedef struct {
+    int kind;
+    int32_t value;
+} SCValue;
+
+static SCValue sc_make(int kind, int32_t value) {
+    SCValue v;
+    v.kind = kind;
+    v.value = value;
+    return v;
+}
+
+static SCValue sc_const(int32_t value) { return sc_make(SC_CONST, value); }
+static SCValue sc_bottom(void) { return sc_make(SC_BOTTOM, 0); }
+
+static SCValue sc_meet(SCValue a, SCValue b) {
+    if (a.kind == SC_TOP) return b;
+    if (b.kind == SC_TOP) return a;
+    if (a.kind == SC_CONST && b.kind == SC_CONST && a.value == b.value) return a;
+    return sc_bottom();
+}
+
+static int sc_same(SCValue a, SCValue b) {
+    return a.kind == b.kind && (a.kind != SC_CONST || a.value == b.value);
+}
+
+/* Типы, значения которых codegen держит одним 32-битным словом */
+static int sc_is_int_type(const Type* t) {
+    return t && type_element(t)->is_integer;
+}
+
+/* Литерал, который codegen загрузит одной MOVI (или MOVI/MOVI/SUB) */
+static int sc_fits_literal(int32_t v) {
+    return v >= -65535 && v <= 65535;
+}
+
+/* =========================
+ * Pass state
+ * ========================= */
+
+typedef struct {
+    const SymbolTable* st;
+    Liveness* lv;
+    unsigned char* tracked;   /* var -> 1, если значение переменной отслеживается */
+    int rewrite;              /* 1 - заменять константные подвыражения литералами */
+    int substituted;
+} SCCP;
+
+static int sc_has_side_effects(const ASTNode* e) {
+    if (!e) return 0;
+    if (e->type == AST_CALL_EXPR || e->type == AST_ASSIGNMENT || e->type == AST_INDEXED_ASSIGNMENT) return 1;
+    for (int i = 0; i < e->child_count; i++) {
+        if (sc_has_side_effects(e->children[i])) return 1;
+    }
+    return 0;
+}
+
+/* Узел выражения превращается в литерал на месте (указатели на него остаются валидны) */
+static void sc_fold(SCCP* s, ASTNode* e, SCValue v) {
+    if (!s->rewrite || !e || v.kind != SC_CONST) return;
+    if (e->type == AST_LITERAL || e->type == AST_BOOL_LITERAL || e->type == AST_CHAR_LITERAL) return;
+    if (!sc_fits_literal(v.value) || sc_has_side_effects(e)) return;
+
+    for (int i = 0; i < e->child_count; i++) freeAST(e->children[i]);
+    free(e->children);
+    e->children = NULL;
+    e->child_count = 0;
+
+    ast_set_int_literal(e, v.value);
+    s->substituted++;
+}
+
+static SCValue sc_literal(const ASTNode* e) {
+    switch (e->type) {
+    case AST_LITERAL:
+        /* codegen.c загружает все 32 бита литерала */
+        return e->literal.kind == LIT_INT ? sc_const((int32_t)(uint32_t)e->literal.value) : sc_bottom();
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+        return e->literal.kind != LIT_NONE ? sc_const((int32_t)e->literal.value) : sc_bottom();
+    default:
+        return sc_bottom();
+    }
+}
+
+static SCValue sc_ident(const SCCP* s, const ASTNode* e, const SCValue* env) {
+    int v = liveness_var_of_ident(s->lv, e);
+    if (v >= 0) return s->tracked[v] ? env[v] : sc_bottom();
+
+    /* глобальная константа: вместо LDC - её значение */
+    const Symbol* sym = symbol_table_resolve(s->st, e, s->lv->scope_id);
+    if (sym && sym->type == SYM_CONSTANT && sym->const_value && sc_is_int_type(sym->dtype)) {
+        char* end = NULL;
+        long val = strtol(sym->const_value, &end, 0);
+        if (end != sym->const_value && *end == '\0') return sc_const((int32_t)val);
+    }
+    return sc_bottom();
+}
+
+static SCValue sc_binary(const char* op, SCValue l, SCValue r) {
+    if (l.kind == SC_BOTTOM || r.kind == SC_BOTTOM) return sc_bottom();
+    if (l.kind == SC_TOP || r.kind == SC_TOP) return sc_make(SC_TOP, 0);
+
+    /* арифметика регистров NOOBIK: 32 бита с переполнением */
+    uint32_t a = (uint32_t)l.value, b = (uint32_t)r.value;
+    if (!strcmp(op, "+")) return sc_const((int32_t)(a + b));
+    if (!strcmp(op, "-")) return sc_const((int32_t)(a - b));
+    if (!strcmp(op, "*")) return sc_const((int32_t)(a * b));
+    if (!strcmp(op, "&")) return sc_const((int32_t)(a & b));
+    if (!strcmp(op, "|")) return sc_const((int32_t)(a | b));
+    if (!strcmp(op, "^")) return sc_const((int32_t)(a ^ b));
+    if (!strcmp(op, "==")) return sc_const(l.value == r.value);
+    if (!strcmp(op, "!=")) return sc_const(l.value != r.value);
+    if (!strcmp(op, "<")) return sc_const(l.value < r.value);
+    if (!strcmp(op, "<=")) return sc_const(l.value <= r.value);
+    if (!strcmp(op, ">")) return sc_const(l.value > r.value);
+    if (!strcmp(op, ">=")) return sc_const(l.value >= r.value);
+
+    /* знаковость DIV/MOD/SHR не фиксирована - сворачиваем только очевидное */
+    if (!strcmp(op, "/") && l.value >= 0 && r.value > 0) return sc_const(l.value / r.value);
+    if (!strcmp(op, "%") && l.value >= 0 && r.value > 0) return sc_const(l.value % r.value);
+    if (!strcmp(op, "<<") && r.value >= 0 && r.value < 32) return sc_const((int32_t)(a << r.value));
+    if (!strcmp(op, ">>") && l.value >= 0 && r.value >= 0 && r.value < 32) return sc_const(l.value >> r.value);
+
+    return sc_bottom();
+}
+
+/* =========================
+ * Abstract evaluation (порядок вычисления как в codegen)
+ * ========================= */
+
+static SCValue sc_eval(SCCP* s, ASTNode* e, SCValue* env);
+
+static SCValue sc_eval_child(SCCP* s, ASTNode* e, int i, SCValue* env) {
+    SCValue v = sc_eval(s, e->children[i], env);
+    sc_fold(s, e->children[i], v);
+    return v;
+}
+
+static SCValue sc_eval(SCCP* s, ASTNode* e, SCValue* env) {
+    if (!e) return sc_bottom();
+
+    switch (e->type) {
+    case AST_LITERAL:
+    case AST_BOOL_LITERAL:
+    case AST_CHAR_LITERAL:
+        return sc_literal(e);
+
+    case AST_IDENTIFIER:
+        return sc_ident(s, e, env);
+
+    case AST_ASSIGNMENT: {
+        if (e->child_count < 2) return sc_bottom();
+        ASTNode* lhs = e->children[0];
+        SCValue val = sc_eval_child(s, e, 1, env);
+
+        if (lhs && lhs->type == AST_IDENTIFIER) {
+            int v = liveness_var_of_ident(s->lv, lhs);
+            if (v >= 0 && s->tracked[v]) env[v] = val;
+        }
+        else if (lhs) {
+            /* a[i] := ..., *p := ... : индексы и адреса только читаются */
+            for (int i = 0; i < lhs->child_count; i++) sc_eval_child(s, lhs, i, env);
+        }
+        return val;
+    }
+
+    case AST_CALL_EXPR:
+        /* children[0] - имя функции; отслеживаемые переменные вызов изменить не может */
+        for (int i = 1; i < e->child_count; i++) sc_eval_child(s, e, i, env);
+        return sc_bottom();
+
+    case AST_UNARY_EXPR: {
+        if (e->child_count < 1) return sc_bottom();
+        SCValue c = sc_eval_child(s, e, 0, env);
+        if (c.kind != SC_CONST) return c;
+        const char* op = e->value ? e->value : "";
+        if (!strcmp(op, "-")) return sc_const((int32_t)(0u - (uint32_t)c.value));
+        if (!strcmp(op, "~")) return sc_const(~c.value);
+        if (!strcmp(op, "!")) return sc_const(c.value == 0);
+        if (!strcmp(op, "+")) return c;
+        return sc_bottom();
+    }
+
+    case AST_BINARY_EXPR:
+    case AST_ARITHMETIC_EXPR: {
+        if (e->child_count < 2) return sc_bottom();
+        const char* op = e->value ? e->value : "";
+
+        if (!strcmp(op, "&&") || !strcmp(op, "||")) {
+            int is_and = (op[0] == '&');
+            SCValue l = sc_eval_child(s, e, 0, env);
+            if (l.kind == SC_TOP) return l;
+            if (l.kind == SC_CONST) {
+                /* короткое замыкание известно заранее: правая часть не исполняется */
+                if (is_and && l.value == 0) return sc_const(0);
+                if (!is_and && l.value != 0) return sc_const(1);
+                SCValue r = sc_eval_child(s, e, 1, env);
+                return (r.kind == SC_CONST) ? sc_const(r.value != 0) : r;
+            }
+
+            /* правая часть исполняется не всегда: её записи сливаются с исходным env */
+            int n = s->lv->var_count;
+            SCValue* alt = (SCValue*)malloc((size_t)(n > 0 ? n : 1) * sizeof(SCValue));
+            memcpy(alt, env, (size_t)n * sizeof(SCValue));
+            SCValue r = sc_eval_child(s, e, 1, alt);
+            for (int v = 0; v < n; v++) env[v] = sc_meet(env[v], alt[v]);
+            free(alt);
+
+            if (r.kind == SC_CONST && is_and && r.value == 0) return sc_const(0);
+            if (r.kind == SC_CONST && !is_and && r.value != 0) return sc_const(1);
+            return (r.kind == SC_TOP) ? r : sc_bottom();
+        }
+
+        SCValue l = sc_eval_child(s, e, 0, env);
+        SCValue r = sc_eval_child(s, e, 1, env);
+        return sc_binary(op, l, r);
+    }
+
+    default:
+        for (int i = 0; i < e->child_count; i++) sc_eval_child(s, e, i, env);
+        return sc_bottom();
+    }
+}
+
+/* =========================
+ * Per-function pass
+ * ========================= */
+
+static void sccp_function(CFG* cfg, const SymbolTable* st, const CFGFunction* fn, SCCPStats* stats) {
+    Liveness* lv = liveness_compute(cfg, st, fn);
+    if (!lv) return;
+
+    int n = lv->node_count;
+    int nv = lv->var_count;
+    size_t row = (size_t)(nv > 0 ? nv : 1);
+
+    SCCP s;
+    memset(&s, 0, sizeof(s));
+    s.st = st;
+    s.lv = lv;
+    s.tracked = (unsigned char*)calloc(row, 1);
+    for (int v = 0; v < nv; v++) {
+        const Symbol* sym = &st->symbols[lv->vars[v]];
+        s.tracked[v] = !sym->is_array && !sym->is_address_taken && !sym->escapes &&
+            sc_is_int_type(sym->dtype);
+    }
+
+    SCValue* in = (SCValue*)calloc((size_t)n * row, sizeof(SCValue));    /* SC_TOP */
+    SCValue* out = (SCValue*)calloc((size_t)n * row, sizeof(SCValue));
+    SCValue* env = (SCValue*)malloc(row * sizeof(SCValue));
+    unsigned char* visited = (unsigned char*)calloc((size_t)n, 1);
+    unsigned char* exec_edge = (unsigned char*)calloc((size_t)n * 2, 1);  /* [p*2 + k] */
+
+    /* предшественники: ребро (q, k) ведёт в succ[2q + k] */
+    int* pred_start = (int*)calloc((size_t)n + 1, sizeof(int));
+    for (int q = 0; q < n; q++) {
+        for (int k = 0; k < 2; k++) {
+            if (lv->succ[2 * q + k] >= 0) pred_start[lv->succ[2 * q + k] + 1]++;
+        }
+    }
+    for (int p = 0; p < n; p++) pred_start[p + 1] += pred_start[p];
+    int* pred_edge = (int*)malloc((size_t)(pred_start[n] > 0 ? pred_start[n] : 1) * sizeof(int));
+    int* fill = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    memcpy(fill, pred_start, (size_t)n * sizeof(int));
+    for (int q = 0; q < n; q++) {
+        for (int k = 0; k < 2; k++) {
+            int t = lv->succ[2 * q + k];
+            if (t >= 0) pred_edge[fill[t]++] = q * 2 + k;
+        }
+    }
+    free(fill);
+
+    int entry_pos = -1;
+    for (int p = 0; p < n; p++) {
+        if (cfg->nodes[lv->nodes[p]] == fn->entry) entry_pos = p;
+    }
+
+    /* очередь узлов (FIFO по кольцу; узел в очереди не более одного раза) */
+    int* queue = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    unsigned char* queued = (unsigned char*)calloc((size_t)n, 1);
+    int qhead = 0, qlen = 0, iterations = 0;
+    if (entry_pos >= 0) {
+        queue[0] = entry_pos;
+        queued[entry_pos] = 1;
+        qlen = 1;
+    }
+
+    while (qlen > 0) {
+        int p = queue[qhead];
+        qhead = (qhead + 1) % n;
+        qlen--;
+        queued[p] = 0;
+        iterations++;
+
+        SCValue* in_p = in + (size_t)p * row;
+        SCValue* out_p = out + (size_t)p * row;
+        CFGNode* node = cfg->nodes[lv->nodes[p]];
+
+        /* IN = слияние OUT исполнимых входящих рёбер; на входе функции ничего не известно */
+        for (int v = 0; v < nv; v++) in_p[v] = (p == entry_pos) ? sc_bottom() : sc_make(SC_TOP, 0);
+        for (int j = pred_start[p]; j < pred_start[p + 1]; j++) {
+            int edge = pred_edge[j];
+            if (!exec_edge[edge]) continue;
+            const SCValue* out_q = out + (size_t)(edge / 2) * row;
+            for (int v = 0; v < nv; v++) in_p[v] = sc_meet(in_p[v], out_q[v]);
+        }
+
+        /* операторы блока по порядку; у условия значение последнего - исход */
+        memcpy(env, in_p, (size_t)nv * sizeof(SCValue));
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(node, &count);
+        SCValue cond = sc_bottom();
+        for (int i = 0; i < count; i++) cond = sc_eval(&s, exprs[i], env);
+
+        int changed = !visited[p];
+        for (int v = 0; v < nv && !changed; v++) changed = !sc_same(env[v], out_p[v]);
+        memcpy(out_p, env, (size_t)nv * sizeof(SCValue));
+        visited[p] = 1;
+
+        int take[2] = { 1, 1 };
+        if (node->type == CFG_CONDITION) {
+            take[0] = (cond.kind == SC_BOTTOM) || (cond.kind == SC_CONST && cond.value == 0);
+            take[1] = (cond.kind == SC_BOTTOM) || (cond.kind == SC_CONST && cond.value != 0);
+        }
+
+        for (int k = 0; k < 2; k++) {
+            int t = lv->succ[2 * p + k];
+            if (t < 0 || !take[k]) continue;
+            int fresh = !exec_edge[p * 2 + k];
+            exec_edge[p * 2 + k] = 1;
+            if ((fresh || changed) && !queued[t]) {
+                queue[(qhead + qlen) % n] = t;
+                queued[t] = 1;
+                qlen++;
+            }
+        }
+    }
+
+    /* замена: константы -> литералы, известные условия -> безусловный переход */
+    int reachable_before = fn->reachable_count;
+    int folded = 0;
+    /* у каждого узла свои деревья (cfg_builder их не разделяет) - подстановка локальна */
+    s.rewrite = 1;
+    for (int p = 0; p < n; p++) {
+        if (!visited[p]) continue;
+        CFGNode* node = cfg->nodes[lv->nodes[p]];
+        int count = 0;
+        ASTNode** exprs = cfg_node_exprs(node, &count);
+        if (count == 0) continue;
+
+        memcpy(env, in + (size_t)p * row, (size_t)nv * sizeof(SCValue));
+        SCValue v = sc_bottom();
+        for (int i = 0; i < count; i++) {
+            v = sc_eval(&s, exprs[i], env);
+            sc_fold(&s, exprs[i], v);
+        }
+
+        if (node->type == CFG_CONDITION && v.kind == SC_CONST && !sc_has_side_effects(exprs[count - 1])) {
+            CFGNode* taken = v.value ? node->conditionalNext : node->defaultNext;
+            if (taken) {
+                /* условие больше не вычисляется, операторы блока остаются */
+                node->expr_tree_count--;
+                node->type = node->expr_tree_count > 0 ? CFG_BLOCK : CFG_MERGE;
+                cfg_set_edges(cfg, node, taken, NULL);
+                folded++;
+            }
+        }
+    }
+    cfg_finalize(cfg);    /* заново CSR и обходы функций */
+    int unreachable = reachable_before - fn->reachable_count;
+
+    stats->functions++;
+    stats->constants_propagated += s.substituted;
+    stats->branches_folded += folded;
+    stats->nodes_unreachable += unreachable;
+
+    TRACE(TRACE_CFG, TRACE_INFO, "  %s: %d constant(s) propagated, %d branch(es) folded, %d node(s) unreachable (%d iteration(s))\n",
+        lv->name, s.substituted, folded, unreachable, iterations);
+
+    free(queue);
+    free(queued);
+    free(pred_edge);
+    free(pred_start);
+    free(exec_edge);
+    free(visited);
+    free(env);
+    free(out);
+    free(in);
+    free(s.tracked);
+    liveness_free(lv);
+}
+
+SCCPStats sccp_run(CFG* cfg, const SymbolTable* st) {
+    SCCPStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!cfg || !st) return stats;
+
+    printf("[*] Propagating constants...\n");
+
+    for (int f = 0; f < cfg->function_count; f++) {
+        sccp_function(cfg, st, &cfg->functions[f], &stats);
+    }
+
+    return stats;
+}
+
+void sccp_print_stats(const SCCPStats* stats) {
+    if (!stats) return;
+    printf("[+] Constant propagation: %d function(s), %d constant(s) propagated, %d branch(es) folded, %d node(s) unreachable\n",
+        stats->functions, stats->constants_propagated, stats->branches_folded, stats->nodes_unreachable);
+}
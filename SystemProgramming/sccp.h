@@ -0,0 +1,48 @@
+﻿#pragma once
+#ifndef SCCP_H
+#define SCCP_H
+
+#include "cfg.h"
+#include "semantic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Распространение констант по CFG функции (после построения CFG, до DSE).
+     *
+     * Условное распространение констант Вегмана-Задека над CFG без SSA:
+     * решётка TOP / константа / BOTTOM хранится для каждой переменной на входе
+     * каждого узла, а рёбра становятся исполнимыми только когда условие
+     * может по ним пойти. Так константы проходят через слияния и циклы.
+     *
+     * Отслеживаются целочисленные скаляры (int/uint/byte/char/bool) без
+     * взятого адреса, а также глобальные SYM_CONSTANT со значением.
+     * Арифметика - как в codegen.c: 32 бита с переносом, значение литерала
+     * берётся из разбора лексера (литерал вне 32 бит не обрезается молча,
+     * а помечается ошибкой). Подставляются только результаты, которые
+     * codegen загрузит короткой MOVI-последовательностью (|v| <= 65535).
+     *
+     * По результату:
+     *   - чистые подвыражения с известным значением заменяются литералом;
+     *   - у CFG_CONDITION с известным исходом условие убирается, блок
+     *     становится безусловным переходом (CFG_BLOCK, без операторов -
+     *     CFG_MERGE), недостижимая ветка отцепляется от графа.
+     */
+
+    typedef struct {
+        int functions;
+        int constants_propagated;  /* подставлено литералов */
+        int branches_folded;       /* условий стало безусловными */
+        int nodes_unreachable;     /* узлов отцеплено от графа */
+    } SCCPStats;
+
+    SCCPStats sccp_run(CFG* cfg, const SymbolTable* st);
+    void sccp_print_stats(const SCCPStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
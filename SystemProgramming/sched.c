@@ -0,0 +1,357 @@
+﻿#include <stdlib.h>
+#include <string.h>
+#include "sched.h"
+#include "thread.h"
+
+/* =========================
+ * Task graph
+ * ========================= */
+
+typedef struct {
+    TaskFunc func;
+    void* arg;
+    int index;
+
+    int dep_total;              /* число предшественников */
+    volatile int remaining;     /* ещё не выполненных предшественников */
+
+    int* dependents;            /* задачи, ждущие эту */
+    int dependent_count;
+    int dependent_cap;
+} Task;
+
+struct TaskGraph {
+    Task* tasks;
+    int count;
+    int cap;
+};
+
+TaskGraph* task_graph_create(void) {
+    return (TaskGraph*)calloc(1, sizeof(TaskGraph));
+}
+
+void task_graph_free(TaskGraph* g) {
+    if (!g) return;
+    for (int i = 0; i < g->count; i++) free(g->tasks[i].dependents);
+    free(g->tasks);
+    free(g);
+}
+
+int task_graph_add(TaskGraph* g, TaskFunc func, void* arg, int index) {
+    if (!g || !func) return -1;
+    if (g->count >= g->cap) {
+        int nc = g->cap ? g->cap * 2 : 64;
+        Task* nt = (Task*)realloc(g->tasks, (size_t)nc * sizeof(Task));
+        if (!nt) return -1;
+        g->tasks = nt;
+        g->cap = nc;
+    }
+    Task* t = &g->tasks[g->count];
+    memset(t, 0, sizeof(*t));
+    t->func = func;
+    t->arg = arg;
+    t->index = index;
+    return g->count++;
+}
+
+void task_graph_depend(TaskGraph* g, int task, int prerequisite) {
+    if (!g || task < 0 || task >= g->count || prerequisite < 0 || prerequisite >= g->count) return;
+    if (task == prerequisite) return;
+
+    Task* p = &g->tasks[prerequisite];
+    if (p->dependent_count >= p->dependent_cap) {
+        int nc = p->dependent_cap ? p->dependent_cap * 2 : 4;
+        int* nd = (int*)realloc(p->dependents, (size_t)nc * sizeof(int));
+        if (!nd) return;
+        p->dependents = nd;
+        p->dependent_cap = nc;
+    }
+    p->dependents[p->dependent_count++] = task;
+    g->tasks[task].dep_total++;
+}
+
+/* Кан: граф без циклов <=> все задачи достижимы из готовых */
+static int task_graph_is_acyclic(const TaskGraph* g) {
+    int* indeg = (int*)malloc((size_t)g->count * sizeof(int));
+    int* queue = (int*)malloc((size_t)g->count * sizeof(int));
+    if (!indeg || !queue) {
+        free(indeg);
+        free(queue);
+        return 0;
+    }
+
+    int head = 0, tail = 0;
+    for (int i = 0; i < g->count; i++) {
+        indeg[i] = g->tasks[i].dep_total;
+        if (indeg[i] == 0) queue[tail++] = i;
+    }
+    while (head < tail) {
+        const Task* t = &g->tasks[queue[head++]];
+        for (int k = 0; k < t->dependent_count; k++) {
+            if (--indeg[t->dependents[k]] == 0) queue[tail++] = t->dependents[k];
+        }
+    }
+
+    free(indeg);
+    free(queue);
+    return tail == g->count;
+}
+
+/* =========================
+ * Worker deques
+ * ========================= */
+
+typedef struct {
+    Mutex lock;
+    int* items;             /* номера задач в [top, bottom) */
+    int top;
+    int bottom;
+    int cap;
+    unsigned int rng;       /* выбор жертвы для кражи */
+} WorkQueue;
+
+static void queue_push(WorkQueue* q, int id) {
+    mutex_lock(&q->lock);
+    if (q->top > 0 && q->top == q->bottom) {
+        q->top = q->bottom = 0;
+    }
+    if (q->bottom >= q->cap) {
+        int nc = q->cap ? q->cap * 2 : 64;
+        int* ni = (int*)realloc(q->items, (size_t)nc * sizeof(int));
+        if (ni) {
+            q->items = ni;
+            q->cap = nc;
+        }
+    }
+    if (q->bottom < q->cap) q->items[q->bottom++] = id;
+    mutex_unlock(&q->lock);
+}
+
+/* владелец: с хвоста */
+static int queue_pop(WorkQueue* q) {
+    int id = -1;
+    mutex_lock(&q->lock);
+    if (q->bottom > q->top) id = q->items[--q->bottom];
+    mutex_unlock(&q->lock);
+    return id;
+}
+
+/* вор: с головы */
+static int queue_steal(WorkQueue* q) {
+    int id = -1;
+    mutex_lock(&q->lock);
+    if (q->bottom > q->top) id = q->items[q->top++];
+    mutex_unlock(&q->lock);
+    return id;
+}
+
+/* =========================
+ * Scheduler
+ * ========================= */
+
+typedef struct {
+    Scheduler* sched;
+    int id;
+} WorkerArg;
+
+struct Scheduler {
+    int worker_count;
+    int queue_count;
+    WorkQueue* queues;          /* [0] - поток, вызвавший task_graph_run */
+    Thread* threads;            /* рабочие 1..worker_count-1 */
+    WorkerArg* args;
+    int started;
+
+    Mutex lock;
+    CondVar wake;
+    int queued;                 /* задач лежит в очередях */
+    int pending;                /* задач текущего графа не завершено */
+    int shutdown;
+    TaskGraph* graph;
+};
+
+static void sched_push(Scheduler* s, int worker, int id) {
+    queue_push(&s->queues[worker], id);
+    mutex_lock(&s->lock);
+    s->queued++;
+    condvar_signal(&s->wake);
+    mutex_unlock(&s->lock);
+}
+
+static int sched_take(Scheduler* s, int worker) {
+    int id = queue_pop(&s->queues[worker]);
+
+    if (id < 0 && s->worker_count > 1) {
+        WorkQueue* self = &s->queues[worker];
+        self->rng = self->rng * 1103515245u + 12345u;
+        int start = (int)((self->rng >> 16) % (unsigned int)s->worker_count);
+        for (int k = 0; k < s->worker_count && id < 0; k++) {
+            int victim = (start + k) % s->worker_count;
+            if (victim != worker) id = queue_steal(&s->queues[victim]);
+        }
+    }
+
+    if (id >= 0) {
+        mutex_lock(&s->lock);
+        s->queued--;
+        mutex_unlock(&s->lock);
+    }
+    return id;
+}
+
+static void sched_execute(Scheduler* s, int worker, int id) {
+    TaskGraph* g = s->graph;
+    Task* t = &g->tasks[id];
+
+    t->func(t->arg, t->index);
+
+    for (int k = 0; k < t->dependent_count; k++) {
+        int d = t->dependents[k];
+        if (atomic_decrement(&g->tasks[d].remaining) == 0) sched_push(s, worker, d);
+    }
+
+    mutex_lock(&s->lock);
+    if (--s->pending == 0) condvar_broadcast(&s->wake);
+    mutex_unlock(&s->lock);
+}
+
+/* caller: вернуться, когда граф выполнен; иначе - до shutdown */
+static void sched_work(Scheduler* s, int worker, int caller) {
+    for (;;) {
+        int id = sched_take(s, worker);
+        if (id >= 0) {
+            sched_execute(s, worker, id);
+            continue;
+        }
+
+        mutex_lock(&s->lock);
+        while (s->queued == 0 && !s->shutdown && !(caller && s->pending == 0)) {
+            condvar_wait(&s->wake, &s->lock);
+        }
+        int stop = s->shutdown || (caller && s->pending == 0);
+        mutex_unlock(&s->lock);
+        if (stop) return;
+    }
+}
+
+static void sched_thread_main(void* p) {
+    WorkerArg* a = (WorkerArg*)p;
+    sched_work(a->sched, a->id, 0);
+}
+
+Scheduler* scheduler_create(int workers) {
+    if (workers <= 0) workers = thread_cpu_count();
+
+    Scheduler* s = (Scheduler*)calloc(1, sizeof(Scheduler));
+    if (!s) return NULL;
+    s->worker_count = workers;
+    s->queue_count = workers;
+    s->queues = (WorkQueue*)calloc((size_t)workers, sizeof(WorkQueue));
+    s->threads = (Thread*)calloc((size_t)workers, sizeof(Thread));
+    s->args = (WorkerArg*)calloc((size_t)workers, sizeof(WorkerArg));
+    if (!s->queues || !s->threads || !s->args) {
+        free(s->queues);
+        free(s->threads);
+        free(s->args);
+        free(s);
+        return NULL;
+    }
+
+    mutex_init(&s->lock);
+    condvar_init(&s->wake);
+    for (int i = 0; i < workers; i++) {
+        mutex_init(&s->queues[i].lock);
+        s->queues[i].rng = 2166136261u ^ (unsigned int)i;
+    }
+
+    for (int i = 1; i < workers; i++) {
+        s->args[i].sched = s;
+        s->args[i].id = i;
+        if (!thread_start(&s->threads[i], sched_thread_main, &s->args[i])) break;
+        s->started = i;
+    }
+    /* если стартовали не все потоки, их очереди разбирают кражей остальные */
+    return s;
+}
+
+void scheduler_free(Scheduler* s) {
+    if (!s) return;
+
+    mutex_lock(&s->lock);
+    s->shutdown = 1;
+    condvar_broadcast(&s->wake);
+    mutex_unlock(&s->lock);
+
+    for (int i = 1; i <= s->started; i++) thread_join(&s->threads[i]);
+
+    for (int i = 0; i < s->queue_count; i++) {
+        mutex_destroy(&s->queues[i].lock);
+        free(s->queues[i].items);
+    }
+    condvar_destroy(&s->wake);
+    mutex_destroy(&s->lock);
+    free(s->queues);
+    free(s->threads);
+    free(s->args);
+    free(s);
+}
+
+int scheduler_worker_count(const Scheduler* s) {
+    return s ? s->started + 1 : 1;
+}
+
+int task_graph_run(TaskGraph* g, Scheduler* s) {
+    if (!g || g->count == 0) return 1;
+    if (!task_graph_is_acyclic(g)) return 0;
+
+    for (int i = 0; i < g->count; i++) g->tasks[i].remaining = g->tasks[i].dep_total;
+
+    if (!s) {
+        /* последовательно: FIFO готовых задач */
+        int* ready = (int*)malloc((size_t)g->count * sizeof(int));
+        if (!ready) return 0;
+        int head = 0, tail = 0;
+        for (int i = 0; i < g->count; i++) {
+            if (g->tasks[i].dep_total == 0) ready[tail++] = i;
+        }
+        while (head < tail) {
+            Task* t = &g->tasks[ready[head++]];
+            t->func(t->arg, t->index);
+            for (int k = 0; k < t->dependent_count; k++) {
+                if (--g->tasks[t->dependents[k]].remaining == 0) ready[tail++] = t->dependents[k];
+            }
+        }
+        free(ready);
+        return 1;
+    }
+
+    mutex_lock(&s->lock);
+    s->graph = g;
+    s->pending = g->count;
+    mutex_unlock(&s->lock);
+
+    /* готовые задачи - по кругу в очереди рабочих */
+    int next = 0;
+    for (int i = 0; i < g->count; i++) {
+        if (g->tasks[i].dep_total != 0) continue;
+        sched_push(s, next, i);
+        next = (next + 1) % s->worker_count;
+    }
+
+    sched_work(s, 0, 1);
+
+    mutex_lock(&s->lock);
+    s->graph = NULL;
+    mutex_unlock(&s->lock);
+    return 1;
+}
+
+void scheduler_parallel_for(Scheduler* s, int count, TaskFunc body, void* arg) {
+    if (count <= 0 || !body) return;
+
+    TaskGraph* g = task_graph_create();
+    if (!g) return;
+    for (int i = 0; i < count; i++) task_graph_add(g, body, arg, i);
+    task_graph_run(g, s);
+    task_graph_free(g);
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+#ifndef SCHED_H
+#define SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Планировщик задач с перехватом работы (work stealing).
+     *
+     * У каждого рабочего потока своя двусторонняя очередь: свои задачи он
+     * берёт с хвоста (LIFO - горячие данные), а опустевший поток крадёт
+     * с головы очереди случайной жертвы. Так неравные по стоимости задачи
+     * (огромный main рядом с мелкими функциями) расходятся по ядрам сами.
+     * Вызывающий task_graph_run поток работает как рабочий 0.
+     *
+     * Граф задач: task_graph_add создаёт задачу, task_graph_depend(g, t, p)
+     * запрещает запускать t до завершения p (например, сводка вызываемой
+     * функции до оптимизации вызывающей). Задача становится готовой, когда
+     * выполнены все её предшественники. Порядок выполнения не определён -
+     * задачи пишут результаты в свои слоты, а вызывающий собирает их в
+     * фиксированном порядке.
+     *
+     * Один планировщик выполняет один граф за раз; задачи не должны
+     * запускать вложенные графы на том же планировщике.
+     */
+
+    typedef void (*TaskFunc)(void* arg, int index);
+
+    typedef struct Scheduler Scheduler;
+    typedef struct TaskGraph TaskGraph;
+
+    /* workers <= 0 - по числу процессоров */
+    Scheduler* scheduler_create(int workers);
+    void scheduler_free(Scheduler* s);
+    int scheduler_worker_count(const Scheduler* s);
+
+    TaskGraph* task_graph_create(void);
+    void task_graph_free(TaskGraph* g);
+
+    /* Новая задача func(arg, index); возвращает её номер (-1 = error) */
+    int task_graph_add(TaskGraph* g, TaskFunc func, void* arg, int index);
+
+    /* task выполняется только после prerequisite */
+    void task_graph_depend(TaskGraph* g, int task, int prerequisite);
+
+    /* Выполнить все задачи и дождаться их (1 = ok, 0 = цикл в графе).
+       s == NULL - последовательно в вызывающем потоке. */
+    int task_graph_run(TaskGraph* g, Scheduler* s);
+
+    /* body(arg, i) для i = 0..count-1, независимые задачи */
+    void scheduler_parallel_for(Scheduler* s, int count, TaskFunc body, void* arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
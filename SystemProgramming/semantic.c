@@ -1,28 +1,20 @@
 ﻿#include "semantic.h"
+#include "sched.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <limits.h>
 
 /*
- * Size model (bytes):
- *   - Backend is word-oriented, so most scalar types occupy 4 bytes.
- *   - Arrays use element_size * array_size.
- *   - We keep `char` as a 4-byte scalar (ASCII code in low byte), which makes
- *     `array of char` usable for "strings" with current instruction set.
+ * Size model: размеры и выравнивания - в дескрипторах типов (types.c).
+ * Статический массив хранится inline (element_size * array_size),
+ * динамический - ссылкой (адрес, 4 байта).
  */
-static int data_type_size_bytes(const char* t) {
-    if (!t) return 4;
-    if (strcmp(t, "din") == 0) return 8; /* value (4) + runtime tag (4) */
-    /* normalize common names produced by parser */
-    if (strcmp(t, "long") == 0 || strcmp(t, "ulong") == 0) return 8;
-    /* everything else is a word for now */
-    return 4;
-}
-
-/* Размер "ссылки" на динамический массив (в байтах). Сейчас это просто адрес. */
-static int array_ref_size_bytes(void) {
-    return 4;
+static const Type* symbol_type_of(SymbolTable* st, const char* data_type, int is_array, int array_size) {
+    const Type* t = type_by_name(st->types, data_type);
+    return is_array ? type_array(st->types, t, array_size) : t;
 }
 
 /* Вспомогательные функции */
@@ -31,6 +23,8 @@ static void analyze_statement(ASTNode* stmt, SymbolTable* st);
 static Scope* create_function_scope(SymbolTable* st, const char* func_name);
 static void calculate_offsets(SymbolTable* st);
 static void check_unused_symbols(SymbolTable* st);
+static void semantic_printf(SymbolTable* st, int level, const char* format, ...);
+static void report_ast_error(SymbolTable* st, ASTNode* node, const char* format, ...);
 
 
 /* =========================
@@ -154,9 +148,11 @@ SymbolTable* symbol_table_create(void) {
     st->scopes = (Scope**)malloc(st->max_scopes * sizeof(Scope*));
     st->scope_count = 0;
     st->next_scope_id = 1;
+    st->current_scope = NULL;
 
     /* Создание глобальной области видимости */
     Scope* global_scope = scope_create(st, SCOPE_GLOBAL, "global");
+    global_scope->last_id = INT_MAX;  /* глобальная не закрывается */
     scope_enter(st, global_scope);
 
     /* Инициализация счетчиков */
@@ -168,6 +164,22 @@ SymbolTable* symbol_table_create(void) {
     /* Отладка */
     st->debug_enabled = 0;
 
+    /* Анализы, выполняемые после семантики */
+    st->escape_analyzed = 0;
+
+    st->types = type_table_create();
+
+    /* Обычная таблица, не локальный слой функции */
+    st->globals = NULL;
+    st->global_marks = NULL;
+    st->global_mark_count = 0;
+    st->bound = NULL;
+    st->bound_count = 0;
+    st->bound_capacity = 0;
+    st->log = NULL;
+    st->log_size = 0;
+    st->log_capacity = 0;
+
     /* =========================
      * Builtins
      * =========================
@@ -215,11 +227,67 @@ Scope* scope_create(SymbolTable* st, ScopeType type, const char* name) {
     scope->level = st->current_scope ? st->current_scope->level + 1 : 0;
     scope->local_offset = -4;  // Начинаем с -4 для локальных переменных
     scope->param_offset = 8;   // Параметры начинаются с +8
+    scope->last_id = scope->id;
+    scope->symbols = NULL;
+    scope->symbol_count = 0;
+    scope->symbol_capacity = 0;
 
     st->scopes[st->scope_count++] = scope;
     return scope;
 }
 
+Scope* symbol_table_scope(const SymbolTable* st, int id) {
+    if (!st || st->scope_count == 0) return NULL;
+    int i = id - st->scopes[0]->id;
+    if (i < 0 || i >= st->scope_count) return NULL;
+    Scope* scope = st->scopes[i];
+    return scope->id == id ? scope : NULL;
+}
+
+int scope_contains(const Scope* ancestor, const Scope* s) {
+    return ancestor && s && s->id >= ancestor->id && s->id <= ancestor->last_id;
+}
+
+static int cmp_symbol_index(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int* symbol_table_scope_symbols(const SymbolTable* st, const Scope* scope, int* count) {
+    *count = 0;
+    if (!st || !scope) return NULL;
+
+    /* потомки - области с номерами (scope->id, last_id], лежат в scopes подряд */
+    int first = scope->id - st->scopes[0]->id;
+    int last = (scope->last_id == INT_MAX) ? st->scope_count - 1 : scope->last_id - st->scopes[0]->id;
+    if (first < 0 || first >= st->scope_count) return NULL;
+    if (last >= st->scope_count) last = st->scope_count - 1;
+
+    int n = 0;
+    for (int i = first; i <= last; i++) n += st->scopes[i]->symbol_count;
+    int* out = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    if (!out) return NULL;
+    for (int i = first; i <= last; i++) {
+        const Scope* s = st->scopes[i];
+        for (int k = 0; k < s->symbol_count; k++) out[(*count)++] = s->symbols[k];
+    }
+    /* символы вложенных областей перемежаются с символами внешней */
+    if (first < last) qsort(out, (size_t)*count, sizeof(int), cmp_symbol_index);
+    return out;
+}
+
+/* Запомнить символ index в списке его области */
+static void scope_add_symbol(Scope* scope, int index) {
+    if (scope->symbol_count >= scope->symbol_capacity) {
+        int cap = scope->symbol_capacity ? scope->symbol_capacity * 2 : 4;
+        int* p = (int*)realloc(scope->symbols, (size_t)cap * sizeof(int));
+        if (!p) return;
+        scope->symbols = p;
+        scope->symbol_capacity = cap;
+    }
+    scope->symbols[scope->symbol_count++] = index;
+}
+
 /* Вход в область видимости */
 void scope_enter(SymbolTable* st, Scope* scope) {
     st->current_scope = scope;
@@ -228,6 +296,8 @@ void scope_enter(SymbolTable* st, Scope* scope) {
 /* Выход из области видимости */
 void scope_exit(SymbolTable* st) {
     if (st->current_scope && st->current_scope->parent) {
+        /* все потомки уже созданы */
+        st->current_scope->last_id = st->next_scope_id - 1;
         st->current_scope = st->current_scope->parent;
     }
 }
@@ -248,12 +318,9 @@ void symbol_table_add_global(SymbolTable* st, const char* name, const char* data
     if (!st || !name) return;
 
     /* Проверяем, не объявлен ли символ уже */
-    for (int i = 0; i < st->symbol_count; i++) {
-        if (strcmp(st->symbols[i].name, name) == 0 &&
-            st->symbols[i].scope->type == SCOPE_GLOBAL) {
-            symbol_table_add_error(st, "Redeclaration of global variable");
-            return;
-        }
+    if (symbol_table_lookup_global(st, name)) {
+        symbol_table_add_error(st, "Redeclaration of global variable");
+        return;
     }
 
     /* Увеличиваем размер массива при необходимости */
@@ -281,18 +348,8 @@ void symbol_table_add_global(SymbolTable* st, const char* name, const char* data
     sym->array_dimensions = is_array ? 1 : 0;
 
     /* Размер и расположение */
-    int base_size = data_type_size_bytes(data_type);
-    sym->size = base_size;
-    if (is_array) {
-        if (array_size > 0) {
-            /* статический массив хранится inline */
-            sym->size = base_size * array_size;
-        }
-        else {
-            /* динамический массив хранит только адрес (ссылку) */
-            sym->size = array_ref_size_bytes();
-        }
-    }
+    sym->dtype = symbol_type_of(st, data_type, is_array, array_size);
+    sym->size = sym->dtype->size;
 
     sym->offset = st->global_offset;
     sym->address = st->global_offset;  // Для глобальных offset = address
@@ -304,6 +361,9 @@ void symbol_table_add_global(SymbolTable* st, const char* name, const char* data
     sym->is_constant = 0;
     sym->is_used = 0;
     sym->is_modified = 0;
+    sym->is_address_taken = 0;
+    sym->escapes = 0;
+    sym->const_value = NULL;
     sym->line_number = 0;
 
     /* Для функций (не используется для глобальных переменных) */
@@ -311,18 +371,19 @@ void symbol_table_add_global(SymbolTable* st, const char* name, const char* data
     sym->param_types = NULL;
     sym->return_type = NULL;
 
+    scope_add_symbol(sym->scope, st->symbol_count);
     st->symbol_count++;
 
     if (st->debug_enabled) {
-        printf("[DEBUG] Added global: %s, offset: %d, size: %d\n",
+        trace_printf(TRACE_SEMANTIC, TRACE_DEBUG, "[DEBUG] Added global: %s, offset: %d, size: %d\n",
             name, sym->offset, sym->size);
     }
 }
 
 /* Добавление локальной переменной */
-void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_type,
+int symbol_table_add_local(SymbolTable* st, const char* name, const char* data_type,
     int is_array, int array_size) {
-    if (!st || !name) return;
+    if (!st || !name) return -1;
 
     /* Проверяем, не объявлен ли символ уже в текущей области */
     Symbol* existing = symbol_table_lookup_current_scope(st, name);
@@ -331,7 +392,7 @@ void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_
         snprintf(error_msg, sizeof(error_msg),
             "Redeclaration of local variable '%s'", name);
         symbol_table_add_error(st, error_msg);
-        return;
+        return -1;
     }
 
     /* Увеличиваем размер массива при необходимости */
@@ -359,18 +420,8 @@ void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_
     sym->array_dimensions = is_array ? 1 : 0;
 
     /* Размер и расположение */
-    int base_size = data_type_size_bytes(data_type);
-    sym->size = base_size;
-    if (is_array) {
-        if (array_size > 0) {
-            /* статический массив хранится inline */
-            sym->size = base_size * array_size;
-        }
-        else {
-            /* динамический массив хранит только адрес (ссылку) */
-            sym->size = array_ref_size_bytes();
-        }
-    }
+    sym->dtype = symbol_type_of(st, data_type, is_array, array_size);
+    sym->size = sym->dtype->size;
 
     /* Оффсет для локальных переменных отрицательный */
     sym->offset = st->current_scope->local_offset;
@@ -383,6 +434,9 @@ void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_
     sym->is_constant = 0;
     sym->is_used = 0;
     sym->is_modified = 0;
+    sym->is_address_taken = 0;
+    sym->escapes = 0;
+    sym->const_value = NULL;
     sym->line_number = 0;
 
     /* Для функций (не используется для локальных переменных) */
@@ -390,12 +444,14 @@ void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_
     sym->param_types = NULL;
     sym->return_type = NULL;
 
+    scope_add_symbol(sym->scope, st->symbol_count);
     st->symbol_count++;
 
     if (st->debug_enabled) {
-        printf("[DEBUG] Added local: %s, offset: %d, size: %d, scope: %d\n",
+        semantic_printf(st, TRACE_DEBUG, "[DEBUG] Added local: %s, offset: %d, size: %d, scope: %d\n",
             name, sym->offset, sym->size, sym->scope_id);
     }
+    return st->symbol_count - 1;
 }
 
 /* Добавление параметра функции */
@@ -438,7 +494,8 @@ void symbol_table_add_parameter(SymbolTable* st, const char* name, const char* d
     sym->array_dimensions = 0;
 
     /* Размер и расположение */
-    sym->size = data_type_size_bytes(data_type);
+    sym->dtype = type_by_name(st->types, data_type);
+    sym->size = sym->dtype->size;
 
     /* Оффсет для параметров положительный */
     sym->offset = st->current_scope->param_offset;
@@ -451,6 +508,9 @@ void symbol_table_add_parameter(SymbolTable* st, const char* name, const char* d
     sym->is_constant = 0;
     sym->is_used = 0;
     sym->is_modified = 0;
+    sym->is_address_taken = 0;
+    sym->escapes = 0;
+    sym->const_value = NULL;
     sym->line_number = 0;
 
     /* Для функций (не используется для параметров) */
@@ -458,10 +518,11 @@ void symbol_table_add_parameter(SymbolTable* st, const char* name, const char* d
     sym->param_types = NULL;
     sym->return_type = NULL;
 
+    scope_add_symbol(sym->scope, st->symbol_count);
     st->symbol_count++;
 
     if (st->debug_enabled) {
-        printf("[DEBUG] Added parameter: %s, offset: %d, size: %d\n",
+        semantic_printf(st, TRACE_DEBUG, "[DEBUG] Added parameter: %s, offset: %d, size: %d\n",
             name, sym->offset, sym->size);
     }
 }
@@ -471,10 +532,11 @@ void symbol_table_add_function(SymbolTable* st, const char* name, const char* re
     int param_count, char** param_types) {
     if (!st || !name) return;
 
-    /* Проверяем, не объявлена ли функция уже */
-    for (int i = 0; i < st->symbol_count; i++) {
-        if (st->symbols[i].type == SYM_FUNCTION &&
-            strcmp(st->symbols[i].name, name) == 0) {
+    /* Проверяем, не объявлена ли функция уже (функции - только в глобальной области) */
+    const Scope* global_scope = st->scopes[0];
+    for (int k = 0; k < global_scope->symbol_count; k++) {
+        const Symbol* other = &st->symbols[global_scope->symbols[k]];
+        if (other->type == SYM_FUNCTION && strcmp(other->name, name) == 0) {
             symbol_table_add_error(st, "Redeclaration of function");
             return;
         }
@@ -514,28 +576,40 @@ void symbol_table_add_function(SymbolTable* st, const char* name, const char* re
     sym->return_type = return_type ? strdup(return_type) : strdup("void");
 
     /* Копируем типы параметров */
+    const Type* params[64];
+    const Type** param_descs = (param_count <= 64) ? params : (const Type**)malloc(param_count * sizeof(Type*));
     if (param_count > 0 && param_types) {
         sym->param_types = (char**)malloc(param_count * sizeof(char*));
         for (int i = 0; i < param_count; i++) {
             sym->param_types[i] = param_types[i] ? strdup(param_types[i]) : strdup("unknown");
+            if (param_descs) param_descs[i] = type_by_name(st->types, sym->param_types[i]);
         }
     }
     else {
         sym->param_types = NULL;
     }
 
+    /* Сигнатура: function(params): return_type */
+    sym->dtype = type_function(st->types, type_by_name(st->types, sym->return_type),
+        sym->param_types && param_descs ? param_count : 0, param_descs);
+    if (param_descs != params) free(param_descs);
+
     /* Флаги */
     sym->is_declared = 1;
     sym->is_initialized = 1;  // Функции считаются инициализированными
     sym->is_constant = 1;     // Функции являются константами
     sym->is_used = 0;
     sym->is_modified = 0;
+    sym->is_address_taken = 0;
+    sym->escapes = 0;
+    sym->const_value = NULL;
     sym->line_number = 0;
 
+    scope_add_symbol(sym->scope, st->symbol_count);
     st->symbol_count++;
 
     if (st->debug_enabled) {
-        printf("[DEBUG] Added function: %s, params: %d, return: %s\n",
+        trace_printf(TRACE_SEMANTIC, TRACE_DEBUG, "[DEBUG] Added function: %s, params: %d, return: %s\n",
             name, param_count, return_type ? return_type : "void");
     }
 }
@@ -570,14 +644,13 @@ void symbol_table_add_constant(SymbolTable* st, const char* name, const char* da
     sym->array_dimensions = 0;
 
     /* Размер и расположение */
-    sym->size = data_type_size_bytes(data_type);
+    sym->dtype = type_by_name(st->types, data_type);
+    sym->size = sym->dtype->size;
     sym->offset = 0;
     sym->address = 0;
 
-    /* Для констант сохраняем значение в data_type или в отдельном поле */
-    if (value) {
-        /* Можно сохранить значение, но для простоты не делаем */
-    }
+    /* Значение константы (текст литерала) - по нему SCCP подставляет её вместо LDC */
+    sym->const_value = value ? strdup(value) : NULL;
 
     /* Флаги */
     sym->is_declared = 1;
@@ -585,6 +658,8 @@ void symbol_table_add_constant(SymbolTable* st, const char* name, const char* da
     sym->is_constant = 1;
     sym->is_used = 0;
     sym->is_modified = 0;
+    sym->is_address_taken = 0;
+    sym->escapes = 0;
     sym->line_number = 0;
 
     /* Для функций */
@@ -592,26 +667,29 @@ void symbol_table_add_constant(SymbolTable* st, const char* name, const char* da
     sym->param_types = NULL;
     sym->return_type = NULL;
 
+    scope_add_symbol(sym->scope, st->symbol_count);
     st->symbol_count++;
 }
 
+/* Символ name, объявленный прямо в области scope. У локальной таблицы
+ * функции символы глобальной области лежат в замороженном слое globals */
+static Symbol* scope_find_symbol(const SymbolTable* st, const Scope* scope, const char* name) {
+    const SymbolTable* owner = (st->globals && scope->type == SCOPE_GLOBAL) ? st->globals : st;
+
+    for (int k = 0; k < scope->symbol_count; k++) {
+        Symbol* sym = &owner->symbols[scope->symbols[k]];
+        if (strcmp(sym->name, name) == 0) return sym;
+    }
+    return NULL;
+}
+
 /* Поиск символа в текущей и родительских областях */
 Symbol* symbol_table_lookup(SymbolTable* st, const char* name) {
     if (!st || !name) return NULL;
 
-    Scope* current = st->current_scope;
-
-    while (current) {
-        /* Ищем символ в текущей области */
-        for (int i = 0; i < st->symbol_count; i++) {
-            if (strcmp(st->symbols[i].name, name) == 0 &&
-                st->symbols[i].scope_id == current->id) {
-                return &st->symbols[i];
-            }
-        }
-
-        /* Переходим к родительской области */
-        current = current->parent;
+    for (Scope* current = st->current_scope; current; current = current->parent) {
+        Symbol* sym = scope_find_symbol(st, current, name);
+        if (sym) return sym;
     }
 
     return NULL;
@@ -620,29 +698,127 @@ Symbol* symbol_table_lookup(SymbolTable* st, const char* name) {
 /* Поиск символа только в текущей области */
 Symbol* symbol_table_lookup_current_scope(SymbolTable* st, const char* name) {
     if (!st || !name || !st->current_scope) return NULL;
+    return scope_find_symbol(st, st->current_scope, name);
+}
 
-    for (int i = 0; i < st->symbol_count; i++) {
-        if (strcmp(st->symbols[i].name, name) == 0 &&
-            st->symbols[i].scope_id == st->current_scope->id) {
-            return &st->symbols[i];
+/* Поиск глобального символа */
+Symbol* symbol_table_lookup_global(SymbolTable* st, const char* name) {
+    if (!st || !name) return NULL;
+    if (st->globals) return symbol_table_lookup_global((SymbolTable*)st->globals, name);
+    if (st->scope_count == 0) return NULL;
+
+    return scope_find_symbol(st, st->scopes[0], name);
+}
+
+/* Поиск символа по цепочке областей, начиная с области scope_id
+ * (не зависит от st->current_scope - для проходов после semantic_analyze) */
+Symbol* symbol_table_lookup_in_scope(const SymbolTable* st, const char* name, int scope_id) {
+    if (!st || !name) return NULL;
+
+    for (Scope* current = symbol_table_scope(st, scope_id); current; current = current->parent) {
+        Symbol* sym = scope_find_symbol(st, current, name);
+        if (sym) return sym;
+    }
+
+    return NULL;
+}
+
+Symbol* symbol_table_resolve(const SymbolTable* st, const ASTNode* node, int scope_id) {
+    if (!st || !node) return NULL;
+    if (node->symbol >= 0 && node->symbol < st->symbol_count) {
+        return &st->symbols[node->symbol];
+    }
+    if (!node->value) return NULL;
+
+    Symbol* sym = symbol_table_lookup_in_scope(st, node->value, scope_id);
+    if (!sym) sym = symbol_table_lookup_global((SymbolTable*)st, node->value);
+    return sym;
+}
+
+/* Связать узел с найденным символом (индекс устойчив к realloc symbols).
+ * Глобальный слой при слиянии не сдвигается; индексы локальных символов
+ * локальной таблицы сдвигаются, поэтому такие узлы запоминаются */
+static void bind_symbol(ASTNode* node, SymbolTable* st, const Symbol* sym) {
+    if (st->globals && sym->scope->type == SCOPE_GLOBAL) {
+        node->symbol = (int)(sym - st->globals->symbols);
+        return;
+    }
+
+    node->symbol = (int)(sym - st->symbols);
+    if (!st->globals) return;
+
+    if (st->bound_count >= st->bound_capacity) {
+        int cap = st->bound_capacity ? st->bound_capacity * 2 : 32;
+        ASTNode** p = (ASTNode**)realloc(st->bound, (size_t)cap * sizeof(ASTNode*));
+        if (!p) return;
+        st->bound = p;
+        st->bound_capacity = cap;
+    }
+    st->bound[st->bound_count++] = node;
+}
+
+/* Отметки использования символа при анализе выражений */
+#define MARK_USED        0x01
+#define MARK_MODIFIED    0x02
+#define MARK_INITIALIZED 0x04
+
+static void apply_symbol_marks(Symbol* sym, int marks) {
+    if (marks & MARK_USED) symbol_set_used(sym);
+    if (marks & MARK_MODIFIED) symbol_set_modified(sym);
+    if (marks & MARK_INITIALIZED) symbol_set_initialized(sym);
+}
+
+/* Глобальный слой читают все задачи, поэтому его символы не меняются
+ * до слияния: отметки копятся в global_marks локальной таблицы */
+static void mark_symbol(SymbolTable* st, Symbol* sym, int marks) {
+    if (st->globals && sym->scope->type == SCOPE_GLOBAL) {
+        if (!st->global_marks) {
+            st->global_marks = (unsigned char*)calloc((size_t)st->globals->symbol_count, 1);
+            if (!st->global_marks) return;
+            st->global_mark_count = st->globals->symbol_count;
         }
+        st->global_marks[sym - st->globals->symbols] |= (unsigned char)marks;
+        return;
     }
+    apply_symbol_marks(sym, marks);
+}
+
+/* Область видимости функции по имени (первая найденная, как в cfg_builder.c) */
+Scope* symbol_table_find_function_scope(const SymbolTable* st, const char* func_name) {
+    if (!st || !func_name) return NULL;
 
+    for (int i = 0; i < st->scope_count; i++) {
+        Scope* scope = st->scopes[i];
+        if (scope->type == SCOPE_FUNCTION && scope->name &&
+            strcmp(scope->name, func_name) == 0) {
+            return scope;
+        }
+    }
     return NULL;
 }
 
-/* Поиск глобального символа */
-Symbol* symbol_table_lookup_global(SymbolTable* st, const char* name) {
-    if (!st || !name) return NULL;
+/* Переменная, через которую функция возвращает значение:
+ * неявная 'result', иначе переменная с именем функции. NULL для void. */
+Symbol* symbol_table_return_symbol(const SymbolTable* st, const char* func_name, int func_scope_id) {
+    if (!st || !func_name) return NULL;
 
+    Symbol* func_sym = NULL;
     for (int i = 0; i < st->symbol_count; i++) {
-        if (strcmp(st->symbols[i].name, name) == 0 &&
-            st->symbols[i].scope->type == SCOPE_GLOBAL) {
-            return &st->symbols[i];
+        if (st->symbols[i].type == SYM_FUNCTION &&
+            strcmp(st->symbols[i].name, func_name) == 0) {
+            func_sym = &st->symbols[i];
+            break;
         }
     }
+    if (!func_sym || !func_sym->dtype || func_sym->dtype->kind != TYPE_FUNCTION ||
+        func_sym->dtype->ret->kind == TYPE_VOID) {
+        return NULL;
+    }
 
-    return NULL;
+    Symbol* ret = symbol_table_lookup_in_scope(st, "result", func_scope_id);
+    if (!ret) ret = symbol_table_lookup_in_scope(st, func_name, func_scope_id);
+    if (ret && ret->type == SYM_FUNCTION) return NULL;
+    return ret;
 }
 
 /* Проверка, объявлен ли символ */
@@ -695,12 +871,7 @@ const char* symbol_get_type_str(SymbolType type) {
 }
 
 /* Отметить ошибку в AST */
-void mark_ast_error(ASTNode* node, const char* format, ...) {
-    if (!node) return;
-
-    va_list args;
-    va_start(args, format);
-
+static void mark_ast_error_v(SymbolTable* st, ASTNode* node, const char* format, va_list args) {
     char buffer[1024];
     vsnprintf(buffer, sizeof(buffer), format, args);
 
@@ -710,9 +881,26 @@ void mark_ast_error(ASTNode* node, const char* format, ...) {
     }
     node->error_message = strdup(buffer);
 
+    semantic_printf(st, TRACE_ERROR, "    [SEMANTIC ERROR] %s\n", buffer);
+}
+
+void mark_ast_error(ASTNode* node, const char* format, ...) {
+    if (!node) return;
+
+    va_list args;
+    va_start(args, format);
+    mark_ast_error_v(NULL, node, format, args);
     va_end(args);
+}
+
+/* mark_ast_error внутри анализа: сообщение идёт в вывод таблицы st */
+static void report_ast_error(SymbolTable* st, ASTNode* node, const char* format, ...) {
+    if (!node) return;
 
-    printf("    [SEMANTIC ERROR] %s\n", buffer);
+    va_list args;
+    va_start(args, format);
+    mark_ast_error_v(st, node, format, args);
+    va_end(args);
 }
 
 static const char* get_return_type_from_signature(ASTNode* sig) {
@@ -736,11 +924,12 @@ void check_expression(ASTNode* expr, SymbolTable* st, int line_num) {
     case AST_IDENTIFIER: {
         Symbol* sym = symbol_table_lookup(st, expr->value);
         if (!sym) {
-            mark_ast_error(expr, "Undeclared identifier '%s'", expr->value);
+            report_ast_error(st, expr, "Undeclared identifier '%s'", expr->value);
         }
         else {
             /* Отмечаем символ как используемый */
-            symbol_set_used(sym);
+            bind_symbol(expr, st, sym);
+            mark_symbol(st, sym, MARK_USED);
         }
         break;
     }
@@ -757,14 +946,17 @@ void check_expression(ASTNode* expr, SymbolTable* st, int line_num) {
             if (left->type == AST_IDENTIFIER) {
                 Symbol* sym = symbol_table_lookup(st, left->value);
                 if (sym) {
+                    bind_symbol(left, st, sym);
                     if (sym->is_constant) {
-                        mark_ast_error(expr, "Cannot assign to constant '%s'", left->value);
+                        report_ast_error(st, expr, "Cannot assign to constant '%s'", left->value);
                     }
                     else {
-                        symbol_set_modified(sym);
-                        symbol_set_initialized(sym);  // ОТМЕТИТЬ КАК ИНИЦИАЛИЗИРОВАННУЮ
+                        mark_symbol(st, sym, MARK_MODIFIED | MARK_INITIALIZED);
                     }
                 }
+                else {
+                    report_ast_error(st, left, "Undeclared identifier '%s'", left->value);
+                }
             }
             else {
                 check_expression(left, st, line_num);
@@ -776,10 +968,11 @@ void check_expression(ASTNode* expr, SymbolTable* st, int line_num) {
     case AST_CALL_EXPR: {
         Symbol* func_sym = symbol_table_lookup(st, expr->value);
         if (!func_sym || func_sym->type != SYM_FUNCTION) {
-            mark_ast_error(expr, "Undeclared function '%s'", expr->value);
+            report_ast_error(st, expr, "Undeclared function '%s'", expr->value);
         }
         else {
-            symbol_set_used(func_sym);
+            bind_symbol(expr, st, func_sym);
+            mark_symbol(st, func_sym, MARK_USED);
         }
 
         /* Проверяем аргументы */
@@ -837,9 +1030,9 @@ static void extract_type_info(ASTNode* type_node, const char** base_type, int* i
              *   - AST_LITERAL (array[10] of T) -> статический размер
              *   - AST_IDENTIFIER (array[x] of T) -> динамический размер, array_size=0
              */
-            if (sz && sz->value && sz->type == AST_LITERAL) {
-                int n = atoi(sz->value);
-                if (n > 0) *array_size = n;
+            if (sz && sz->type == AST_LITERAL && sz->literal.kind == LIT_INT) {
+                int64_t n = sz->literal.value;
+                if (n > 0 && n <= INT_MAX) *array_size = (int)n;
             }
             if (elem && elem->value) {
                 *base_type = elem->value;
@@ -856,7 +1049,7 @@ static void add_variables_from_list(ASTNode* id_list, SymbolTable* st, const cha
     if (!id_list || !st) return;
 
     if (st->debug_enabled) {
-        printf("[DEBUG] add_variables_from_list: node type=%d (%s), value=%s\n",
+        semantic_printf(st, TRACE_DEBUG, "[DEBUG] add_variables_from_list: node type=%d (%s), value=%s\n",
             id_list->type, getNodeTypeName(id_list->type),
             id_list->value ? id_list->value : "NULL");
     }
@@ -903,6 +1096,7 @@ static void analyze_statement(ASTNode* stmt, SymbolTable* st) {
                 if (!child) continue;
                 if (child->type == AST_TYPE_REF) {
                     extract_type_info(child, &base_type, &is_array, &array_size);
+                    ast_set_data_type(child, symbol_type_of(st, base_type, is_array, array_size));
                     break;
                 }
                 if (child->type == AST_IDENTIFIER && child->value) {
@@ -998,100 +1192,353 @@ static void analyze_statement(ASTNode* stmt, SymbolTable* st) {
 
 
 
-void semantic_analyze(ASTNode* ast, SymbolTable* st) {
-    if (!ast || !st || ast->type != AST_PROGRAM) return;
+/* Первый проход для одной функции: сигнатура -> символ в глобальной области */
+void semantic_declare_function(ASTNode* func_def, SymbolTable* st) {
+    if (!func_def || !st || func_def->type != AST_FUNCTION_DEF) return;
 
-    printf("[*] Starting semantic analysis...\n");
-    st->debug_enabled = 1;
+    char func_name[256] = "unknown";
+    char* return_type = "void";
 
-    /* Первый проход: добавление функций */
-    for (int i = 0; i < ast->child_count; i++) {
-        ASTNode* func_def = ast->children[i];
-        if (func_def->type != AST_FUNCTION_DEF) continue;
-
-        char func_name[256] = "unknown";
-        char* return_type = "void";
-
-        if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
-            ASTNode* sig = func_def->children[0];
-            if (sig->value) {
-                snprintf(func_name, sizeof(func_name), "%s", sig->value);
-            }
+    if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
+        ASTNode* sig = func_def->children[0];
+        if (sig->value) {
+            snprintf(func_name, sizeof(func_name), "%s", sig->value);
+        }
 
-            /* Определяем тип возвращаемого значения */
-            if (sig->child_count > 1) {
-                ASTNode* type_node = sig->children[1];
-                if (type_node && type_node->type == AST_TYPE_REF) {
-                    return_type = type_node->value ? type_node->value : "void";
-                }
+        /* Определяем тип возвращаемого значения */
+        if (sig->child_count > 1) {
+            ASTNode* type_node = sig->children[1];
+            if (type_node && type_node->type == AST_TYPE_REF) {
+                return_type = type_node->value ? type_node->value : "void";
             }
         }
+    }
 
-        /* Собираем параметры из сигнатуры (один или несколько) */
-        int param_count = 0;
-        char** param_types = NULL;
-        if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
-            ASTNode* sig = func_def->children[0];
-            if (sig->child_count > 0) {
-                ASTNode* params_node = sig->children[0];
-                collect_params(params_node, st, 0, &param_count, &param_types);
-            }
+    /* Собираем параметры из сигнатуры (один или несколько) */
+    int param_count = 0;
+    char** param_types = NULL;
+    if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
+        ASTNode* sig = func_def->children[0];
+        if (sig->child_count > 0) {
+            ASTNode* params_node = sig->children[0];
+            collect_params(params_node, st, 0, &param_count, &param_types);
         }
+    }
 
-        symbol_table_add_function(st, func_name, return_type, param_count, param_types);
+    symbol_table_add_function(st, func_name, return_type, param_count, param_types);
 
-        /* Освобождаем временный список типов */
-        if (param_types) {
-            for (int k = 0; k < param_count; k++) free(param_types[k]);
-            free(param_types);
-        }
+    /* Освобождаем временный список типов */
+    if (param_types) {
+        for (int k = 0; k < param_count; k++) free(param_types[k]);
+        free(param_types);
     }
+}
 
-    /* Второй проход: анализ каждой функции */
-    for (int i = 0; i < ast->child_count; i++) {
-        ASTNode* func_def = ast->children[i];
-        if (func_def->type != AST_FUNCTION_DEF) continue;
+/* Второй проход для одной функции: область видимости, параметры, тело */
+void semantic_analyze_function(ASTNode* func_def, SymbolTable* st) {
+    if (!func_def || !st || func_def->type != AST_FUNCTION_DEF) return;
 
-        char func_name[256] = "unknown";
-        if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
-            if (func_def->children[0]->value) {
-                snprintf(func_name, sizeof(func_name), "%s", func_def->children[0]->value);
-            }
+    char func_name[256] = "unknown";
+    if (func_def->child_count > 0 && func_def->children[0]->type == AST_FUNCTION_SIGNATURE) {
+        if (func_def->children[0]->value) {
+            snprintf(func_name, sizeof(func_name), "%s", func_def->children[0]->value);
         }
+    }
 
-        /* Создаем область видимости функции */
-        Scope* func_scope = scope_create(st, SCOPE_FUNCTION, func_name);
-        scope_enter(st, func_scope);
+    /* Создаем область видимости функции */
+    Scope* func_scope = scope_create(st, SCOPE_FUNCTION, func_name);
+    scope_enter(st, func_scope);
 
-        /* Добавляем параметры функции */
-        if (func_def->child_count > 0) {
-            ASTNode* sig = func_def->children[0];
-            if (sig && sig->type == AST_FUNCTION_SIGNATURE && sig->child_count > 0) {
-                /* Поддерживаем обе формы AST: список и "цепочку" ArgDef */
-                collect_params(sig->children[0], st, 1, NULL, NULL);
-            }
+    /* Добавляем параметры функции */
+    if (func_def->child_count > 0) {
+        ASTNode* sig = func_def->children[0];
+        if (sig && sig->type == AST_FUNCTION_SIGNATURE && sig->child_count > 0) {
+            /* Поддерживаем обе формы AST: список и "цепочку" ArgDef */
+            collect_params(sig->children[0], st, 1, NULL, NULL);
         }
+    }
 
-        /* Анализируем тело функции - НЕ создаем дополнительную область для блока */
-        if (func_def->child_count > 1) {
-            ASTNode* body = func_def->children[1];
-            if (body) {
-                /* Анализируем содержимое тела функции в текущей области функции */
-                for (int j = 0; j < body->child_count; j++) {
-                    analyze_statement(body->children[j], st);
-                }
+    /* Анализируем тело функции - НЕ создаем дополнительную область для блока */
+    if (func_def->child_count > 1) {
+        ASTNode* body = func_def->children[1];
+        if (body) {
+            /* Анализируем содержимое тела функции в текущей области функции */
+            for (int j = 0; j < body->child_count; j++) {
+                analyze_statement(body->children[j], st);
             }
         }
-
-        /* Выходим из области видимости функции */
-        scope_exit(st);
     }
 
+    /* Выходим из области видимости функции */
+    scope_exit(st);
+}
+
+void semantic_finish(SymbolTable* st) {
+    if (!st) return;
+
     /* Вычисляем оффсеты */
     calculate_offsets(st);
 
     /* Проверяем неиспользуемые символы */
     check_unused_symbols(st);
+}
+
+void semantic_analyze(ASTNode* ast, SymbolTable* st) {
+    semantic_analyze_parallel(ast, st, NULL);
+}
+
+/* =========================
+ * Параллельный второй проход
+ *
+ * После первого прохода глобальная область (встроенные функции и
+ * сигнатуры) больше не меняется - это замороженный слой. Тело каждой
+ * функции анализируется в свою локальную таблицу: её символы и области,
+ * стек областей (current_scope), ошибки и вывод принадлежат задаче.
+ * Затем таблицы сливаются в st в порядке функций.
+ *
+ * Номера областей должны совпасть с последовательным анализом (их видно
+ * в выводе и в CFG), поэтому области функции заранее подсчитываются и
+ * каждая задача нумерует свои с известного начала.
+ * ========================= */
+
+/* Вывод анализа: у локальной таблицы - в её буфер записями
+ * (уровень, текст, '\0'), иначе сразу в трассу */
+static void semantic_printf(SymbolTable* st, int level, const char* format, ...) {
+    if (!TRACE_ON(TRACE_SEMANTIC, level)) return;
+
+    va_list args;
+    va_start(args, format);
+
+    if (!st || !st->globals) {
+        trace_vprintf(TRACE_SEMANTIC, level, format, args);
+        va_end(args);
+        return;
+    }
+
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    if (len > 0) {
+        size_t need = st->log_size + (size_t)len + 2;
+        if (need > st->log_capacity) {
+            size_t cap = st->log_capacity ? st->log_capacity : 1024;
+            while (cap < need) cap *= 2;
+            char* p = (char*)realloc(st->log, cap);
+            if (!p) {
+                va_end(args);
+                return;
+            }
+            st->log = p;
+            st->log_capacity = cap;
+        }
+        st->log[st->log_size] = (char)level;
+        vsnprintf(st->log + st->log_size + 1, (size_t)len + 1, format, args);
+        st->log_size += (size_t)len + 2;
+    }
+    va_end(args);
+}
+
+/* Сколько областей создаст analyze_statement для stmt
+ * (in_function: stmt анализируется прямо в области функции) */
+static int count_statement_scopes(const ASTNode* stmt, int in_function) {
+    if (!stmt) return 0;
+
+    int n = 0;
+    switch (stmt->type) {
+    case AST_IF_STATEMENT:
+        n = 1;
+        for (int i = 1; i < stmt->child_count; i++) n += count_statement_scopes(stmt->children[i], 0);
+        break;
+
+    case AST_WHILE_STATEMENT:
+        if (stmt->child_count > 1) n = 1 + count_statement_scopes(stmt->children[1], 0);
+        break;
+
+    case AST_REPEAT_STATEMENT:
+        if (stmt->child_count > 0) n = 1 + count_statement_scopes(stmt->children[0], 0);
+        break;
+
+    case AST_STATEMENT_BLOCK:
+        if (!in_function) n = 1;
+        for (int i = 0; i < stmt->child_count; i++) n += count_statement_scopes(stmt->children[i], in_function);
+        break;
+
+    case AST_STATEMENT_LIST:
+        for (int i = 0; i < stmt->child_count; i++) n += count_statement_scopes(stmt->children[i], in_function);
+        break;
+
+    default:
+        break;
+    }
+    return n;
+}
+
+/* Сколько областей создаст semantic_analyze_function */
+static int count_function_scopes(const ASTNode* func_def) {
+    if (!func_def || func_def->type != AST_FUNCTION_DEF) return 0;
+
+    int n = 1;
+    if (func_def->child_count > 1 && func_def->children[1]) {
+        const ASTNode* body = func_def->children[1];
+        for (int j = 0; j < body->child_count; j++) n += count_statement_scopes(body->children[j], 1);
+    }
+    return n;
+}
+
+/* Локальная таблица функции поверх замороженного глобального слоя;
+ * её области нумеруются с first_scope_id */
+static SymbolTable* symbol_table_create_local(const SymbolTable* globals, int first_scope_id) {
+    SymbolTable* st = (SymbolTable*)calloc(1, sizeof(SymbolTable));
+    if (!st) return NULL;
+
+    st->max_symbols = 32;
+    st->symbols = (Symbol*)malloc(st->max_symbols * sizeof(Symbol));
+    st->next_symbol_index = 1;              /* сквозные номера - при слиянии */
+
+    st->max_scopes = 8;
+    st->scopes = (Scope**)malloc(st->max_scopes * sizeof(Scope*));
+    st->next_scope_id = first_scope_id;
+    st->current_scope = globals->scopes[0];
+
+    st->debug_enabled = globals->debug_enabled;
+    st->types = globals->types;             /* общая, вставка под мьютексом */
+    st->globals = globals;
+
+    if (!st->symbols || !st->scopes) {
+        free(st->symbols);
+        free(st->scopes);
+        free(st);
+        return NULL;
+    }
+    return st;
+}
+
+/* Перенести локальную таблицу в st и освободить её оболочку */
+static void symbol_table_merge_local(SymbolTable* st, SymbolTable* local) {
+    /* вывод задачи - на своё место в общем порядке */
+    for (size_t at = 0; at < local->log_size;) {
+        const char* text = local->log + at + 1;
+        size_t len = strlen(text);
+        trace_write(TRACE_SEMANTIC, (unsigned char)local->log[at], text, len);
+        at += len + 2;
+    }
+
+    /* области (указатели на Scope не меняются, символы ссылаются на них);
+     * диапазон потомков и списки символов сдвигаются вместе с номерами */
+    int base = st->symbol_count;
+    for (int i = 0; i < local->scope_count; i++) {
+        if (st->scope_count >= st->max_scopes) {
+            st->max_scopes *= 2;
+            st->scopes = (Scope**)realloc(st->scopes, st->max_scopes * sizeof(Scope*));
+        }
+        Scope* scope = local->scopes[i];
+        int id = st->next_scope_id++;
+        scope->last_id += id - scope->id;
+        scope->id = id;
+        for (int k = 0; k < scope->symbol_count; k++) scope->symbols[k] += base;
+        st->scopes[st->scope_count++] = scope;
+    }
+
+    /* символы: строки переходят во владение st */
+    for (int i = 0; i < local->symbol_count; i++) {
+        if (st->symbol_count >= st->max_symbols) {
+            st->max_symbols *= 2;
+            st->symbols = (Symbol*)realloc(st->symbols, st->max_symbols * sizeof(Symbol));
+        }
+        Symbol* sym = &st->symbols[st->symbol_count++];
+        *sym = local->symbols[i];
+        sym->index = st->next_symbol_index++;
+        sym->scope_id = sym->scope->id;
+    }
+
+    for (int i = 0; i < local->bound_count; i++) local->bound[i]->symbol += base;
+
+    /* globals == st уже вырос на символы предыдущих функций */
+    if (local->global_marks) {
+        for (int i = 0; i < local->global_mark_count; i++) {
+            if (local->global_marks[i]) apply_symbol_marks(&st->symbols[i], local->global_marks[i]);
+        }
+    }
+
+    for (int i = 0; i < local->error_count; i++) {
+        if (st->error_count >= 1024) {
+            trace_printf(TRACE_SEMANTIC, TRACE_WARN, "[WARNING] Error message buffer full!\n");
+            free(local->error_messages[i]);
+            continue;
+        }
+        st->error_messages[st->error_count++] = local->error_messages[i];
+    }
+
+    free(local->symbols);
+    free(local->scopes);
+    free(local->bound);
+    free(local->global_marks);
+    free(local->log);
+    free(local);
+}
+
+typedef struct {
+    ASTNode* ast;
+    const SymbolTable* globals;
+    int* first_scope_id;
+    SymbolTable** locals;
+} SemanticJob;
+
+static void analyze_function_task(void* arg, int index) {
+    SemanticJob* job = (SemanticJob*)arg;
+    ASTNode* func_def = job->ast->children[index];
+    if (!func_def || func_def->type != AST_FUNCTION_DEF) return;
+
+    SymbolTable* local = symbol_table_create_local(job->globals, job->first_scope_id[index]);
+    if (!local) return;
+    semantic_analyze_function(func_def, local);
+    job->locals[index] = local;
+}
+
+void semantic_analyze_parallel(ASTNode* ast, SymbolTable* st, Scheduler* sched) {
+    if (!ast || !st || ast->type != AST_PROGRAM) return;
+
+    printf("[*] Starting semantic analysis...\n");
+    st->debug_enabled = TRACE_ON(TRACE_SEMANTIC, TRACE_DEBUG);
+
+    /* Первый проход: добавление функций */
+    for (int i = 0; i < ast->child_count; i++) {
+        semantic_declare_function(ast->children[i], st);
+    }
+
+    /* Второй проход: анализ каждой функции в своей локальной таблице */
+    int n = ast->child_count;
+    SemanticJob job;
+    job.ast = ast;
+    job.globals = st;
+    job.first_scope_id = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    job.locals = (SymbolTable**)calloc((size_t)(n > 0 ? n : 1), sizeof(SymbolTable*));
+
+    if (job.first_scope_id && job.locals) {
+        int next_scope_id = st->next_scope_id;
+        for (int i = 0; i < n; i++) {
+            job.first_scope_id[i] = next_scope_id;
+            next_scope_id += count_function_scopes(ast->children[i]);
+        }
+
+        scheduler_parallel_for(sched, n, analyze_function_task, &job);
+
+        for (int i = 0; i < n; i++) {
+            if (job.locals[i]) symbol_table_merge_local(st, job.locals[i]);
+            else semantic_analyze_function(ast->children[i], st);  /* нет памяти под таблицу */
+        }
+    }
+    else {
+        for (int i = 0; i < n; i++) {
+            semantic_analyze_function(ast->children[i], st);
+        }
+    }
+    free(job.first_scope_id);
+    free(job.locals);
+
+    semantic_finish(st);
 
     printf("[+] Semantic analysis complete\n");
 }
@@ -1102,12 +1549,13 @@ static void calculate_offsets(SymbolTable* st) {
     /* Оффсеты для локальных переменных и параметров вычислены при добавлении */
 
     printf("[*] Calculating offsets...\n");
+    if (!TRACE_ON(TRACE_SEMANTIC, TRACE_DEBUG)) return;
 
     for (int i = 0; i < st->symbol_count; i++) {
         Symbol* sym = &st->symbols[i];
 
         if (sym->type == SYM_LOCAL || sym->type == SYM_PARAMETER) {
-            printf("  %s: offset = %d, size = %d, scope = %d\n",
+            TRACE(TRACE_SEMANTIC, TRACE_DEBUG, "  %s: offset = %d, size = %d, scope = %d\n",
                 sym->name, sym->offset, sym->size, sym->scope_id);
         }
     }
@@ -1122,16 +1570,19 @@ static void check_unused_symbols(SymbolTable* st) {
     for (int i = 0; i < st->symbol_count; i++) {
         Symbol* sym = &st->symbols[i];
 
+        /* временные компилятора ($cseN) появляются после анализа: в потоке
+           семантика завершается уже после оптимизаций */
         if (!sym->is_used && sym->type != SYM_FUNCTION &&
-            !sym->is_constant && sym->scope->type != SCOPE_GLOBAL) {
-            printf("  [WARNING] Unused %s: %s\n",
+            !sym->is_constant && sym->scope->type != SCOPE_GLOBAL &&
+            sym->name[0] != '$') {
+            TRACE(TRACE_SEMANTIC, TRACE_WARN, "  [WARNING] Unused %s: %s\n",
                 symbol_get_type_str(sym->type), sym->name);
             unused_count++;
         }
     }
 
     if (unused_count > 0) {
-        printf("  Found %d unused symbol(s)\n", unused_count);
+        TRACE(TRACE_SEMANTIC, TRACE_WARN, "  Found %d unused symbol(s)\n", unused_count);
     }
 }
 
@@ -1140,7 +1591,7 @@ void symbol_table_add_error(SymbolTable* st, const char* error_message) {
     if (!st || !error_message) return;
 
     if (st->error_count >= 1024) {
-        printf("[WARNING] Error message buffer full!\n");
+        semantic_printf(st, TRACE_WARN, "[WARNING] Error message buffer full!\n");
         return;
     }
 
@@ -1226,6 +1677,7 @@ void symbol_table_free(SymbolTable* st) {
         free(sym->name);
         if (sym->data_type) free(sym->data_type);
         if (sym->return_type) free(sym->return_type);
+        if (sym->const_value) free(sym->const_value);
 
         if (sym->param_types) {
             for (int j = 0; j < sym->param_count; j++) {
@@ -1240,6 +1692,7 @@ void symbol_table_free(SymbolTable* st) {
     /* Освобождаем области видимости */
     for (int i = 0; i < st->scope_count; i++) {
         if (st->scopes[i]->name) free(st->scopes[i]->name);
+        free(st->scopes[i]->symbols);
         free(st->scopes[i]);
     }
     free(st->scopes);
@@ -1249,5 +1702,6 @@ void symbol_table_free(SymbolTable* st) {
         free(st->error_messages[i]);
     }
 
+    type_table_free(st->types);
     free(st);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define SEMANTIC_H
 
 #include "ast.h"
+#include "types.h"
 
 typedef enum {
     SYM_GLOBAL = 0,    // Глобальная переменная
@@ -26,12 +27,22 @@ typedef struct Scope {
     int level;                // Уровень вложенности
     int local_offset;         // Текущий оффсет для локальных переменных
     int param_offset;         // Текущий оффсет для параметров
+
+    // Области нумеруются в прямом порядке обхода, поэтому потомки области -
+    // непрерывный диапазон номеров [id, last_id] (глобальная - до INT_MAX)
+    int last_id;              // Последний ID среди потомков (ставится в scope_exit)
+
+    // Символы, объявленные прямо в этой области, в порядке объявления
+    int* symbols;             // Индексы в symbols таблицы-владельца
+    int symbol_count;
+    int symbol_capacity;
 } Scope;
 
 typedef struct {
     char* name;               // Имя символа
     SymbolType type;          // Тип символа
     char* data_type;          // Тип данных (int, string и т.д.)
+    const Type* dtype;        // Дескриптор типа (types.h): скаляр, массив или сигнатура
 
     // Информация о расположении
     int offset;               // Смещение в стеке/глобальной памяти
@@ -56,6 +67,9 @@ typedef struct {
     int line_number;          // Номер строки объявления
     int is_used;              // Используется ли символ
     int is_modified;          // Изменяется ли значение
+    int is_address_taken;     // Адрес берётся (&x, аргумент read_din/write_din)
+    int escapes;              // Объект (или массив по ссылке) переживает кадр функции
+    char* const_value;        // Значение константы (SYM_CONSTANT) или NULL
 
     // Для функций
     int param_count;          // Количество параметров
@@ -63,7 +77,7 @@ typedef struct {
     char* return_type;        // Тип возвращаемого значения
 } Symbol;
 
-typedef struct {
+typedef struct SymbolTable {
     Symbol* symbols;          // Массив символов
     int symbol_count;         // Количество символов
     int max_symbols;          // Максимальное количество символов
@@ -85,6 +99,24 @@ typedef struct {
 
     // Отладочная информация
     int debug_enabled;        // Включен ли отладочный вывод
+
+    // Результаты анализов
+    int escape_analyzed;      // Флаги is_address_taken/escapes заполнены (escape.c)
+
+    // Составные типы символов этой таблицы
+    TypeTable* types;
+
+    // Локальная таблица функции (параллельный анализ тел, semantic_analyze_parallel):
+    // глобальный слой заморожен и только читается, всё остальное - своё
+    const struct SymbolTable* globals;  // глобальный слой; NULL - обычная таблица
+    unsigned char* global_marks;        // used/modified/initialized символов globals до слияния
+    int global_mark_count;              // размер global_marks (globals->symbol_count при заморозке)
+    ASTNode** bound;                    // узлы, связанные с локальными символами
+    int bound_count;
+    int bound_capacity;
+    char* log;                          // отложенный вывод, печатается при слиянии
+    size_t log_size;
+    size_t log_capacity;
 } SymbolTable;
 
 /* Основные функции таблицы символов */
@@ -98,10 +130,19 @@ void scope_exit(SymbolTable* st);
 Scope* scope_get_current(SymbolTable* st);
 int scope_get_level(SymbolTable* st);
 
+/* Область по ID за O(1): ID таблицы идут подряд; NULL - нет такой */
+Scope* symbol_table_scope(const SymbolTable* st, int id);
+/* s совпадает с ancestor или вложена в неё (два сравнения диапазона ID) */
+int scope_contains(const Scope* ancestor, const Scope* s);
+/* Индексы символов области scope и вложенных в неё, по возрастанию
+   (порядок объявления); массив - malloc, освобождает вызывающий */
+int* symbol_table_scope_symbols(const SymbolTable* st, const Scope* scope, int* count);
+
 /* Функции добавления символов */
 void symbol_table_add_global(SymbolTable* st, const char* name, const char* data_type,
     int is_array, int array_size);
-void symbol_table_add_local(SymbolTable* st, const char* name, const char* data_type,
+/* Индекс нового символа в st->symbols (для ASTNode.symbol); -1 - не добавлен */
+int symbol_table_add_local(SymbolTable* st, const char* name, const char* data_type,
     int is_array, int array_size);
 void symbol_table_add_parameter(SymbolTable* st, const char* name, const char* data_type,
     int param_index);
@@ -114,6 +155,12 @@ void symbol_table_add_constant(SymbolTable* st, const char* name, const char* da
 Symbol* symbol_table_lookup(SymbolTable* st, const char* name);
 Symbol* symbol_table_lookup_current_scope(SymbolTable* st, const char* name);
 Symbol* symbol_table_lookup_global(SymbolTable* st, const char* name);
+Symbol* symbol_table_lookup_in_scope(const SymbolTable* st, const char* name, int scope_id);
+Scope* symbol_table_find_function_scope(const SymbolTable* st, const char* func_name);
+Symbol* symbol_table_return_symbol(const SymbolTable* st, const char* func_name, int func_scope_id);
+/* Символ идентификатора/вызова: привязка node->symbol из semantic_analyze;
+   узлы без привязки (созданные после анализа) ищутся по имени от scope_id */
+Symbol* symbol_table_resolve(const SymbolTable* st, const ASTNode* node, int scope_id);
 int symbol_is_declared(SymbolTable* st, const char* name);
 
 /* Информация о символах */
@@ -126,6 +173,21 @@ const char* symbol_get_type_str(SymbolType type);
 
 /* Функции семантического анализа */
 void semantic_analyze(ASTNode* ast, SymbolTable* symbol_table);
+
+/* То же, тела функций - по задаче на функцию в sched (NULL - по очереди).
+   Сигнатуры регистрируются заранее, глобальный слой таблицы замораживается,
+   каждая функция анализируется в свою локальную таблицу (символы, области,
+   ошибки, вывод), затем локальные таблицы сливаются в st по порядку функций -
+   результат и вывод совпадают с последовательным анализом. */
+struct Scheduler;
+void semantic_analyze_parallel(ASTNode* ast, SymbolTable* symbol_table, struct Scheduler* sched);
+
+/* semantic_analyze по частям (потоковая компиляция, compiler.c):
+   объявление сигнатуры, анализ тела в своей области видимости,
+   итоговые проверки после последней функции */
+void semantic_declare_function(ASTNode* func_def, SymbolTable* st);
+void semantic_analyze_function(ASTNode* func_def, SymbolTable* st);
+void semantic_finish(SymbolTable* st);
 void check_expression(ASTNode* expr, SymbolTable* st, int line_num);
 void mark_ast_error(ASTNode* node, const char* format, ...);
 
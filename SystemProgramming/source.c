@@ -0,0 +1,220 @@
+﻿#include "source.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceManager* source_manager_create(void) {
+    return (SourceManager*)calloc(1, sizeof(SourceManager));
+}
+
+static void source_buffer_free(SourceBuffer* b) {
+    if (!b) return;
+    if (b->mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(b->data);
+        CloseHandle((HANDLE)b->map_handle);
+        CloseHandle((HANDLE)b->file_handle);
+#else
+        munmap((void*)b->data, b->size);
+#endif
+    }
+    else {
+        free((void*)b->data);
+    }
+    free(b->line_starts);
+    free(b->path);
+    free(b);
+}
+
+void source_manager_free(SourceManager* sm) {
+    if (!sm) return;
+    for (int i = 0; i < sm->count; i++) source_buffer_free(sm->buffers[i]);
+    free(sm->buffers);
+    free(sm);
+}
+
+static int source_manager_add(SourceManager* sm, SourceBuffer* b) {
+    if (sm->count >= sm->capacity) {
+        int cap = sm->capacity ? sm->capacity * 2 : 4;
+        SourceBuffer** p = (SourceBuffer**)realloc(sm->buffers, (size_t)cap * sizeof(SourceBuffer*));
+        if (!p) {
+            source_buffer_free(b);
+            return -1;
+        }
+        sm->buffers = p;
+        sm->capacity = cap;
+    }
+    sm->buffers[sm->count] = b;
+    return sm->count++;
+}
+
+static SourceBuffer* source_buffer_new(const char* path) {
+    SourceBuffer* b = (SourceBuffer*)calloc(1, sizeof(SourceBuffer));
+    if (!b) return NULL;
+    b->path = strdup(path ? path : "<input>");
+    return b;
+}
+
+/* Весь поток в malloc-буфер (pipe, stdin, пустой файл) */
+static int source_read_all(SourceBuffer* b, FILE* input) {
+    size_t cap = 4096, len = 0, n;
+    char* buf = (char*)malloc(cap);
+    if (!buf) return 0;
+    while ((n = fread(buf + len, 1, cap - len, input)) > 0) {
+        len += n;
+        if (len == cap) {
+            char* grown = (char*)realloc(buf, cap * 2);
+            if (!grown) {
+                free(buf);
+                return 0;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+    }
+    b->data = buf;
+    b->size = len;
+    return 1;
+}
+
+int source_manager_open(SourceManager* sm, const char* path) {
+    if (!sm || !path) return -1;
+    SourceBuffer* b = source_buffer_new(path);
+    if (!b) return -1;
+
+#ifdef _WIN32
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(fh, &size) && size.QuadPart > 0) {
+            HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+            const void* view = mh ? MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0) : NULL;
+            if (view) {
+                b->data = (const char*)view;
+                b->size = (size_t)size.QuadPart;
+                b->mapped = 1;
+                b->file_handle = fh;
+                b->map_handle = mh;
+                return source_manager_add(sm, b);
+            }
+            if (mh) CloseHandle(mh);
+        }
+        CloseHandle(fh);
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+        struct stat sb;
+        if (fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0) {
+            void* p = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                close(fd);
+                b->data = (const char*)p;
+                b->size = (size_t)sb.st_size;
+                b->mapped = 1;
+                return source_manager_add(sm, b);
+            }
+        }
+        close(fd);
+    }
+#endif
+
+    /* не отобразился (пустой файл, не обычный файл) - читаем */
+    FILE* input = fopen(path, "rb");
+    if (!input) {
+        source_buffer_free(b);
+        return -1;
+    }
+    int ok = source_read_all(b, input);
+    fclose(input);
+    if (!ok) {
+        source_buffer_free(b);
+        return -1;
+    }
+    return source_manager_add(sm, b);
+}
+
+int source_manager_add_stream(SourceManager* sm, const char* name, FILE* input) {
+    if (!sm || !input) return -1;
+    SourceBuffer* b = source_buffer_new(name);
+    if (!b) return -1;
+
+#ifndef _WIN32
+    struct stat sb;
+    int fd = fileno(input);
+    if (fd >= 0 && fstat(fd, &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_size > 0 && ftell(input) == 0) {
+        void* p = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            b->data = (const char*)p;
+            b->size = (size_t)sb.st_size;
+            b->mapped = 1;
+            return source_manager_add(sm, b);
+        }
+    }
+#endif
+
+    if (!source_read_all(b, input)) {
+        source_buffer_free(b);
+        return -1;
+    }
+    return source_manager_add(sm, b);
+}
+
+const SourceBuffer* source_manager_buffer(const SourceManager* sm, int file) {
+    if (!sm || file < 0 || file >= sm->count) return NULL;
+    return sm->buffers[file];
+}
+
+const char* source_span_text(const SourceManager* sm, SourceSpan span) {
+    const SourceBuffer* b = source_manager_buffer(sm, span.file);
+    if (!b || span.offset > b->size) return NULL;
+    return b->data + span.offset;
+}
+
+static int source_build_lines(SourceBuffer* b) {
+    int count = 1;
+    for (const char* p = b->data; (p = (const char*)memchr(p, '\n', (size_t)(b->data + b->size - p))) != NULL; p++) {
+        count++;
+    }
+
+    b->line_starts = (unsigned*)malloc((size_t)count * sizeof(unsigned));
+    if (!b->line_starts) return 0;
+
+    int line = 0;
+    b->line_starts[line++] = 0;
+    for (size_t i = 0; i < b->size; i++) {
+        if (b->data[i] == '\n') b->line_starts[line++] = (unsigned)(i + 1);
+    }
+    b->line_count = count;
+    return 1;
+}
+
+SourceLocation source_span_location(SourceManager* sm, SourceSpan span) {
+    SourceLocation loc = { "<unknown>", 0, 0 };
+    if (!sm || span.file < 0 || span.file >= sm->count) return loc;
+
+    SourceBuffer* b = sm->buffers[span.file];
+    loc.path = b->path;
+    if (!b->line_starts && !source_build_lines(b)) return loc;
+
+    /* последняя строка, начало которой <= offset */
+    int lo = 0, hi = b->line_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (b->line_starts[mid] <= span.offset) lo = mid;
+        else hi = mid - 1;
+    }
+    loc.line = lo + 1;
+    loc.column = (int)(span.offset - b->line_starts[lo]) + 1;
+    return loc;
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Менеджер исходников: файлы отображаются в память только для чтения
+     * (mmap / MapViewOfFile), потоки (pipe, stdin) читаются в буфер целиком.
+     * Буфер живёт до source_manager_free, поэтому лексемы и узлы AST
+     * ссылаются на текст диапазоном (файл, смещение, длина), а не копией.
+     *
+     * Номер строки и колонка считаются только по запросу (диагностика):
+     * таблица начал строк строится при первом обращении к файлу.
+     * Один менеджер - один поток (CompilerContext владеет своим).
+     */
+
+#define SOURCE_NO_FILE (-1)
+
+    typedef struct {
+        int file;                   /* SOURCE_NO_FILE - позиция неизвестна */
+        unsigned offset;            /* байт от начала файла */
+        unsigned length;
+    } SourceSpan;
+
+    /*
+     * Значение литерала разбирается лексером один раз; проходы читают его,
+     * а не текст. Целые - не больше 32 бит без знака (0x.., 0b.., десятичные),
+     * вещественные - Q16.16 в int32. overflow - значение не поместилось.
+     */
+    typedef enum {
+        LIT_NONE = 0,
+        LIT_INT,
+        LIT_FIXED,                  /* Q16.16 */
+        LIT_CHAR,                   /* код символа */
+        LIT_BOOL
+    } LiteralKind;
+
+    typedef struct {
+        LiteralKind kind;
+        int overflow;
+        int64_t value;
+    } LiteralValue;
+
+    /* Лексема: текст в буфере исходника (без '\0'), его диапазон и значение литерала */
+    typedef struct {
+        const char* text;
+        SourceSpan span;
+        LiteralValue literal;       /* LIT_NONE - не литерал */
+    } SourceToken;
+
+    typedef struct {
+        const char* path;
+        int line;                   /* с 1 */
+        int column;                 /* с 1, в байтах */
+    } SourceLocation;
+
+    typedef struct {
+        char* path;
+        const char* data;
+        size_t size;
+
+        int mapped;                 /* data - отображение файла, а не malloc */
+#ifdef _WIN32
+        void* file_handle;
+        void* map_handle;
+#endif
+
+        unsigned* line_starts;      /* лениво, см. source_span_location */
+        int line_count;
+    } SourceBuffer;
+
+    typedef struct SourceManager {
+        SourceBuffer** buffers;
+        int count;
+        int capacity;
+    } SourceManager;
+
+    SourceManager* source_manager_create(void);
+    void source_manager_free(SourceManager* sm);
+
+    /* Открыть файл; номер файла или -1 */
+    int source_manager_open(SourceManager* sm, const char* path);
+
+    /* Уже открытый поток: обычный файл отображается, остальное читается */
+    int source_manager_add_stream(SourceManager* sm, const char* name, FILE* input);
+
+    const SourceBuffer* source_manager_buffer(const SourceManager* sm, int file);
+
+    /* Начало текста диапазона в буфере (без '\0'); NULL - нет файла */
+    const char* source_span_text(const SourceManager* sm, SourceSpan span);
+
+    /* Строка и колонка начала диапазона */
+    SourceLocation source_span_location(SourceManager* sm, SourceSpan span);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+﻿#include "thread.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* =========================
+ * Threads / mutexes
+ * ========================= */
+
+#ifdef _WIN32
+static DWORD WINAPI thread_trampoline(LPVOID p) {
+    Thread* t = (Thread*)p;
+    t->func(t->arg);
+    return 0;
+}
+#else
+static void* thread_trampoline(void* p) {
+    Thread* t = (Thread*)p;
+    t->func(t->arg);
+    return NULL;
+}
+#endif
+
+int thread_start(Thread* t, ThreadFunc func, void* arg) {
+    if (!t || !func) return 0;
+    t->func = func;
+    t->arg = arg;
+#ifdef _WIN32
+    t->handle = CreateThread(NULL, 0, thread_trampoline, t, 0, NULL);
+    return t->handle != NULL;
+#else
+    return pthread_create(&t->handle, NULL, thread_trampoline, t) == 0;
+#endif
+}
+
+void thread_join(Thread* t) {
+    if (!t) return;
+#ifdef _WIN32
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+#else
+    pthread_join(t->handle, NULL);
+#endif
+}
+
+void mutex_init(Mutex* m) {
+#ifdef _WIN32
+    InitializeCriticalSection(&m->cs);
+#else
+    pthread_mutex_init(&m->m, NULL);
+#endif
+}
+
+void mutex_lock(Mutex* m) {
+#ifdef _WIN32
+    EnterCriticalSection(&m->cs);
+#else
+    pthread_mutex_lock(&m->m);
+#endif
+}
+
+void mutex_unlock(Mutex* m) {
+#ifdef _WIN32
+    LeaveCriticalSection(&m->cs);
+#else
+    pthread_mutex_unlock(&m->m);
+#endif
+}
+
+void mutex_destroy(Mutex* m) {
+#ifdef _WIN32
+    DeleteCriticalSection(&m->cs);
+#else
+    pthread_mutex_destroy(&m->m);
+#endif
+}
+
+void condvar_init(CondVar* c) {
+#ifdef _WIN32
+    InitializeConditionVariable(&c->cv);
+#else
+    pthread_cond_init(&c->cv, NULL);
+#endif
+}
+
+void condvar_wait(CondVar* c, Mutex* m) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&c->cv, &m->cs, INFINITE);
+#else
+    pthread_cond_wait(&c->cv, &m->m);
+#endif
+}
+
+void condvar_signal(CondVar* c) {
+#ifdef _WIN32
+    WakeConditionVariable(&c->cv);
+#else
+    pthread_cond_signal(&c->cv);
+#endif
+}
+
+void condvar_broadcast(CondVar* c) {
+#ifdef _WIN32
+    WakeAllConditionVariable(&c->cv);
+#else
+    pthread_cond_broadcast(&c->cv);
+#endif
+}
+
+void condvar_destroy(CondVar* c) {
+#ifdef _WIN32
+    (void)c;
+#else
+    pthread_cond_destroy(&c->cv);
+#endif
+}
+
+int atomic_increment(volatile int* v) {
+#ifdef _WIN32
+    return (int)InterlockedIncrement((volatile LONG*)v);
+#else
+    return __atomic_add_fetch(v, 1, __ATOMIC_ACQ_REL);
+#endif
+}
+
+int atomic_decrement(volatile int* v) {
+#ifdef _WIN32
+    return (int)InterlockedDecrement((volatile LONG*)v);
+#else
+    return __atomic_sub_fetch(v, 1, __ATOMIC_ACQ_REL);
+#endif
+}
+
+int thread_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
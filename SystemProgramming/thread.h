@@ -0,0 +1,73 @@
+﻿#pragma once
+#ifndef THREAD_H
+#define THREAD_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Минимальная переносимая обёртка над потоками (Win32 / pthreads).
+     */
+
+    typedef void (*ThreadFunc)(void* arg);
+
+    typedef struct {
+#ifdef _WIN32
+        HANDLE handle;
+#else
+        pthread_t handle;
+#endif
+        ThreadFunc func;
+        void* arg;
+    } Thread;
+
+    typedef struct {
+#ifdef _WIN32
+        CRITICAL_SECTION cs;
+#else
+        pthread_mutex_t m;
+#endif
+    } Mutex;
+
+    typedef struct {
+#ifdef _WIN32
+        CONDITION_VARIABLE cv;
+#else
+        pthread_cond_t cv;
+#endif
+    } CondVar;
+
+    /* 1 = ok, 0 = error. Thread должен жить до thread_join. */
+    int thread_start(Thread* t, ThreadFunc func, void* arg);
+    void thread_join(Thread* t);
+
+    void mutex_init(Mutex* m);
+    void mutex_lock(Mutex* m);
+    void mutex_unlock(Mutex* m);
+    void mutex_destroy(Mutex* m);
+
+    void condvar_init(CondVar* c);
+    void condvar_wait(CondVar* c, Mutex* m);
+    void condvar_signal(CondVar* c);
+    void condvar_broadcast(CondVar* c);
+    void condvar_destroy(CondVar* c);
+
+    /* Атомарные +1 / -1, возвращают новое значение */
+    int atomic_increment(volatile int* v);
+    int atomic_decrement(volatile int* v);
+
+    /* Число логических процессоров (>= 1) */
+    int thread_cpu_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
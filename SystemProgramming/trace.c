@@ -0,0 +1,169 @@
+﻿#include "trace.h"
+#include "thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int trace_levels[TRACE_SUBSYSTEM_COUNT] = {
+    TRACE_DEFAULT_LEVEL, TRACE_DEFAULT_LEVEL, TRACE_DEFAULT_LEVEL, TRACE_DEFAULT_LEVEL
+};
+
+static const char* const trace_subsystem_names[TRACE_SUBSYSTEM_COUNT] = {
+    "lexer", "semantic", "cfg", "codegen"
+};
+
+static const char* const trace_level_names[] = {
+    "none", "error", "warn", "info", "debug"
+};
+
+#define TRACE_LEVEL_COUNT ((int)(sizeof(trace_level_names) / sizeof(trace_level_names[0])))
+
+static TraceRecord* trace_ring = NULL;
+static volatile int trace_ring_next = 0;    /* последний занятый seq */
+
+/* =========================
+ * Кольцевой буфер
+ * ========================= */
+
+int trace_ring_enable(void) {
+    if (trace_ring) return 1;
+    trace_ring = (TraceRecord*)calloc(TRACE_RING_SIZE, sizeof(TraceRecord));
+    return trace_ring != NULL;
+}
+
+static TraceRecord* trace_ring_claim(TraceSubsystem sys, int level) {
+    unsigned seq = (unsigned)atomic_increment(&trace_ring_next);
+    TraceRecord* r = &trace_ring[seq & (TRACE_RING_SIZE - 1)];
+    r->seq = seq;
+    r->subsystem = (uint8_t)sys;
+    r->level = (uint8_t)level;
+    return r;
+}
+
+static void trace_ring_put(TraceSubsystem sys, int level, const char* text, size_t len) {
+    TraceRecord* r = trace_ring_claim(sys, level);
+    if (len > TRACE_TEXT_SIZE) len = TRACE_TEXT_SIZE;
+    memcpy(r->text, text, len);
+    r->length = (uint16_t)len;
+}
+
+int trace_ring_dump(const char* path) {
+    if (!trace_ring || !path) return 0;
+    FILE* f = fopen(path, "wb");
+    if (!f) return 0;
+
+    unsigned last = (unsigned)trace_ring_next;
+    unsigned count = last < TRACE_RING_SIZE ? last : TRACE_RING_SIZE;
+    TraceRingHeader h;
+    memcpy(h.magic, "TRC1", 4);
+    h.record_size = (uint32_t)sizeof(TraceRecord);
+    h.count = count;
+    h.dropped = last - count;
+
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for (unsigned seq = last - count + 1; ok && seq <= last; seq++) {
+        ok = fwrite(&trace_ring[seq & (TRACE_RING_SIZE - 1)], sizeof(TraceRecord), 1, f) == 1;
+    }
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
+
+void trace_shutdown(void) {
+    free(trace_ring);
+    trace_ring = NULL;
+    trace_ring_next = 0;
+}
+
+/* =========================
+ * Запись
+ * ========================= */
+
+void trace_vprintf(TraceSubsystem sys, int level, const char* format, va_list args) {
+    if (!trace_ring) {
+        vprintf(format, args);
+        return;
+    }
+
+    /* +1 под завершающий ноль vsnprintf */
+    char buf[TRACE_TEXT_SIZE + 1];
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    if (n < 0) return;
+    size_t len = (size_t)n < TRACE_TEXT_SIZE ? (size_t)n : TRACE_TEXT_SIZE;
+    if (len > 0 && buf[len - 1] == '\n') len--;
+    trace_ring_put(sys, level, buf, len);
+}
+
+void trace_printf(TraceSubsystem sys, int level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    trace_vprintf(sys, level, format, args);
+    va_end(args);
+}
+
+void trace_write(TraceSubsystem sys, int level, const char* text, size_t len) {
+    if (!text || len == 0) return;
+    if (!trace_ring) {
+        fwrite(text, 1, len, stdout);
+        return;
+    }
+
+    const char* end = text + len;
+    while (text < end) {
+        const char* nl = (const char*)memchr(text, '\n', (size_t)(end - text));
+        const char* stop = nl ? nl : end;
+        trace_ring_put(sys, level, text, (size_t)(stop - text));
+        text = nl ? nl + 1 : end;
+    }
+}
+
+/* =========================
+ * Разбор -trace
+ * ========================= */
+
+static int trace_match(const char* s, size_t len, const char* name) {
+    return strlen(name) == len && strncmp(s, name, len) == 0;
+}
+
+static int trace_parse_level(const char* s, size_t len) {
+    if (len == 1 && s[0] >= '0' && s[0] < '0' + TRACE_LEVEL_COUNT) return s[0] - '0';
+    for (int i = 0; i < TRACE_LEVEL_COUNT; i++) {
+        if (trace_match(s, len, trace_level_names[i])) return i;
+    }
+    return -1;
+}
+
+int trace_configure(const char* spec) {
+    if (!spec) return 0;
+    int levels[TRACE_SUBSYSTEM_COUNT];
+    memcpy(levels, trace_levels, sizeof(levels));
+
+    const char* p = spec;
+    while (*p) {
+        const char* item_end = strchr(p, ',');
+        if (!item_end) item_end = p + strlen(p);
+        const char* eq = (const char*)memchr(p, '=', (size_t)(item_end - p));
+
+        const char* level_str = eq ? eq + 1 : p;
+        int level = trace_parse_level(level_str, (size_t)(item_end - level_str));
+        if (level < 0) return 0;
+
+        size_t name_len = eq ? (size_t)(eq - p) : 0;
+        if (!eq || trace_match(p, name_len, "all")) {
+            for (int i = 0; i < TRACE_SUBSYSTEM_COUNT; i++) levels[i] = level;
+        }
+        else {
+            int sys = -1;
+            for (int i = 0; i < TRACE_SUBSYSTEM_COUNT; i++) {
+                if (trace_match(p, name_len, trace_subsystem_names[i])) sys = i;
+            }
+            if (sys < 0) return 0;
+            levels[sys] = level;
+        }
+
+        p = *item_end ? item_end + 1 : item_end;
+    }
+
+    memcpy(trace_levels, levels, sizeof(levels));
+    return 1;
+}
@@ -0,0 +1,99 @@
+﻿#pragma once
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Трассировка проходов.
+     *
+     * Сообщение относится к подсистеме (лексер, семантика, CFG, кодоген)
+     * и имеет уровень. Уровень подсистемы задаётся при запуске (-trace),
+     * TRACE проверяет его до вычисления аргументов: подавленное сообщение
+     * не форматируется и не трогает вывод. TRACE_MAX_LEVEL отсекает уровни
+     * при сборке - с -DTRACE_MAX_LEVEL=TRACE_INFO отладочные TRACE
+     * в код не попадают вовсе.
+     *
+     * Вывод - stdout (текст как есть) или кольцевой буфер в памяти:
+     * последние TRACE_RING_SIZE записей фиксированного размера, запись
+     * занимает слот атомарным счётчиком и не ждёт ни других потоков,
+     * ни терминала. trace_ring_dump сохраняет буфер в двоичный файл.
+     */
+
+    typedef enum {
+        TRACE_LEXER,
+        TRACE_SEMANTIC,
+        TRACE_CFG,
+        TRACE_CODEGEN,
+        TRACE_SUBSYSTEM_COUNT
+    } TraceSubsystem;
+
+#define TRACE_NONE  0
+#define TRACE_ERROR 1
+#define TRACE_WARN  2
+#define TRACE_INFO  3
+#define TRACE_DEBUG 4
+
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL TRACE_DEBUG
+#endif
+
+#define TRACE_DEFAULT_LEVEL TRACE_WARN
+
+    /* Уровни подсистем; меняются только до запуска проходов */
+    extern int trace_levels[TRACE_SUBSYSTEM_COUNT];
+
+#define TRACE_ON(sys, level) ((level) <= TRACE_MAX_LEVEL && (level) <= trace_levels[sys])
+
+#define TRACE(sys, level, ...) \
+    do { if (TRACE_ON(sys, level)) trace_printf((sys), (level), __VA_ARGS__); } while (0)
+
+    /* Форматирование без проверки уровня - её делает TRACE / TRACE_ON */
+    void trace_printf(TraceSubsystem sys, int level, const char* format, ...);
+    void trace_vprintf(TraceSubsystem sys, int level, const char* format, va_list args);
+
+    /* Готовый текст (в кольце - запись на строку) */
+    void trace_write(TraceSubsystem sys, int level, const char* text, size_t len);
+
+    /* "debug", "cfg=debug,semantic=info", "all=none,codegen=info"; 0 - ошибка разбора */
+    int trace_configure(const char* spec);
+
+    /* ========================= * Кольцевой буфер * ========================= */
+
+#define TRACE_RING_SIZE 4096        /* записей, степень двойки */
+#define TRACE_TEXT_SIZE 120
+
+    typedef struct {
+        uint32_t seq;               /* номер записи с 1 */
+        uint8_t subsystem;
+        uint8_t level;
+        uint16_t length;            /* длина text (обрезанного) */
+        char text[TRACE_TEXT_SIZE]; /* без '\n' и завершающего нуля */
+    } TraceRecord;
+
+    typedef struct {
+        char magic[4];              /* "TRC1" */
+        uint32_t record_size;       /* sizeof(TraceRecord) */
+        uint32_t count;             /* записей в файле */
+        uint32_t dropped;           /* вытеснено более новыми */
+    } TraceRingHeader;
+
+    /* Вывод в кольцо вместо stdout; 0 - нет памяти */
+    int trace_ring_enable(void);
+
+    /* Заголовок и записи по возрастанию seq; 0 - ошибка записи */
+    int trace_ring_dump(const char* path);
+
+    void trace_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+﻿#include "types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* =========================
+ * Встроенные скаляры (индекс - TypeKind)
+ * ========================= */
+
+#define TYPE_SCALAR(k, n, sz, al, integer) { k, n, sz, al, integer, NULL, 0, 0, NULL, 0, NULL, 0, NULL }
+
+static const Type type_builtins[] = {
+    TYPE_SCALAR(TYPE_UNKNOWN, "unknown", 4, 4, 0),
+    TYPE_SCALAR(TYPE_VOID,    "void",    0, 4, 0),
+    TYPE_SCALAR(TYPE_BOOL,    "bool",    4, 4, 1),
+    TYPE_SCALAR(TYPE_BYTE,    "byte",    4, 4, 1),
+    TYPE_SCALAR(TYPE_INT,     "int",     4, 4, 1),
+    TYPE_SCALAR(TYPE_UINT,    "uint",    4, 4, 1),
+    TYPE_SCALAR(TYPE_LONG,    "long",    8, 8, 0),
+    TYPE_SCALAR(TYPE_ULONG,   "ulong",   8, 8, 0),
+    TYPE_SCALAR(TYPE_FLOAT,   "float",   4, 4, 0),
+    TYPE_SCALAR(TYPE_DIN,     "din",     8, 8, 0),   /* значение + тег */
+    TYPE_SCALAR(TYPE_CHAR,    "char",    4, 4, 1),
+    TYPE_SCALAR(TYPE_STRING,  "string",  4, 4, 0),
+};
+
+#define TYPE_BUILTIN_COUNT ((int)(sizeof(type_builtins) / sizeof(type_builtins[0])))
+
+const Type* type_builtin(TypeKind kind) {
+    if ((int)kind < 0 || (int)kind >= TYPE_BUILTIN_COUNT) return &type_builtins[TYPE_UNKNOWN];
+    return &type_builtins[kind];
+}
+
+const Type* type_element(const Type* t) {
+    return (t && t->kind == TYPE_ARRAY) ? t->elem : t;
+}
+
+/* =========================
+ * Таблица составных типов
+ * ========================= */
+
+TypeTable* type_table_create(void) {
+    TypeTable* tt = (TypeTable*)calloc(1, sizeof(TypeTable));
+    if (!tt) return NULL;
+    tt->bucket_count = 64;
+    tt->buckets = (Type**)calloc((size_t)tt->bucket_count, sizeof(Type*));
+    if (!tt->buckets) {
+        free(tt);
+        return NULL;
+    }
+    mutex_init(&tt->lock);
+    return tt;
+}
+
+void type_table_free(TypeTable* tt) {
+    if (!tt) return;
+    for (int i = 0; i < tt->bucket_count; i++) {
+        Type* t = tt->buckets[i];
+        while (t) {
+            Type* next = t->next;
+            free((char*)t->name);
+            free(t->params);
+            free(t);
+            t = next;
+        }
+    }
+    free(tt->buckets);
+    mutex_destroy(&tt->lock);
+    free(tt);
+}
+
+static unsigned type_hash_mix(unsigned h, unsigned v) {
+    return (h ^ v) * 16777619u;
+}
+
+static unsigned type_hash_ptr(unsigned h, const void* p) {
+    size_t v = (size_t)p;
+    h = type_hash_mix(h, (unsigned)v);
+    return type_hash_mix(h, (unsigned)(v >> 16 >> 16));
+}
+
+static unsigned type_hash_str(const char* s) {
+    unsigned h = 2166136261u;
+    while (*s) h = type_hash_mix(h, (unsigned char)*s++);
+    return h;
+}
+
+static const char* type_name_of(const Type* t) {
+    return t ? t->name : "unknown";
+}
+
+static void type_table_grow(TypeTable* tt) {
+    int count = tt->bucket_count * 2;
+    Type** buckets = (Type**)calloc((size_t)count, sizeof(Type*));
+    if (!buckets) return;
+    for (int i = 0; i < tt->bucket_count; i++) {
+        Type* t = tt->buckets[i];
+        while (t) {
+            Type* next = t->next;
+            int b = (int)(t->hash & (unsigned)(count - 1));
+            t->next = buckets[b];
+            buckets[b] = t;
+            t = next;
+        }
+    }
+    free(tt->buckets);
+    tt->buckets = buckets;
+    tt->bucket_count = count;
+}
+
+/* Новый дескриптор; t заполнен вызывающим, name - во владение таблицы */
+static const Type* type_table_insert(TypeTable* tt, Type* t) {
+    if (tt->count >= tt->bucket_count) type_table_grow(tt);
+    int b = (int)(t->hash & (unsigned)(tt->bucket_count - 1));
+    t->next = tt->buckets[b];
+    tt->buckets[b] = t;
+    tt->count++;
+    return t;
+}
+
+/* Именованный тип; вызывается под tt->lock */
+static const Type* type_named_locked(TypeTable* tt, const char* name) {
+    unsigned h = type_hash_mix(type_hash_str(name), TYPE_NAMED);
+    for (Type* t = tt->buckets[h & (unsigned)(tt->bucket_count - 1)]; t; t = t->next) {
+        if (t->hash == h && t->kind == TYPE_NAMED && strcmp(t->name, name) == 0) return t;
+    }
+
+    Type* t = (Type*)calloc(1, sizeof(Type));
+    if (!t) return &type_builtins[TYPE_UNKNOWN];
+    t->kind = TYPE_NAMED;
+    t->name = strdup(name);
+    t->size = 4;
+    t->align = 4;
+    t->hash = h;
+    return type_table_insert(tt, t);
+}
+
+/* array[length] of elem; вызывается под tt->lock */
+static const Type* type_array_locked(TypeTable* tt, const Type* elem, int length) {
+    unsigned h = type_hash_mix(type_hash_ptr(2166136261u, elem), (unsigned)length);
+    h = type_hash_mix(h, TYPE_ARRAY);
+    for (Type* t = tt->buckets[h & (unsigned)(tt->bucket_count - 1)]; t; t = t->next) {
+        if (t->hash == h && t->kind == TYPE_ARRAY && t->elem == elem && t->length == length) return t;
+    }
+
+    Type* t = (Type*)calloc(1, sizeof(Type));
+    if (!t) return elem;
+    char buf[256];
+    if (length > 0) snprintf(buf, sizeof(buf), "array[%d] of %s", length, elem->name);
+    else snprintf(buf, sizeof(buf), "array[] of %s", elem->name);
+
+    t->kind = TYPE_ARRAY;
+    t->name = strdup(buf);
+    t->elem = elem;
+    t->length = length;
+    t->dimensions = (elem->kind == TYPE_ARRAY) ? elem->dimensions + 1 : 1;
+    /* статический массив хранится inline, динамический - ссылкой */
+    t->size = (length > 0) ? elem->size * length : 4;
+    t->align = (length > 0) ? elem->align : 4;
+    t->hash = h;
+    return type_table_insert(tt, t);
+}
+
+/* Сигнатура функции; вызывается под tt->lock */
+static const Type* type_function_locked(TypeTable* tt, const Type* ret, int param_count, const Type* const* params) {
+    unsigned h = type_hash_mix(type_hash_ptr(2166136261u, ret), (unsigned)param_count);
+    for (int i = 0; i < param_count; i++) h = type_hash_ptr(h, params[i]);
+    h = type_hash_mix(h, TYPE_FUNCTION);
+    for (Type* t = tt->buckets[h & (unsigned)(tt->bucket_count - 1)]; t; t = t->next) {
+        if (t->hash != h || t->kind != TYPE_FUNCTION || t->ret != ret || t->param_count != param_count) continue;
+        int same = 1;
+        for (int i = 0; i < param_count && same; i++) same = (t->params[i] == params[i]);
+        if (same) return t;
+    }
+
+    Type* t = (Type*)calloc(1, sizeof(Type));
+    if (!t) return &type_builtins[TYPE_UNKNOWN];
+    if (param_count > 0) {
+        t->params = (const Type**)malloc((size_t)param_count * sizeof(Type*));
+        if (!t->params) {
+            free(t);
+            return &type_builtins[TYPE_UNKNOWN];
+        }
+        memcpy(t->params, params, (size_t)param_count * sizeof(Type*));
+    }
+
+    /* "function(int, char): int" */
+    size_t len = strlen("function(): ") + strlen(ret->name) + 1;
+    for (int i = 0; i < param_count; i++) len += strlen(type_name_of(params[i])) + 2;
+    char* name = (char*)malloc(len);
+    if (name) {
+        strcpy(name, "function(");
+        for (int i = 0; i < param_count; i++) {
+            if (i > 0) strcat(name, ", ");
+            strcat(name, type_name_of(params[i]));
+        }
+        strcat(name, "): ");
+        strcat(name, ret->name);
+    }
+
+    t->kind = TYPE_FUNCTION;
+    t->name = name ? name : strdup("function");
+    t->ret = ret;
+    t->param_count = param_count;
+    t->size = 0;                    /* функция не занимает места в кадре */
+    t->align = 4;
+    t->hash = h;
+    return type_table_insert(tt, t);
+}
+
+/* =========================
+ * Интерфейс (поиск со вставкой под tt->lock)
+ * ========================= */
+
+const Type* type_by_name(TypeTable* tt, const char* name) {
+    if (!name) return &type_builtins[TYPE_UNKNOWN];
+    for (int i = 0; i < TYPE_BUILTIN_COUNT; i++) {
+        if (strcmp(type_builtins[i].name, name) == 0) return &type_builtins[i];
+    }
+    if (!tt) return &type_builtins[TYPE_UNKNOWN];
+
+    mutex_lock(&tt->lock);
+    const Type* t = type_named_locked(tt, name);
+    mutex_unlock(&tt->lock);
+    return t;
+}
+
+const Type* type_array(TypeTable* tt, const Type* elem, int length) {
+    if (!elem) elem = &type_builtins[TYPE_UNKNOWN];
+    if (length < 0) length = 0;
+    if (!tt) return elem;
+
+    mutex_lock(&tt->lock);
+    const Type* t = type_array_locked(tt, elem, length);
+    mutex_unlock(&tt->lock);
+    return t;
+}
+
+const Type* type_function(TypeTable* tt, const Type* ret, int param_count, const Type* const* params) {
+    if (!ret) ret = &type_builtins[TYPE_VOID];
+    if (param_count < 0 || !params) param_count = 0;
+    if (!tt) return &type_builtins[TYPE_UNKNOWN];
+
+    mutex_lock(&tt->lock);
+    const Type* t = type_function_locked(tt, ret, param_count, params);
+    mutex_unlock(&tt->lock);
+    return t;
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+#ifndef TYPES_H
+#define TYPES_H
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * Дескрипторы типов данных.
+     *
+     * Каждый тип существует в одном экземпляре (hash-consing), поэтому
+     * равенство типов - равенство указателей, а размер и выравнивание
+     * посчитаны заранее и читаются из дескриптора.
+     *
+     * Встроенные скаляры - статические константы, общие для всех таблиц.
+     * Составные типы (array of T, сигнатуры функций) и неизвестные имена
+     * интернируются в TypeTable; таблица принадлежит таблице символов и
+     * живёт вместе с ней. Тела функций анализируются параллельно
+     * (semantic.c), поэтому поиск со вставкой идёт под мьютексом таблицы;
+     * встроенные скаляры - без блокировки.
+     *
+     * Размеры согласованы с бэкендом: машинное слово - 4 байта, long/ulong
+     * - 8, din - 8 (значение + тег времени выполнения), char - слово.
+     */
+
+    typedef enum {
+        TYPE_UNKNOWN,       /* тип не указан */
+        TYPE_VOID,
+        TYPE_BOOL,
+        TYPE_BYTE,
+        TYPE_INT,
+        TYPE_UINT,
+        TYPE_LONG,
+        TYPE_ULONG,
+        TYPE_FLOAT,         /* Q16.16 */
+        TYPE_DIN,
+        TYPE_CHAR,
+        TYPE_STRING,
+        TYPE_NAMED,         /* имя без встроенного смысла */
+        TYPE_ARRAY,
+        TYPE_FUNCTION
+    } TypeKind;
+
+    typedef struct Type {
+        TypeKind kind;
+        const char* name;           /* "int", "array[10] of int", "function(int): int" */
+        int size;                   /* байт в кадре/данных */
+        int align;
+        int is_integer;             /* целое в одном регистре: int/uint/byte/char/bool */
+
+        /* TYPE_ARRAY */
+        const struct Type* elem;
+        int length;                 /* 0 - динамический (хранится ссылка) */
+        int dimensions;
+
+        /* TYPE_FUNCTION */
+        const struct Type* ret;
+        int param_count;
+        const struct Type** params;
+
+        /* цепочка корзины TypeTable */
+        unsigned hash;
+        struct Type* next;
+    } Type;
+
+    typedef struct TypeTable {
+        Type** buckets;
+        int bucket_count;
+        int count;
+        Mutex lock;
+    } TypeTable;
+
+    TypeTable* type_table_create(void);
+    void type_table_free(TypeTable* tt);
+
+    /* Встроенный скаляр (TYPE_UNKNOWN .. TYPE_STRING) */
+    const Type* type_builtin(TypeKind kind);
+
+    /* Тип по имени из исходника; NULL - TYPE_UNKNOWN */
+    const Type* type_by_name(TypeTable* tt, const char* name);
+
+    /* array[length] of elem; length 0 - динамический */
+    const Type* type_array(TypeTable* tt, const Type* elem, int length);
+
+    const Type* type_function(TypeTable* tt, const Type* ret, int param_count, const Type* const* params);
+
+    /* Тип элемента массива, иначе сам тип */
+    const Type* type_element(const Type* t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif